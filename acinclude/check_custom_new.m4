@@ -9,7 +9,10 @@ AC_ARG_ENABLE([custom-new],
 )
 
 if test "X$with_custom_new" = "Xyes"; then
-  AC_DEFINE_UNQUOTED([CUSTOM_NEW], 1, [Track communcation synchronization stats])
+  AC_DEFINE_UNQUOTED([CUSTOM_NEW], 1, [Use pooled allocation for frequently created classes])
+  AM_CONDITIONAL(USE_CUSTOM_NEW, true)
+else
+  AM_CONDITIONAL(USE_CUSTOM_NEW, false)
 fi
 
 ])
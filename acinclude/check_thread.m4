@@ -8,8 +8,10 @@ AC_ARG_ENABLE([multithread],
 if test "X$with_multithread" = "Xyes"; then
  AC_DEFINE_UNQUOTED([USE_MULTITHREAD], 1, "Whether to enable multithreading")
  AC_SUBST([mt_cmdline_args],["-p sst_nthread=2 -c '0 2'"])
+ AM_CONDITIONAL(USE_MULTITHREAD, true)
 else
  AC_SUBST([mt_cmdline_args],[""])
+ AM_CONDITIONAL(USE_MULTITHREAD, false)
 fi
 
 AC_ARG_ENABLE([spinlock],
@@ -0,0 +1,101 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+/**
+ * Round trips through OperatingSystem::block/unblock: each rank repeatedly
+ * nanosleeps for block_delay, which schedules an unblock event, parks the
+ * thread, and resumes it once the event queue delivers the event.
+ *   sstmac -f block.ini --exe=./run
+ * Host time per round trip, aggregated over all ranks, is printed by rank 0.
+ */
+#include <mpi.h>
+#include <sstmac/skeleton.h>
+#include <sstmac/software/process/time.h>
+#include <sprockit/keyword_registration.h>
+#include <cstdio>
+#include <ctime>
+#include <string>
+
+RegisterKeywords(
+{ "block_niter", "the number of block/unblock round trips each rank makes" },
+{ "block_delay", "the simulated time each rank stays blocked per round trip" },
+);
+
+#define sstmac_app_name context_switch_block
+int USER_MAIN(int argc, char** argv)
+{
+  MPI_Init(&argc, &argv);
+  int rank, nranks;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  long niter = sstmac::appHasParam("block_niter")
+      ? std::stol(sstmac::getAppParam("block_niter")) : 100000;
+  double delay;
+  sstmac::getAppUnitParam("block_delay", "1ns", delay);
+  timespec req;
+  req.tv_sec = 0;
+  req.tv_nsec = long(delay * 1e9 + 0.5);
+
+  MPI_Barrier(MPI_COMM_WORLD);
+  double start = sstmacWallTime();
+  for (long i=0; i < niter; ++i){
+    nanosleep(&req, nullptr);
+  }
+  double stop = sstmacWallTime();
+
+  //ranks interleave on one host thread, so span the earliest start to the latest stop
+  double first_start, last_stop;
+  MPI_Reduce(&start, &first_start, 1, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD);
+  MPI_Reduce(&stop, &last_stop, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+  if (rank == 0){
+    double elapsed = last_stop - first_start;
+    long nroundtrip = niter * nranks;
+    printf("bench=block ranks=%d roundtrips=%ld seconds=%.6f ns_per_roundtrip=%.2f\n",
+           nranks, nroundtrip, elapsed, elapsed * 1e9 / nroundtrip);
+  }
+
+  MPI_Finalize();
+  return 0;
+}
@@ -41,77 +41,192 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 Questions? Contact sst-macro-help@sandia.gov
 */
+
+/**
+ * Context switch benchmarks over every ThreadContext backend built into sstmac.
+ *   sstmac --benchmark context_switch -f parameters.ini
+ * measures, for each backend in contexts,
+ *   switch: the cost of one switch between the main context and a live
+ *           context, for each count of live contexts in nthread, visited in
+ *           sequential and shuffled order to expose cache and TLB effects
+ *   spawn:  the cost of taking a stack from StackAlloc, starting a context
+ *           on it, completing it, and returning the stack
+ * Block/unblock round trips through the event queue need a full simulation:
+ *   sstmac -f block.ini --exe=./run
+ * Results are printed one per line as key=value pairs.
+ */
+//sst++ redirects free to the simulated allocator, which would rename StackAlloc::free
+#undef free
 #include <sstmac/main/sstmac.h>
-#include <vector>
 #include <sstmac/software/threading/threading_interface.h>
-#include <sprockit/sim_parameters.h>
 #include <sstmac/software/threading/stack_alloc.h>
+#include <sprockit/sim_parameters.h>
 #include <sprockit/keyword_registration.h>
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+//benchmarks run outside any simulated app, so print to the real stdout
+#undef printf
 
 RegisterKeywords(
-{ "context", "the name of the context switch library to profile" },
-{ "nthread", "the number of distinct threads to context switch amongst" },
-{ "niter", "the number of context switch iterations to run" },
+{ "contexts", "the context switch libraries to profile - all that are built by default" },
+{ "nthread", "the numbers of distinct live contexts to context switch amongst" },
+{ "niter", "the number of context switches to time for each number of live contexts" },
+{ "nspawn", "the number of contexts to spawn and destroy" },
 );
 
-struct subthread_args {
-  sstmac::sw::ThreadContext* subthread;
-  sstmac::sw::ThreadContext* main_thread;
+using sstmac::sw::ThreadContext;
+using sstmac::sw::StackAlloc;
+
+struct SubthreadArgs {
+  ThreadContext* subthread;
+  ThreadContext* main_thread;
+  void* stack;
+  bool stop;
 };
 
-class context_switch_benchmark : public sstmac::Benchmark
+static void runSubthread(void* args){
+  SubthreadArgs* sargs = (SubthreadArgs*) args;
+  while (!sargs->stop){
+    sargs->subthread->pauseContext(sargs->main_thread);
+  }
+  sargs->subthread->completeContext(sargs->main_thread);
+}
+
+class ContextSwitchBenchmark : public sstmac::Benchmark
 {
  public:
-  FactoryRegister("context_switch", sstmac::benchmark, context_switch_benchmark);
-
-  context_switch_benchmark(SST::Params& params){
-    main_thread_ = sstmac::sw::ThreadContext::factory
-                    ::get_param("context", params);
-    nthread_ = params.find<int>("nthread");
-    niter_ = params.find<int>("niter");
-    sstmac::sw::StackAlloc::init(params);
+  SST_ELI_REGISTER_DERIVED(
+    sstmac::Benchmark,
+    ContextSwitchBenchmark,
+    "macro",
+    "context_switch",
+    SST_ELI_ELEMENT_VERSION(1,0,0),
+    "measures context switch and spawn costs for each thread context backend")
+
+  ContextSwitchBenchmark(SST::Params& params){
+    if (params.contains("contexts")){
+      params.find_array("contexts", contexts_);
+    } else {
+      for (auto& pair : ThreadContext::getBuilderLibrary("macro")->getMap()){
+        contexts_.push_back(pair.first);
+      }
+    }
+    if (params.contains("nthread")){
+      params.find_array("nthread", nthreads_);
+    } else {
+      nthreads_ = {1, 16, 256, 4096};
+    }
+    niter_ = params.find<long>("niter", 1000000);
+    nspawn_ = params.find<long>("nspawn", 10000);
+    StackAlloc::init(params);
   }
 
   void run() override;
 
  private:
-  std::vector<subthread_args> subthreads_;
-  sstmac::sw::ThreadContext* main_thread_;
-  int nthread_;
-  int niter_;
+  void start(ThreadContext* main_thread, SubthreadArgs& args);
+
+  void finish(SubthreadArgs& args);
+
+  void runSwitch(const std::string& name, ThreadContext* main_thread, int nthread);
+
+  void runSpawn(const std::string& name, ThreadContext* main_thread);
+
+  std::vector<std::string> contexts_;
+  std::vector<int> nthreads_;
+  long niter_;
+  long nspawn_;
 };
 
-static void run_subthread(void* args){
-  subthread_args* sargs = (subthread_args*) args;
-  auto subthread = sargs->subthread;
-  auto main_thread = sargs->main_thread;
-  while (1){
-    subthread->pauseContext(main_thread);
-  }
+void
+ContextSwitchBenchmark::start(ThreadContext* main_thread, SubthreadArgs& args)
+{
+  args.subthread = main_thread->copy();
+  args.main_thread = main_thread;
+  args.stack = StackAlloc::alloc();
+  args.stop = false;
+  args.subthread->startContext(args.stack, StackAlloc::stacksize(),
+                               runSubthread, &args, main_thread);
 }
 
-void context_switch_benchmark::run()
+void
+ContextSwitchBenchmark::finish(SubthreadArgs& args)
 {
-  main_thread_->initContext();
-  subthreads_.resize(nthread_);
-  for (int i=0; i < nthread_; ++i){
-    auto& args = subthreads_[i];
-    auto thr = main_thread_->copy();
-    args.subthread = thr;
-    args.main_thread = main_thread_;
-    thr->startContext(0, sstmac::sw::StackAlloc::alloc(),
-             sstmac::sw::StackAlloc::stacksize(),
-             run_subthread, &args, nullptr, nullptr, main_thread_);
+  args.stop = true;
+  args.subthread->resumeContext(args.main_thread);
+  args.subthread->destroyContext();
+  delete args.subthread;
+  StackAlloc::free(args.stack);
+}
+
+void
+ContextSwitchBenchmark::runSwitch(const std::string& name, ThreadContext* main_thread, int nthread)
+{
+  std::vector<SubthreadArgs> subthreads(nthread);
+  for (auto& args : subthreads){
+    start(main_thread, args);
   }
 
-  double start = now();
-  for (int i=0; i < niter_; ++i){
-    for (int j=0; j < nthread_; ++j){
-      sstmac::sw::ThreadContext* subthread = subthreads_[j].subthread;
-      subthread->resumeContext(main_thread_);
+  long nrounds = std::max(1L, niter_ / nthread);
+  std::vector<int> order(nthread);
+  for (int i=0; i < nthread; ++i) order[i] = i;
+
+  for (int shuffled=0; shuffled < 2; ++shuffled){
+    if (shuffled){
+      std::mt19937 gen(42);
+      std::shuffle(order.begin(), order.end(), gen);
     }
+    //one untimed round to fault in every stack
+    for (int idx : order){
+      subthreads[idx].subthread->resumeContext(main_thread);
+    }
+    double start_time = now();
+    for (long i=0; i < nrounds; ++i){
+      for (int idx : order){
+        subthreads[idx].subthread->resumeContext(main_thread);
+      }
+    }
+    double elapsed = now() - start_time;
+    //every resume is a switch in and a switch back out
+    long nswitch = 2 * nrounds * nthread;
+    printf("bench=switch context=%s nthread=%d order=%s switches=%ld seconds=%.6f ns_per_switch=%.2f\n",
+           name.c_str(), nthread, shuffled ? "shuffled" : "sequential",
+           nswitch, elapsed, elapsed * 1e9 / nswitch);
+  }
+
+  for (auto& args : subthreads){
+    finish(args);
   }
-  double stop = now();
-  printf("Benchmark ran for %12.8fs\n", stop - start);
 }
 
+void
+ContextSwitchBenchmark::runSpawn(const std::string& name, ThreadContext* main_thread)
+{
+  SubthreadArgs args;
+  double start_time = now();
+  for (long i=0; i < nspawn_; ++i){
+    start(main_thread, args);
+    finish(args);
+  }
+  double elapsed = now() - start_time;
+  printf("bench=spawn context=%s nspawn=%ld stack_size=%zu seconds=%.6f us_per_spawn=%.3f\n",
+         name.c_str(), nspawn_, StackAlloc::stacksize(), elapsed, elapsed * 1e6 / nspawn_);
+}
+
+void
+ContextSwitchBenchmark::run()
+{
+  for (auto& name : contexts_){
+    ThreadContext* main_thread = sprockit::create<ThreadContext>("macro", name);
+    main_thread->initContext();
+    for (int nthread : nthreads_){
+      runSwitch(name, main_thread, nthread);
+    }
+    runSpawn(name, main_thread);
+    main_thread->destroyContext();
+    delete main_thread;
+  }
+}
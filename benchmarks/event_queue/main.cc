@@ -0,0 +1,244 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+/**
+ * Replays event queue schedule/pop traces against the red-black tree and the ladder queue.
+ * Traces are recorded from a simulation with
+ *   event_manager.queue_trace = <prefix>
+ * which writes one binary file per event manager (<prefix>.<rank>.<thread>).
+ *
+ * Usage:
+ *   ./run <trace file> [<trace file> ...]
+ *   ./run --hold <queue size> <num holds> <mean increment ticks>
+ * With --hold, a synthetic classic hold-model trace is generated instead.
+ * Results are printed one per line as key=value pairs.
+ */
+#include <sstmac/common/ladder_queue.h>
+#include <set>
+#include <vector>
+#include <random>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/time.h>
+
+/** Must match the layout of sstmac::EventQueueTraceRecord */
+struct TraceRecord {
+  uint32_t op;
+  uint32_t linkId;
+  uint32_t seqnum;
+  uint32_t padding;
+  uint64_t ticks;
+};
+
+struct TraceEvent {
+  uint64_t ticks;
+  uint32_t linkId;
+  uint32_t seqnum;
+};
+
+struct TraceCompare {
+  bool operator()(const TraceEvent* lhs, const TraceEvent* rhs) const {
+    if (lhs->ticks != rhs->ticks) return lhs->ticks < rhs->ticks;
+    if (lhs->linkId == rhs->linkId){
+      return lhs->seqnum < rhs->seqnum;
+    } else {
+      return lhs->linkId < rhs->linkId;
+    }
+  }
+
+  static uint64_t ticks(const TraceEvent* ev){
+    return ev->ticks;
+  }
+};
+
+static double now()
+{
+  timeval t_st;
+  gettimeofday(&t_st, 0);
+  return t_st.tv_sec + 1e-6 * t_st.tv_usec;
+}
+
+struct SetQueue {
+  std::set<const TraceEvent*, TraceCompare> q;
+  void push(const TraceEvent* ev){ q.insert(ev); }
+  const TraceEvent* pop(){
+    auto it = q.begin();
+    const TraceEvent* ev = *it;
+    q.erase(it);
+    return ev;
+  }
+};
+
+struct LadderQueue {
+  sstmac::LadderQueue<const TraceEvent*, TraceCompare> q;
+  void push(const TraceEvent* ev){ q.push(ev); }
+  const TraceEvent* pop(){
+    const TraceEvent* ev = q.top();
+    q.pop();
+    return ev;
+  }
+};
+
+/**
+ * @return A checksum over the pop order so that both queues can be verified identical
+ */
+template <class Queue>
+static uint64_t replay(const std::vector<TraceRecord>& trace,
+                       const std::vector<TraceEvent>& events,
+                       double& elapsed)
+{
+  Queue queue;
+  uint64_t checksum = 0;
+  size_t next_event = 0;
+  double start = now();
+  for (const TraceRecord& rec : trace){
+    if (rec.op == 0){
+      queue.push(&events[next_event++]);
+    } else {
+      const TraceEvent* ev = queue.pop();
+      checksum = checksum * 1099511628211ULL + (ev - events.data());
+    }
+  }
+  elapsed = now() - start;
+  return checksum;
+}
+
+static void makeHoldTrace(std::vector<TraceRecord>& trace, int size, int nholds, double mean)
+{
+  std::mt19937_64 gen(42);
+  std::exponential_distribution<double> incr(1.0/mean);
+  std::vector<uint64_t> pending;
+  std::multiset<uint64_t> times;
+  uint32_t seqnum = 0;
+  auto push = [&](uint64_t t){
+    TraceRecord rec;
+    rec.op = 0;
+    rec.linkId = gen() % 64;
+    rec.seqnum = seqnum++;
+    rec.padding = 0;
+    rec.ticks = t;
+    trace.push_back(rec);
+    times.insert(t);
+  };
+  for (int i=0; i < size; ++i){
+    push(uint64_t(incr(gen)));
+  }
+  for (int i=0; i < nholds; ++i){
+    uint64_t t = *times.begin();
+    times.erase(times.begin());
+    TraceRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.op = 1;
+    trace.push_back(rec);
+    push(t + uint64_t(incr(gen)));
+  }
+}
+
+static bool readTrace(const char* fname, std::vector<TraceRecord>& trace)
+{
+  FILE* f = fopen(fname, "rb");
+  if (!f) return false;
+  TraceRecord rec;
+  while (fread(&rec, sizeof(rec), 1, f) == 1){
+    trace.push_back(rec);
+  }
+  fclose(f);
+  return true;
+}
+
+static int runTrace(const std::string& name, const std::vector<TraceRecord>& trace)
+{
+  std::vector<TraceEvent> events;
+  uint64_t npops = 0;
+  for (const TraceRecord& rec : trace){
+    if (rec.op == 0){
+      TraceEvent ev;
+      ev.ticks = rec.ticks;
+      ev.linkId = rec.linkId;
+      ev.seqnum = rec.seqnum;
+      events.push_back(ev);
+    } else {
+      ++npops;
+    }
+  }
+
+  double set_time, ladder_time;
+  uint64_t set_sum = replay<SetQueue>(trace, events, set_time);
+  uint64_t ladder_sum = replay<LadderQueue>(trace, events, ladder_time);
+  bool match = set_sum == ladder_sum;
+  printf("trace=%s pushes=%zu pops=%llu set_s=%.6f ladder_s=%.6f speedup=%.3f identical=%s\n",
+         name.c_str(), events.size(), (unsigned long long) npops,
+         set_time, ladder_time, set_time / ladder_time, match ? "yes" : "no");
+  return match ? 0 : 1;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 2){
+    fprintf(stderr, "usage: %s <trace file>... | --hold <size> <nholds> <mean ticks>\n", argv[0]);
+    return 1;
+  }
+
+  if (strcmp(argv[1], "--hold") == 0){
+    if (argc != 5){
+      fprintf(stderr, "usage: %s --hold <size> <nholds> <mean ticks>\n", argv[0]);
+      return 1;
+    }
+    std::vector<TraceRecord> trace;
+    makeHoldTrace(trace, atoi(argv[2]), atoi(argv[3]), atof(argv[4]));
+    return runTrace("hold", trace);
+  }
+
+  int rc = 0;
+  for (int i=1; i < argc; ++i){
+    std::vector<TraceRecord> trace;
+    if (!readTrace(argv[i], trace)){
+      fprintf(stderr, "could not open trace file %s\n", argv[i]);
+      return 1;
+    }
+    rc |= runTrace(argv[i], trace);
+  }
+  return rc;
+}
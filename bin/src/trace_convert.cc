@@ -0,0 +1,101 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#include <sstmac/skeletons/compact_replay/dumpi_to_compact.h>
+#include <iostream>
+#include <cstdlib>
+#include <unistd.h>
+
+static void
+usage(const char* exe)
+{
+  std::cerr << "usage: " << exe << " [-q] [-n] [-b body] [-g nsec] <dumpi meta file> <compact trace>\n"
+            << "Convert a DUMPI trace into the compact binary format\n"
+            << "replayed by the compact_replay application\n"
+            << "  -q        do not report progress for each rank\n"
+            << "  -n        do not compress repeated call sequences into loops\n"
+            << "  -b body   the longest loop body in calls to search for (default 256)\n"
+            << "  -g nsec   fold compute gaps shorter than nsec into the next gap\n";
+}
+
+int
+main(int argc, char **argv)
+{
+  bool print_progress = true;
+  sumi::CompactTraceOptions opts;
+  int ch;
+  while ((ch = ::getopt(argc, argv, "qnb:g:")) != -1){
+    switch(ch){
+    case 'q':
+      print_progress = false;
+      break;
+    case 'n':
+      opts.max_loop_body = 0;
+      break;
+    case 'b':
+      opts.max_loop_body = ::atoi(optarg);
+      break;
+    case 'g':
+      opts.min_gap_nsec = ::strtoull(optarg, nullptr, 10);
+      break;
+    default:
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if (argc - optind != 2){
+    usage(argv[0]);
+    return 1;
+  }
+
+  try {
+    sumi::convertDumpiToCompact(argv[optind], argv[optind+1], print_progress, opts);
+  }
+  catch (const std::exception &e) {
+    std::cerr << argv[0] << ": caught exception while converting trace:\n"
+              << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+__license__ = """
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+"""
+
+
+'''
+ Converts a JSON routing table for a file topology into the compact binary
+ format that can be memory-mapped by the table router.
+
+ usage: routing_table_convert.py <topology.json> <routing_tables.json> <output>
+
+ The output can be used directly as the topology.routing_tables parameter.
+ Node and switch ids follow the same (sorted name) ordering as the file topology,
+ so the layout here must be kept consistent with
+ sstmac/hardware/topology/routing_table.cc
+'''
+
+import json
+import struct
+import sys
+
+MAGIC = b"SSTMRTB1"
+PER_NODE = 0xFFFF
+NO_ROUTE = 0xFFFE
+
+def u32(values):
+  return struct.pack("=%dI" % len(values), *values)
+
+def u16(values):
+  return struct.pack("=%dH" % len(values), *values)
+
+def convert(topology, tables):
+  switches = topology["switches"]
+  node_names = sorted(topology["nodes"].keys())
+  switch_names = sorted(switches.keys())
+  node_ids = dict((name, i) for i, name in enumerate(node_names))
+  num_nodes = len(node_names)
+  num_switches = len(switch_names)
+
+  node_switch = [0] * num_nodes
+  switch_nodes = [[] for s in range(num_switches)]
+  for sid, name in enumerate(switch_names):
+    for port in switches[name]["outports"].values():
+      dst = port["destination"]
+      if dst in node_ids:
+        node_switch[node_ids[dst]] = sid
+  for nid in range(num_nodes):
+    switch_nodes[node_switch[nid]].append(nid)
+
+  channel_ids = {}
+  channel_offsets = [0]
+  ports = []
+  local_offsets = [0]
+  local_channels = []
+  exception_offsets = [0]
+  exceptions = []
+  routes = []
+
+  for sid, name in enumerate(switch_names):
+    port_channels = switches[name].get("port_channels", {})
+    sw_routes = tables["switches"][name]["routes"]
+    node_local = [-1] * num_nodes
+    local_ids = {}
+    for node_name in sorted(sw_routes.keys()):
+      value = sw_routes[node_name]
+      if isinstance(value, int):
+        pch = (value,)
+      else:
+        pch = tuple(port_channels[value]["ports"])
+
+      if pch not in channel_ids:
+        channel_ids[pch] = len(channel_ids)
+        ports.extend(pch)
+        channel_offsets.append(len(ports))
+      channel = channel_ids[pch]
+
+      if channel not in local_ids:
+        if len(local_ids) >= NO_ROUTE:
+          sys.exit("switch %s uses too many distinct port channels" % name)
+        local_ids[channel] = len(local_ids)
+        local_channels.append(channel)
+      node_local[node_ids[node_name]] = local_ids[channel]
+    local_offsets.append(len(local_channels))
+
+    for nid in range(num_nodes):
+      if node_local[nid] < 0:
+        sys.exit("No port specified on switch %s to destination %s" % (name, node_names[nid]))
+
+    row = []
+    for dst in range(num_switches):
+      nodes = switch_nodes[dst]
+      if not nodes:
+        row.append(NO_ROUTE)
+      elif all(node_local[nid] == node_local[nodes[0]] for nid in nodes):
+        row.append(node_local[nodes[0]])
+      else:
+        row.append(PER_NODE)
+
+    for nid in range(num_nodes):
+      if row[node_switch[nid]] == PER_NODE:
+        exceptions.extend((nid, node_local[nid]))
+    exception_offsets.append(len(exceptions) // 2)
+    routes.extend(row)
+
+  header = MAGIC + u32([num_switches, num_nodes, len(channel_ids), len(ports),
+                        len(local_channels), len(exceptions) // 2])
+  return b"".join([header, u32(node_switch), u32(channel_offsets), u32(ports),
+                   u32(local_offsets), u32(local_channels), u32(exception_offsets),
+                   u32(exceptions), u16(routes)])
+
+if __name__ == "__main__":
+  if len(sys.argv) != 4:
+    sys.exit("usage: %s <topology.json> <routing_tables.json> <output>" % sys.argv[0])
+  topology = json.load(open(sys.argv[1]))
+  tables = json.load(open(sys.argv[2]))
+  data = convert(topology, tables)
+  open(sys.argv[3], "wb").write(data)
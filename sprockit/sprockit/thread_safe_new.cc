@@ -0,0 +1,116 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#include <sprockit/thread_safe_new.h>
+#include <sprockit/spkt_printf.h>
+#include <cxxabi.h>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+
+namespace sprockit {
+
+static std::vector<ThreadAllocatorSet*>&
+allocatorRegistry()
+{
+  //pools are registered during static init, so no locking is needed
+  static std::vector<ThreadAllocatorSet*> registry;
+  return registry;
+}
+
+ThreadAllocatorSet::ThreadAllocatorSet(const std::type_info& info, size_t size) :
+  name(info.name()),
+  unitSize(size)
+{
+  ::memset(counters, 0, sizeof(counters));
+  allocatorRegistry().push_back(this);
+}
+
+ThreadAllocatorSet::~ThreadAllocatorSet()
+{
+  for (int i=0; i < MAX_NUM_NEW_SAFE_THREADS; ++i){
+    auto& vec = allocations[i];
+    for (char* ptr : vec){
+      delete[] ptr;
+    }
+  }
+  auto& registry = allocatorRegistry();
+  auto iter = std::find(registry.begin(), registry.end(), this);
+  if (iter != registry.end()) registry.erase(iter);
+}
+
+void
+ThreadAllocatorSet::printStats(std::ostream& os)
+{
+  uint64_t total_slabs = 0;
+  uint64_t total_bytes = 0;
+  for (ThreadAllocatorSet* set : allocatorRegistry()){
+    uint64_t allocs = 0, frees = 0, peak = 0, bytes = 0, slabs = 0;
+    for (int i=0; i < MAX_NUM_NEW_SAFE_THREADS; ++i){
+      allocs += set->counters[i].allocs;
+      frees += set->counters[i].frees;
+      peak += set->counters[i].peak;
+      bytes += set->counters[i].bytes;
+      slabs += set->allocations[i].size();
+    }
+    if (allocs == 0) continue;
+
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(set->name, nullptr, nullptr, &status);
+    std::string name = status == 0 ? demangled : set->name;
+    ::free(demangled);
+
+    os << sprockit::sprintf("Pool %-40s %3zu bytes: %12llu allocs %10llu live %6llu slabs %10llu high-water\n",
+                            name.c_str(), set->unitSize,
+                            (unsigned long long) allocs, (unsigned long long) (allocs - frees),
+                            (unsigned long long) slabs, (unsigned long long) peak);
+    total_slabs += slabs;
+    total_bytes += bytes;
+  }
+  os << sprockit::sprintf("Pools hold %llu slabs totaling %llu bytes\n",
+                          (unsigned long long) total_slabs, (unsigned long long) total_bytes);
+}
+
+}
@@ -46,7 +46,12 @@ Questions? Contact sst-macro-help@sandia.gov
 
 #include <vector>
 #include <set>
+#include <limits>
+#include <iosfwd>
+#include <typeinfo>
+#include <cstdint>
 #include <sstmac/common/sstmac_config.h>
+#include <sprockit/errors.h>
 
 #define SPKT_TLS_OFFSET 64
 
@@ -76,16 +81,36 @@ static int inline currentThreadId() {
 
 struct ThreadAllocatorSet {
 #define MAX_NUM_NEW_SAFE_THREADS 128
+  /** Per-thread counters, padded so threads do not share cache lines */
+  struct alignas(64) Counters {
+    uint64_t allocs;
+    uint64_t frees;
+    /** Objects allocated minus objects freed on this thread */
+    int64_t live;
+    /** The most objects this thread has had live at once */
+    int64_t peak;
+    uint64_t bytes;
+  };
+
   std::vector<char*> allocations[MAX_NUM_NEW_SAFE_THREADS];
   std::vector<void*> available[MAX_NUM_NEW_SAFE_THREADS];
-  ~ThreadAllocatorSet(){
-    for (int i=0; i < MAX_NUM_NEW_SAFE_THREADS; ++i){
-      auto& vec = allocations[i];
-      for (char* ptr : vec){
-        delete[] ptr;
-      }
-    }
-  }
+  Counters counters[MAX_NUM_NEW_SAFE_THREADS];
+  const char* name;
+  size_t unitSize;
+
+  ThreadAllocatorSet(const std::type_info& info, size_t size);
+
+  ~ThreadAllocatorSet();
+
+  /**
+   * @brief printStats Print live objects, slab count, and high-water mark
+   *        for every class that has allocated through a thread_safe_new pool.
+   *        Objects freed on a different thread than they were allocated on
+   *        are counted correctly in the live total since only the totals are reported.
+   *        The high-water mark sums the peaks of each thread, which is exact for
+   *        one thread and otherwise an upper bound on the peak of live objects.
+   */
+  static void printStats(std::ostream& os);
 };
 
 template <class T>
@@ -112,8 +137,12 @@ class thread_safe_new {
       grow(thread);
     }
     void* ret = alloc_.available[thread].back();
+    ThreadAllocatorSet::Counters& counters = alloc_.counters[thread];
+    counters.allocs++;
+    counters.live++;
+    if (counters.live > counters.peak) counters.peak = counters.live;
 #if SSTMAC_ENABLE_SANITY_CHECK
-    (uint32_t*) casted = (uint32_t*) ret;
+    uint32_t* casted = (uint32_t*) ret;
     *casted = 0;
 #endif
     alloc_.available[thread].pop_back();
@@ -139,8 +168,10 @@ class thread_safe_new {
   static void operator delete(void* ptr){
     int thread = currentThreadId();
     alloc_.available[thread].push_back(ptr);
+    alloc_.counters[thread].frees++;
+    alloc_.counters[thread].live--;
 #if SSTMAC_ENABLE_SANITY_CHECK
-    (uint32_t*) casted = (uint32_t*) ptr;
+    uint32_t* casted = (uint32_t*) ptr;
     if (*casted == magic_number){
       spkt_abort_printf("chunk %p already freed!", ptr);
     }
@@ -178,6 +209,7 @@ class thread_safe_new {
 #endif
     }
     alloc_.allocations[thread].push_back(newTs);
+    alloc_.counters[thread].bytes += unitSize*increment;
   }
 
  private:
@@ -201,7 +233,7 @@ class thread_safe_new {
 };
 
 #if SSTMAC_CUSTOM_NEW
-template <class T> ThreadAllocatorSet thread_safe_new<T>::alloc_;
+template <class T> ThreadAllocatorSet thread_safe_new<T>::alloc_(typeid(T), sizeof(T));
 
 #if SPKT_NEW_SUPER_DEBUG
 template <class T> std::set<void*> thread_safe_new<T>::all_chunks_;
@@ -64,6 +64,8 @@ RegisterKeywords(
 { "serialization_buffer_size", "the size of the default serialization buffer for pairwise sends" },
 { "backup_buffer_size", "the size of the backup buffer in case main buffer overflows" },
 { "partition", "the partitioning algorithm for assigning work to logical processes" },
+{ "partition_file", "the switch assignment file read by partition = file" },
+{ "partition_imbalance", "the fractional switch imbalance allowed by partition = graph" },
 { "runtime", "the underlying runtime (usually MPI or serial) managing logical processes" },
 { "sst_nthread", "the number of threads to use" },
 { "sst_nproc", "the number of parallel procs (ranks) to use" }
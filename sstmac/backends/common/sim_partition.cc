@@ -51,8 +51,13 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sprockit/util.h>
 #include <sprockit/basic_string_tokenizer.h>
 #include <sprockit/errors.h>
+#include <sprockit/sim_parameters.h>
 
 #include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <queue>
+#include <cmath>
 
 RegisterDebugSlot(partition);
 
@@ -123,6 +128,353 @@ TopologyPartition::TopologyPartition(SST::Params& params, ParallelRuntime* rt)
                               me_, nproc_, nthread_, noccupied_);
 }
 
+FilePartition::~FilePartition()
+{
+  delete[] switch_to_thread_;
+  delete[] switch_to_lpid_;
+}
+
+FilePartition::FilePartition(SST::Params& params, ParallelRuntime* rt)
+  : Partition(params, rt)
+{
+  auto fname = params.find<std::string>("partition_file");
+  std::ifstream in(fname);
+  if (!in.good()){
+    spkt_throw_printf(sprockit::InputError,
+      "could not open partition_file %s", fname.c_str());
+  }
+
+  int nproc, nthread;
+  in >> nproc >> nthread >> num_switches_total_;
+  if (nproc != nproc_ || nthread != nthread_){
+    spkt_throw_printf(sprockit::InputError,
+      "partition_file %s is for %d ranks x %d threads, but running %d ranks x %d threads",
+      fname.c_str(), nproc, nthread, nproc_, nthread_);
+  }
+
+  switch_to_lpid_ = new int[num_switches_total_];
+  switch_to_thread_ = new int[num_switches_total_];
+  for (int i=0; i < num_switches_total_; ++i){
+    int sw;
+    uint64_t load;
+    in >> sw >> switch_to_lpid_[i] >> switch_to_thread_[i] >> load;
+    if (!in.good() || sw != i){
+      spkt_throw_printf(sprockit::InputError,
+        "partition_file %s: bad entry for switch %d", fname.c_str(), i);
+    }
+    part_debug("switch %d assigned to %d:%d", i, switch_to_lpid_[i], switch_to_thread_[i]);
+  }
+}
+
+void
+Partition::balanceSwitches(hw::Topology* top, const std::vector<uint64_t>& load,
+                           int nproc, int nthread,
+                           std::vector<int>& lpid, std::vector<int>& thread)
+{
+  int nswitches = load.size();
+  int nworkers = nproc * nthread;
+
+  //idle switches still cost something - also keeps them spread out
+  std::vector<uint64_t> weight(nswitches);
+  uint64_t total = 0;
+  for (int i=0; i < nswitches; ++i){
+    weight[i] = load[i] + 1;
+    total += weight[i];
+  }
+  //allow a little imbalance in exchange for keeping neighbors together
+  double target = 1.05 * double(total) / nworkers;
+
+  std::vector<int> order(nswitches);
+  for (int i=0; i < nswitches; ++i) order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b){
+    return weight[a] > weight[b];
+  });
+
+  std::vector<int> assignment(nswitches, -1);
+  std::vector<uint64_t> worker_load(nworkers, 0);
+  std::vector<int> num_neighbors(nworkers, 0);
+  std::vector<int> touched;
+  std::vector<hw::Topology::Connection> conns;
+  for (int sw : order){
+    top->connectedOutports(sw, conns);
+    for (auto& conn : conns){
+      int w = assignment[conn.dst];
+      if (w >= 0){
+        if (num_neighbors[w] == 0) touched.push_back(w);
+        ++num_neighbors[w];
+      }
+    }
+
+    int best = -1;
+    for (int w : touched){
+      bool fits = worker_load[w] + weight[sw] <= target;
+      if (fits && (best < 0 || num_neighbors[w] > num_neighbors[best])){
+        best = w;
+      }
+    }
+    if (best < 0){
+      best = std::min_element(worker_load.begin(), worker_load.end()) - worker_load.begin();
+    }
+
+    for (int w : touched) num_neighbors[w] = 0;
+    touched.clear();
+
+    assignment[sw] = best;
+    worker_load[best] += weight[sw];
+  }
+
+  lpid.resize(nswitches);
+  thread.resize(nswitches);
+  for (int i=0; i < nswitches; ++i){
+    lpid[i] = assignment[i] / nthread;
+    thread[i] = assignment[i] % nthread;
+  }
+}
+
+int
+Partition::countCut(hw::Topology* top, int& num_links, int& max_per_worker) const
+{
+  std::vector<int> per_worker(nproc_ * nthread_, 0);
+  std::vector<hw::Topology::Connection> conns;
+  int cut = 0;
+  num_links = 0;
+  for (int i=0; i < num_switches_total_; ++i){
+    ++per_worker[switch_to_lpid_[i] * nthread_ + switch_to_thread_[i]];
+    top->connectedOutports(i, conns);
+    for (auto& conn : conns){
+      ++num_links;
+      if (switch_to_lpid_[i] != switch_to_lpid_[conn.dst]
+          || switch_to_thread_[i] != switch_to_thread_[conn.dst]){
+        ++cut;
+      }
+    }
+  }
+  max_per_worker = *std::max_element(per_worker.begin(), per_worker.end());
+  return cut;
+}
+
+void
+Partition::writeFile(const std::string& fname, int nproc, int nthread,
+                     const std::vector<int>& lpid, const std::vector<int>& thread,
+                     const std::vector<uint64_t>& load)
+{
+  std::ofstream out(fname);
+  if (!out.good()){
+    spkt_abort_printf("could not open partition file %s for writing", fname.c_str());
+  }
+  out << nproc << " " << nthread << " " << load.size() << "\n";
+  for (int i=0; i < load.size(); ++i){
+    out << i << " " << lpid[i] << " " << thread[i] << " " << load[i] << "\n";
+  }
+}
+
+GraphPartition::~GraphPartition()
+{
+  delete[] switch_to_thread_;
+  delete[] switch_to_lpid_;
+}
+
+GraphPartition::GraphPartition(SST::Params& params, ParallelRuntime* rt)
+  : Partition(params, rt)
+{
+  SST::Params top_params = params.get_scoped_params("topology");
+  hw::Topology* top = sprockit::create<hw::Topology>(
+     "macro", top_params.find<std::string>("name"), top_params);
+
+  num_switches_total_ = top->numSwitches();
+  switch_to_lpid_ = new int[num_switches_total_];
+  switch_to_thread_ = new int[num_switches_total_];
+
+  SST::Params link_params = params.get_namespace("switch").get_namespace("link");
+  double hop_latency = 0;
+  if (link_params.contains("latency")){
+    hop_latency = link_params.find<SST::UnitAlgebra>("latency").getValue().toDouble();
+  }
+
+  //weight each edge with the latency the interconnect will give its link
+  std::vector<std::vector<Edge>> graph(num_switches_total_);
+  std::vector<double> latencies;
+  std::vector<hw::Topology::Connection> conns;
+  for (int i=0; i < num_switches_total_; ++i){
+    top->connectedOutports(i, conns);
+    for (auto& conn : conns){
+      double latency = hop_latency * top->portLatencyScaleFactor(i, conn.src_outport);
+      graph[i].push_back({int(conn.dst), latency});
+      latencies.push_back(latency);
+    }
+  }
+  std::sort(latencies.begin(), latencies.end(), std::greater<double>());
+  latencies.erase(std::unique(latencies.begin(), latencies.end()), latencies.end());
+
+  int nworkers = nproc_ * nthread_;
+  double imbalance = params.find<double>("partition_imbalance", 0.05);
+  int max_weight = std::ceil((1.0 + imbalance) * num_switches_total_ / nworkers);
+
+  //the lookahead is the smallest latency on a cut link - so find the largest
+  //latency such that every shorter link can be kept inside a single worker
+  std::vector<int> component(num_switches_total_);
+  double lookahead = latencies.empty() ? 0 : latencies.back();
+  for (double candidate : latencies){
+    for (int i=0; i < num_switches_total_; ++i) component[i] = i;
+    auto find = [&](int i){
+      while (component[i] != i){
+        component[i] = component[component[i]];
+        i = component[i];
+      }
+      return i;
+    };
+    for (int i=0; i < num_switches_total_; ++i){
+      for (auto& e : graph[i]){
+        if (e.latency < candidate) component[find(i)] = find(e.dst);
+      }
+    }
+    std::vector<int> size(num_switches_total_, 0);
+    int biggest = 0;
+    for (int i=0; i < num_switches_total_; ++i){
+      component[i] = find(i);
+      biggest = std::max(biggest, ++size[component[i]]);
+    }
+    if (biggest <= max_weight){
+      lookahead = candidate;
+      break;
+    }
+  }
+
+  //number the contracted vertices and build their graph
+  std::vector<int> vertex(num_switches_total_, -1);
+  std::vector<int> vertex_weight;
+  for (int i=0; i < num_switches_total_; ++i){
+    int root = component[i];
+    if (vertex[root] == -1){
+      vertex[root] = vertex_weight.size();
+      vertex_weight.push_back(0);
+    }
+    vertex[i] = vertex[root];
+    ++vertex_weight[vertex[i]];
+  }
+  std::vector<std::vector<int>> adjacency(vertex_weight.size());
+  for (int i=0; i < num_switches_total_; ++i){
+    for (auto& e : graph[i]){
+      if (vertex[i] != vertex[e.dst]) adjacency[vertex[i]].push_back(vertex[e.dst]);
+    }
+  }
+
+  std::vector<int> assignment;
+  partitionGraph(adjacency, vertex_weight, max_weight, assignment);
+
+  for (int i=0; i < num_switches_total_; ++i){
+    int worker = assignment[vertex[i]];
+    switch_to_lpid_[i] = worker / nthread_;
+    switch_to_thread_[i] = worker % nthread_;
+    part_debug("switch %d assigned to %d:%d", i, switch_to_lpid_[i], switch_to_thread_[i]);
+  }
+  part_debug("graph partition contracted %d switches into %d vertices for lookahead %10.6fus",
+             num_switches_total_, int(vertex_weight.size()), lookahead*1e6);
+
+  delete top;
+}
+
+void
+GraphPartition::partitionGraph(const std::vector<std::vector<int>>& adjacency,
+                               const std::vector<int>& vertex_weight,
+                               int max_weight, std::vector<int>& assignment)
+{
+  int nvertices = vertex_weight.size();
+  int nworkers = nproc_ * nthread_;
+  int total = num_switches_total_;
+  assignment.assign(nvertices, -1);
+  std::vector<int> part_weight(nworkers, 0);
+
+  //grow each worker from a seed, always absorbing the frontier vertex
+  //with the most links into the worker so far
+  std::vector<int> gain(nvertices, 0);
+  int next_seed = 0;
+  int assigned = 0;
+  for (int w=0; w < nworkers; ++w){
+    int target = (total - assigned + nworkers - w - 1) / (nworkers - w);
+    std::priority_queue<std::pair<int,int>> frontier;
+    std::vector<int> touched;
+    while (part_weight[w] < target){
+      int v = -1;
+      while (!frontier.empty()){
+        auto top = frontier.top();
+        frontier.pop();
+        int u = -top.second;
+        if (assignment[u] == -1 && top.first == gain[u]){
+          v = u;
+          break;
+        }
+      }
+      if (v == -1){
+        while (next_seed < nvertices && assignment[next_seed] != -1) ++next_seed;
+        if (next_seed == nvertices) break;
+        v = next_seed;
+      }
+      if (part_weight[w] > 0 && part_weight[w] + vertex_weight[v] > max_weight
+          && w != nworkers - 1){
+        break;
+      }
+      assignment[v] = w;
+      part_weight[w] += vertex_weight[v];
+      assigned += vertex_weight[v];
+      for (int u : adjacency[v]){
+        if (assignment[u] == -1){
+          if (gain[u] == 0) touched.push_back(u);
+          ++gain[u];
+          frontier.emplace(gain[u], -u);
+        }
+      }
+    }
+    for (int u : touched) gain[u] = 0;
+  }
+
+  for (int v=0; v < nvertices; ++v){
+    if (assignment[v] == -1){
+      int w = std::min_element(part_weight.begin(), part_weight.end()) - part_weight.begin();
+      assignment[v] = w;
+      part_weight[w] += vertex_weight[v];
+    }
+  }
+
+  //refine by moving boundary vertices to the neighboring worker they
+  //have the most links to, as long as balance is maintained
+  int min_weight = std::max(0, 2 * total / nworkers - max_weight);
+  std::vector<int> connections(nworkers, 0);
+  std::vector<int> touched;
+  for (int pass=0; pass < 8; ++pass){
+    int num_moved = 0;
+    for (int v=0; v < nvertices; ++v){
+      int from = assignment[v];
+      for (int u : adjacency[v]){
+        int w = assignment[u];
+        if (connections[w] == 0) touched.push_back(w);
+        ++connections[w];
+      }
+      int best = from;
+      int best_gain = 0;
+      for (int w : touched){
+        int move_gain = connections[w] - connections[from];
+        if (w != from && move_gain > best_gain
+            && part_weight[w] + vertex_weight[v] <= max_weight
+            && part_weight[from] - vertex_weight[v] >= min_weight){
+          best = w;
+          best_gain = move_gain;
+        }
+      }
+      for (int w : touched) connections[w] = 0;
+      touched.clear();
+
+      if (best != from){
+        assignment[v] = best;
+        part_weight[from] -= vertex_weight[v];
+        part_weight[best] += vertex_weight[v];
+        ++num_moved;
+      }
+    }
+    if (num_moved == 0) break;
+  }
+}
+
 BlockPartition::~BlockPartition()
 {
 }
@@ -56,6 +56,8 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/sst_core/integrated_component.h>
 
 #include <vector>
+#include <string>
+#include <cstdint>
 
 DeclareDebugSlot(partition);
 
@@ -97,6 +99,38 @@ class Partition
 
   virtual void finalizeInit(SST::Params&){}
 
+  /**
+   * @brief balanceSwitches Greedily assign switches to workers (rank,thread)
+   * so that measured load is balanced. Heaviest switches are placed first,
+   * each onto the worker already holding most of its topology neighbors among
+   * those that would stay under the balance target.
+   * @param top
+   * @param load  The measured load (events) for each switch
+   * @param nproc
+   * @param nthread
+   * @param lpid  [out] The rank for each switch
+   * @param thread [out] The thread for each switch
+   */
+  static void balanceSwitches(hw::Topology* top, const std::vector<uint64_t>& load,
+                              int nproc, int nthread,
+                              std::vector<int>& lpid, std::vector<int>& thread);
+
+  /**
+   * @brief countCut Count the switch-to-switch links that cross workers
+   * @param top
+   * @param num_links [out] The total number of switch-to-switch links
+   * @param max_per_worker [out] The most switches assigned to any one worker
+   * @return The number of links whose endpoints are on different workers
+   */
+  int countCut(hw::Topology* top, int& num_links, int& max_per_worker) const;
+
+  /**
+   * @brief writeFile Write a partition readable by partition = file
+   */
+  static void writeFile(const std::string& fname, int nproc, int nthread,
+                        const std::vector<int>& lpid, const std::vector<int>& thread,
+                        const std::vector<uint64_t>& load);
+
  protected:
   Partition(SST::Params& params, ParallelRuntime* rt);
 
@@ -159,6 +193,69 @@ class TopologyPartition :
 
 };
 
+/**
+ * Partition read back from a file, usually one written by a previous run
+ * with partition_measure_file that rebalanced switches on measured load
+ */
+class FilePartition :
+  public Partition
+{
+ public:
+  SST_ELI_REGISTER_DERIVED(
+    Partition,
+    FilePartition,
+    "macro",
+    "file",
+    SST_ELI_ELEMENT_VERSION(1,0,0),
+    "partition read from a file of switch assignments")
+
+  FilePartition(SST::Params& params, ParallelRuntime* rt);
+
+  ~FilePartition() override;
+
+};
+
+/**
+ * Partition of the switch graph that keeps low-latency links internal
+ * to a worker (maximizing lookahead) and then minimizes the number of cut links
+ * subject to keeping switch counts balanced
+ */
+class GraphPartition :
+  public Partition
+{
+ public:
+  SST_ELI_REGISTER_DERIVED(
+    Partition,
+    GraphPartition,
+    "macro",
+    "graph",
+    SST_ELI_ELEMENT_VERSION(1,0,0),
+    "partition that maximizes lookahead and minimizes cut links")
+
+  GraphPartition(SST::Params& params, ParallelRuntime* rt);
+
+  ~GraphPartition() override;
+
+ private:
+  struct Edge {
+    int dst;
+    double latency;
+  };
+
+  /**
+   * @brief partitionGraph Greedy graph growing from the contracted
+   *  vertices followed by boundary refinement
+   * @param adjacency
+   * @param vertex_weight  The number of switches in each contracted vertex
+   * @param max_weight     The most switches allowed on a worker
+   * @param assignment [out] The worker for each contracted vertex
+   */
+  void partitionGraph(const std::vector<std::vector<int>>& adjacency,
+                      const std::vector<int>& vertex_weight,
+                      int max_weight, std::vector<int>& assignment);
+
+};
+
 class BlockPartition :
   public Partition
 {
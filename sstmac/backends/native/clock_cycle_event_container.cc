@@ -192,6 +192,8 @@ ClockCycleEventMap::run()
   }
   computeFinalTime(now_);
   if (rt_->me() == 0) printf("Ran %" PRIu64 " epochs on MPI parallel\n", epoch);
+
+  writeMeasuredPartition();
 }
 
 void
@@ -63,9 +63,16 @@ RegisterDebugSlot(cpu_affinity);
 
 RegisterKeywords(
  { "cpu_affinity", "the CPU offset for binding threads to core" },
+ { "busy_loop_count", "the number of no-op iterations between checks of the thread barrier" },
+ { "thread_barrier", "how threads wait at the epoch barrier: spin (default) or hybrid spin-then-park" },
+ { "barrier_max_spin", "the maximum number of busy loops a hybrid barrier spins before parking" },
+ { "num_worker_threads", "the number of pthreads running the sst_nthread partitions, fewer enables work stealing" },
 );
 
 static int busy_loop_count = 200;
+static bool hybrid_barrier = false;
+static int max_spin_count = 1000;
+static const int min_spin_count = 4;
 static int epoch_print_interval = 10000;
 
 static uint64_t event_cycles = 0;
@@ -87,13 +94,74 @@ namespace native {
   (add_int64_atomic(int32_t(0), x) == 0)
   //*x == 0
 
-static inline void wait_on_child_completion(threadQueue* q, Timestamp& min_time)
+/**
+ * Wait until ready() holds, where ready() only changes through a thread that calls wake(sig).
+ * A pure spin barrier busy loops forever. A hybrid barrier spins for an adaptive
+ * number of loops - growing when spinning pays off and shrinking when it doesn't -
+ * and then sleeps on sig.cond until it is woken.
+ */
+template <class Fxn>
+static inline void wait_until(BarrierSignal& sig, BarrierWaiter& waiter, Fxn&& ready)
 {
-  bool done = atomic_is_zero(q->delta_t);
-  while (!done){
-    busy_loop(); //don't slam the variable too hard
-    done = atomic_is_zero(q->delta_t);
+  if (ready()) return;
+
+  auto t_start = rdtsc();
+  if (!hybrid_barrier){
+    while (!ready()){
+      busy_loop(); //don't slam the variable too hard
+    }
+    waiter.spin_cycles += rdtsc() - t_start;
+    return;
   }
+
+  for (int i=0; i < waiter.spin_limit; ++i){
+    busy_loop();
+    if (ready()){
+      waiter.spin_cycles += rdtsc() - t_start;
+      waiter.spin_limit = std::min(2*waiter.spin_limit, max_spin_count);
+      return;
+    }
+  }
+
+  auto t_park = rdtsc();
+  waiter.spin_cycles += t_park - t_start;
+  waiter.spin_limit = std::max(waiter.spin_limit / 2, min_spin_count);
+  //full barrier - either we see the new state or the signaler sees us parked
+  add_int32_atomic(1, &sig.parked);
+  pthread_mutex_lock(&sig.lock);
+  while (!ready()){
+    pthread_cond_wait(&sig.cond, &sig.lock);
+  }
+  pthread_mutex_unlock(&sig.lock);
+  add_int32_atomic(-1, &sig.parked);
+  waiter.park_cycles += rdtsc() - t_park;
+  ++waiter.num_parks;
+}
+
+/**
+ * Wake anyone parked on sig, must follow an atomic update of the state they wait on
+ */
+static inline void wake(BarrierSignal& sig)
+{
+  if (sig.parked){
+    pthread_mutex_lock(&sig.lock);
+    pthread_cond_broadcast(&sig.cond);
+    pthread_mutex_unlock(&sig.lock);
+  }
+}
+
+/**
+ * Change q->delta_t and wake anyone parked waiting on it
+ */
+static inline void add_delta(threadQueue* q, int64_t delta)
+{
+  add_int64_atomic(delta, q->delta_t);
+  wake(q->signal);
+}
+
+static inline void wait_on_child_completion(threadQueue* q, BarrierWaiter& waiter, Timestamp& min_time)
+{
+  wait_until(q->signal, waiter, [q]{ return atomic_is_zero(q->delta_t); });
   min_time = std::min(min_time, q->min_time);
 }
 
@@ -105,27 +173,23 @@ pthread_run_worker_thread(void* args)
   uint64_t epoch = 0;
   debug_printf(sprockit::dbg::parallel, "spun up subthread");
   while(1){
-    bool stillZero = atomic_is_zero(q->delta_t);
-    if (!stillZero){
-      int64_t delta_t = *q->delta_t;
-      if (q->child1) add_int64_atomic(delta_t, q->child1->delta_t);
-      if (q->child2) add_int64_atomic(delta_t, q->child2->delta_t);
-      if (delta_t == terminate_sentinel){
-        return;
-      } else if (delta_t != 0) {
-        horizon += TimeDelta(delta_t, TimeDelta::exact);
-        Timestamp new_min_time = q->mgr->runEvents(horizon);
-        debug_printf(sprockit::dbg::parallel, "manager %d:%d voting for minimum time %10.7e on epoch %d",
-                    q->mgr->me(), q->mgr->thread(), new_min_time.sec(), q->mgr->epoch());
-        q->min_time = new_min_time;
-      }
-      if (q->child1) wait_on_child_completion(q->child1, q->min_time);
-      if (q->child2) wait_on_child_completion(q->child2, q->min_time);
-      add_int64_atomic(-delta_t, q->delta_t);
-      ++epoch;
-    } else {
-      busy_loop(); //don't slam the variable too hard
+    wait_until(q->signal, q->waiter, [q]{ return !atomic_is_zero(q->delta_t); });
+    int64_t delta_t = *q->delta_t;
+    if (q->child1) add_delta(q->child1, delta_t);
+    if (q->child2) add_delta(q->child2, delta_t);
+    if (delta_t == terminate_sentinel){
+      return;
+    } else if (delta_t != 0) {
+      horizon += TimeDelta(delta_t, TimeDelta::exact);
+      Timestamp new_min_time = q->mgr->runEvents(horizon);
+      debug_printf(sprockit::dbg::parallel, "manager %d:%d voting for minimum time %10.7e on epoch %d",
+                  q->mgr->me(), q->mgr->thread(), new_min_time.sec(), q->mgr->epoch());
+      q->min_time = new_min_time;
     }
+    if (q->child1) wait_on_child_completion(q->child1, q->waiter, q->min_time);
+    if (q->child2) wait_on_child_completion(q->child2, q->waiter, q->min_time);
+    add_delta(q, -delta_t);
+    ++epoch;
   }
   return;
 }
@@ -137,6 +201,21 @@ spin_up_pthread_work(void* args){
   return 0;
 }
 
+static void
+pthread_run_steal_worker(void* args)
+{
+  StealWorker* w = (StealWorker*) args;
+  w->container->runStealWorker(w);
+}
+
+static void*
+spin_up_pthread_steal_work(void* args){
+  StealWorker* w = (StealWorker*) args;
+  //any manager will do, it just provides the DES context for this pthread
+  w->container->threadManager(w->id - 1)->spinUp(pthread_run_steal_worker, w);
+  return 0;
+}
+
 MultithreadedEventContainer::MultithreadedEventContainer(
   SST::Params& params, ParallelRuntime* rt) :
   ClockCycleEventMap(params, rt)
@@ -156,6 +235,15 @@ MultithreadedEventContainer::MultithreadedEventContainer(
   }
 
   busy_loop_count = params.find<int>("busy_loop_count", busy_loop_count);
+  max_spin_count = params.find<int>("barrier_max_spin", max_spin_count);
+  auto barrier = params.find<std::string>("thread_barrier", "spin");
+  if (barrier == "hybrid"){
+    hybrid_barrier = true;
+  } else if (barrier != "spin"){
+    spkt_abort_printf("invalid thread_barrier %s: must be spin or hybrid", barrier.c_str());
+  }
+  main_waiter_.spin_limit = max_spin_count;
+  num_epochs_ = 0;
 
   num_subthreads_ = rt->nthread() - 1;
 
@@ -172,6 +260,33 @@ MultithreadedEventContainer::MultithreadedEventContainer(
 
   for (int i=0; i < queues_.size(); ++i){
     queues_[i].mgr = thread_managers_[i];
+    queues_[i].waiter.spin_limit = max_spin_count;
+  }
+
+  int nworkers = params.find<int>("num_worker_threads", rt->nthread());
+  if (nworkers < 1 || nworkers > rt->nthread()){
+    spkt_abort_printf("num_worker_threads=%d must be between 1 and sst_nthread=%d",
+                      nworkers, rt->nthread());
+  }
+  work_stealing_ = nworkers < rt->nthread();
+  steal_epoch_ = 0;
+  active_workers_ = 0;
+  steal_terminate_ = false;
+  last_own_cycles_ = 0;
+  last_stolen_cycles_ = 0;
+  if (work_stealing_){
+    steal_workers_.resize(nworkers);
+    for (int w=0; w < nworkers; ++w){
+      StealWorker* worker = new StealWorker;
+      worker->container = this;
+      worker->id = w;
+      worker->waiter.spin_limit = max_spin_count;
+      steal_workers_[w] = worker;
+    }
+    //deal the logical managers out round-robin, each keeps its components pinned
+    for (int thr=0; thr < rt->nthread(); ++thr){
+      steal_workers_[thr % nworkers]->deque.addTask(thr);
+    }
   }
 
   for (int i=0; i < num_subthreads_; ++i){
@@ -254,16 +369,16 @@ MultithreadedEventContainer::runWork()
       spkt_abort_printf("Time did not advance - caught in infinite time loop");
     }
 
-    if (child1) add_int64_atomic(delta_t, child1->delta_t);
-    if (child2) add_int64_atomic(delta_t, child2->delta_t);
+    if (child1) add_delta(child1, delta_t);
+    if (child2) add_delta(child2, delta_t);
 
     auto t_start = rdtsc();
     Timestamp min_time = runEvents(horizon);
 
     auto t_run = rdtsc();
 
-    if (child1) wait_on_child_completion(child1, min_time);
-    if (child2) wait_on_child_completion(child2, min_time);
+    if (child1) wait_on_child_completion(child1, main_waiter_, min_time);
+    if (child2) wait_on_child_completion(child2, main_waiter_, min_time);
 
     if (stopped_){
       lower_bound = no_events_left_time; //done
@@ -281,18 +396,168 @@ MultithreadedEventContainer::runWork()
       debug_printf(sprockit::dbg::multithread,
            "Epoch %-10" PRIu64 " ran until horizon %" PRIu64 ":%" PRIu64 " - new bound = %" PRIu64 ":%" PRIu64 "\n",
            epoch, horizon.epochs, horizon.time.ticks(), lower_bound.epochs, lower_bound.time.ticks());
+      debug_printf(sprockit::dbg::multithread,
+           "Epoch %-10" PRIu64 " main thread barrier spun %" PRIu64 " cycles, parked %" PRIu64
+           " cycles in %" PRIu64 " parks\n",
+           epoch, main_waiter_.spin_cycles, main_waiter_.park_cycles, main_waiter_.num_parks);
       fflush(stdout);
     }
     ++epoch;
   }
 
-  if (child1) add_int64_atomic(terminate_sentinel, child1->delta_t);
-  if (child2) add_int64_atomic(terminate_sentinel, child2->delta_t);
+  if (child1) add_delta(child1, terminate_sentinel);
+  if (child2) add_delta(child2, terminate_sentinel);
 
+  num_epochs_ = epoch;
   if (rt_->me() == 0) printf("Ran %" PRIu64 " epochs in multithreading run\n", epoch);
 
 }
 
+void
+MultithreadedEventContainer::runStealTasks(StealWorker* w)
+{
+  Timestamp horizon = steal_horizon_;
+  w->min_time = no_events_left_time;
+  auto runTask = [&](int task, uint64_t& cycles){
+    auto t_start = rdtsc();
+    Timestamp min_time = threadManager(task)->runEvents(horizon);
+    w->min_time = std::min(w->min_time, min_time);
+    cycles += rdtsc() - t_start;
+  };
+
+  int task;
+  while (w->deque.pop(task)){
+    runTask(task, w->own_cycles);
+  }
+
+  //no tasks are added during an epoch, one pass finding nothing means we are done
+  int nworkers = steal_workers_.size();
+  bool found = true;
+  while (found){
+    found = false;
+    for (int i=1; i < nworkers; ++i){
+      StealWorker* victim = steal_workers_[(w->id + i) % nworkers];
+      if (victim->deque.steal(task)){
+        runTask(task, w->stolen_cycles);
+        ++w->num_stolen;
+        found = true;
+        break;
+      }
+    }
+  }
+
+  add_int32_atomic(-1, &active_workers_);
+  wake(steal_done_);
+}
+
+void
+MultithreadedEventContainer::runStealWorker(StealWorker* w)
+{
+  int64_t last_epoch = 0;
+  while (1){
+    wait_until(steal_start_, w->waiter, [&]{ return steal_epoch_ != last_epoch; });
+    last_epoch = steal_epoch_;
+    if (steal_terminate_){
+      return;
+    }
+    runStealTasks(w);
+  }
+}
+
+void
+MultithreadedEventContainer::printStealStats(uint64_t epoch, bool cumulative)
+{
+  uint64_t own = 0;
+  uint64_t stolen = 0;
+  uint64_t num_stolen = 0;
+  for (StealWorker* w : steal_workers_){
+    own += w->own_cycles;
+    stolen += w->stolen_cycles;
+    num_stolen += w->num_stolen;
+  }
+  if (cumulative){
+    double frac = (own + stolen) ? double(stolen) / double(own + stolen) : 0.;
+    printf("Work stealing: %" PRIu64 " batches stolen, %5.2f%% of event cycles stolen over %" PRIu64 " epochs\n",
+           num_stolen, 100*frac, epoch);
+  } else {
+    uint64_t own_delta = own - last_own_cycles_;
+    uint64_t stolen_delta = stolen - last_stolen_cycles_;
+    double frac = (own_delta + stolen_delta) ? double(stolen_delta) / double(own_delta + stolen_delta) : 0.;
+    debug_printf(sprockit::dbg::multithread,
+         "Epoch %-10" PRIu64 " stole %5.2f%% of event cycles since last report\n",
+         epoch, 100*frac);
+  }
+  last_own_cycles_ = own;
+  last_stolen_cycles_ = stolen;
+}
+
+void
+MultithreadedEventContainer::runWorkStealing()
+{
+  Timestamp lower_bound;
+  uint64_t epoch = 0;
+  int num_loops_left = num_profile_loops_;
+  if (num_loops_left && rt_->me() == 0){
+    printf("Running %d profile loops\n", num_loops_left);
+    fflush(stdout);
+  }
+  if (lookahead_.ticks() == 0){
+    sprockit::abort("Zero-latency link - no lookahead, cannot run in parallel");
+  }
+  int nworkers = steal_workers_.size();
+  if (rt_->me() == 0){
+    printf("Running parallel simulation with lookahead %10.6fus and %d workers stealing from %d thread partitions\n",
+           lookahead_.usec(), nworkers, nthread());
+  }
+
+  StealWorker* me = steal_workers_[0];
+  while (lower_bound != no_events_left_time || num_loops_left > 0){
+    Timestamp horizon = lower_bound + lookahead_;
+    //everyone is idle - safe to refill the deques
+    for (StealWorker* w : steal_workers_){
+      w->deque.reset();
+    }
+    steal_horizon_ = horizon;
+    active_workers_ = nworkers;
+    add_int64_atomic(1, &steal_epoch_);
+    wake(steal_start_);
+
+    auto t_start = rdtsc();
+    runStealTasks(me);
+    auto t_run = rdtsc();
+
+    wait_until(steal_done_, main_waiter_, [this]{ return active_workers_ == 0; });
+    Timestamp min_time = no_events_left_time;
+    for (StealWorker* w : steal_workers_){
+      min_time = std::min(min_time, w->min_time);
+    }
+
+    if (stopped_){
+      lower_bound = no_events_left_time; //done
+    } else {
+      lower_bound = receiveIncomingEvents(min_time);
+    }
+    if (num_loops_left > 0) --num_loops_left;
+    auto t_stop = rdtsc();
+    event_cycles += t_run - t_start;
+    barrier_cycles += t_stop - t_run;
+    if (epoch % epoch_print_interval == 0 && rt_->me() == 0){
+      printStealStats(epoch, false);
+    }
+    ++epoch;
+  }
+
+  steal_terminate_ = true;
+  add_int64_atomic(1, &steal_epoch_);
+  wake(steal_start_);
+
+  num_epochs_ = epoch;
+  if (rt_->me() == 0){
+    printf("Ran %" PRIu64 " epochs in multithreading run\n", epoch);
+    printStealStats(epoch, true);
+  }
+}
+
 void
 MultithreadedEventContainer::run()
 {
@@ -328,13 +593,14 @@ MultithreadedEventContainer::run()
   //launch all the subthreads - don't launch zero
   //main thread will do zero's work
   int status;
+  int num_pthreads = work_stealing_ ? steal_workers_.size() - 1 : num_subthreads_;
   debug_printf(sprockit::dbg::parallel, "spawning %d subthreads",
-               num_subthreads_);
+               num_pthreads);
 
 #if SSTMAC_USE_CPU_AFFINITY
   int thread_affinity;
 #endif
-  for (int i=0; i < num_subthreads_; ++i){
+  for (int i=0; i < num_pthreads; ++i){
 #if SSTMAC_USE_CPU_AFFINITY
     //pin the pthread to core base+i
     thread_affinity = task_affinity + i + 1;
@@ -354,27 +620,64 @@ MultithreadedEventContainer::run()
     }
 #endif
     debug_printf(sprockit::dbg::parallel, "PDES rank %i: spinning up subthread %i", me_, i);
-    status = pthread_create(&pthreads_[i], &pthread_attrs_[i], spin_up_pthread_work, &queues_[i]);
+    if (work_stealing_){
+      //worker zero is this main thread
+      status = pthread_create(&pthreads_[i], &pthread_attrs_[i],
+                              spin_up_pthread_steal_work, steal_workers_[i+1]);
+    } else {
+      status = pthread_create(&pthreads_[i], &pthread_attrs_[i], spin_up_pthread_work, &queues_[i]);
+    }
     if (status != 0){
         spkt_abort_printf("multithreaded_event_container::run: failed creating pthread=%d:\n%s",
                         errno, ::strerror(errno));
     }
   }
 
-  runWork();
+  if (work_stealing_){
+    runWorkStealing();
+  } else {
+    runWork();
+  }
 
   Timestamp final_time = now_;
 
-  for (int i=0; i < num_subthreads_; ++i){
+  for (int i=0; i < num_pthreads; ++i){
     void* ignore;
     int status = pthread_join(pthreads_[i], &ignore);
     if (status != 0){
         sprockit::abort("multithreaded_event_container::run: failed joining pthread");
     }
+  }
+  for (int i=0; i < num_subthreads_; ++i){
     final_time = std::max(final_time, thread_managers_[i]->now());
   }
 
+  if (!work_stealing_){
+    printBarrierStats();
+  }
+
   computeFinalTime(final_time);
+
+  writeMeasuredPartition();
+}
+
+void
+MultithreadedEventContainer::printBarrierStats()
+{
+  if (rt_->me() != 0) return;
+
+  uint64_t epochs = std::max(num_epochs_, uint64_t(1));
+  auto print = [epochs](int thr, const BarrierWaiter& w){
+    printf("Thread %3d barrier: spin %13" PRIu64 " park %13" PRIu64 " cycles, "
+           "per epoch spin %10" PRIu64 " park %10" PRIu64 ", %" PRIu64 " parks\n",
+           thr, w.spin_cycles, w.park_cycles,
+           w.spin_cycles / epochs, w.park_cycles / epochs, w.num_parks);
+  };
+  //workers were joined - their waiters are safe to read
+  for (int i=0; i < num_subthreads_; ++i){
+    print(i, queues_[i].waiter);
+  }
+  print(num_subthreads_, main_waiter_);
 }
 
 
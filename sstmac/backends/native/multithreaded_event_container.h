@@ -51,6 +51,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/backends/native/clock_cycle_event_container.h>
 #include <pthread.h>
 #include <stdlib.h>
+#include <atomic>
 
 DeclareDebugSlot(multithread_EventManager);
 DeclareDebugSlot(cpu_affinity);
@@ -60,6 +61,46 @@ namespace native {
 
 class MultithreadedEventContainer;
 
+/**
+ * Per-thread bookkeeping for waiting at the thread barrier.
+ * Only ever touched by the thread that owns it.
+ */
+struct BarrierWaiter
+{
+  BarrierWaiter() :
+    spin_limit(0),
+    spin_cycles(0),
+    park_cycles(0),
+    num_parks(0)
+  {
+  }
+
+  /** The adaptive number of busy loops to spin before parking */
+  int spin_limit;
+  uint64_t spin_cycles;
+  uint64_t park_cycles;
+  uint64_t num_parks;
+};
+
+/**
+ * Lets threads waiting at a barrier go to sleep until whoever
+ * changes the state they are waiting on wakes them up
+ */
+struct BarrierSignal
+{
+  BarrierSignal() :
+    parked(0)
+  {
+    pthread_mutex_init(&lock, nullptr);
+    pthread_cond_init(&cond, nullptr);
+  }
+
+  /** The number of threads sleeping on cond */
+  volatile int32_t parked;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+};
+
 struct threadQueue
 {
   threadQueue() :
@@ -81,9 +122,92 @@ struct threadQueue
   EventManager* mgr;
   threadQueue* child1;
   threadQueue* child2;
+  /** For parking while waiting on a change in delta_t */
+  BarrierSignal signal;
+  /** The owning worker thread's waits */
+  BarrierWaiter waiter;
 
 };
 
+/**
+ * Fixed set of tasks (logical event manager indices) owned by one worker.
+ * The owner pops from the bottom while idle workers steal from the top.
+ * Both ends are packed into a single word updated by compare-and-swap,
+ * so neither side ever takes a lock.
+ */
+class WorkStealingDeque
+{
+ public:
+  WorkStealingDeque() : ends_(0) {}
+
+  void addTask(int task){
+    tasks_.push_back(task);
+  }
+
+  int numTasks() const {
+    return tasks_.size();
+  }
+
+  /** Refill with every task, only when no thread is popping or stealing */
+  void reset(){
+    ends_.store(pack(0, tasks_.size()));
+  }
+
+  bool pop(int& task){
+    uint64_t ends = ends_.load();
+    while (true){
+      uint32_t top = ends >> 32;
+      uint32_t bottom = ends;
+      if (top == bottom) return false;
+      if (ends_.compare_exchange_weak(ends, pack(top, bottom-1))){
+        task = tasks_[bottom-1];
+        return true;
+      }
+    }
+  }
+
+  bool steal(int& task){
+    uint64_t ends = ends_.load();
+    while (true){
+      uint32_t top = ends >> 32;
+      uint32_t bottom = ends;
+      if (top == bottom) return false;
+      if (ends_.compare_exchange_weak(ends, pack(top+1, bottom))){
+        task = tasks_[top];
+        return true;
+      }
+    }
+  }
+
+ private:
+  static uint64_t pack(uint32_t top, uint32_t bottom){
+    return (uint64_t(top) << 32) | bottom;
+  }
+
+  std::vector<int> tasks_;
+  std::atomic<uint64_t> ends_;
+};
+
+struct StealWorker
+{
+  StealWorker() :
+    container(nullptr),
+    id(0),
+    own_cycles(0),
+    stolen_cycles(0),
+    num_stolen(0)
+  {
+  }
+
+  MultithreadedEventContainer* container;
+  int id;
+  WorkStealingDeque deque;
+  Timestamp min_time;
+  uint64_t own_cycles;
+  uint64_t stolen_cycles;
+  uint64_t num_stolen;
+  BarrierWaiter waiter;
+};
 
 class MultithreadedEventContainer :
   public ClockCycleEventMap
@@ -99,12 +223,20 @@ class MultithreadedEventContainer :
 
   MultithreadedEventContainer(SST::Params& params, ParallelRuntime* rt);
 
-  ~MultithreadedEventContainer() throw () override {}
+  ~MultithreadedEventContainer() throw () override {
+    for (StealWorker* w : steal_workers_) delete w;
+  }
 
   void run() override;
 
   void scheduleStop(Timestamp until) override;
 
+  /**
+   * @brief runStealWorker Event loop for a pthread in work-stealing mode
+   * @param w
+   */
+  void runStealWorker(StealWorker* w);
+
   EventManager* threadManager(int thr) const override {
     if (thr == num_subthreads_) {
       return const_cast<MultithreadedEventContainer*>(this);
@@ -120,7 +252,30 @@ class MultithreadedEventContainer :
 
   void runWork();
 
+  void runWorkStealing();
+
+  void runStealTasks(StealWorker* w);
+
+  void printBarrierStats();
+
+  void printStealStats(uint64_t epoch, bool cumulative);
+
   std::vector<threadQueue> queues_;
+  BarrierWaiter main_waiter_;
+  uint64_t num_epochs_;
+
+  /** Work-stealing mode: fewer pthreads than logical event managers */
+  bool work_stealing_;
+  std::vector<StealWorker*> steal_workers_;
+  /** Bumped by the main thread to start each epoch */
+  volatile int64_t steal_epoch_;
+  volatile int32_t active_workers_;
+  bool steal_terminate_;
+  Timestamp steal_horizon_;
+  BarrierSignal steal_start_;
+  BarrierSignal steal_done_;
+  uint64_t last_own_cycles_;
+  uint64_t last_stolen_cycles_;
   std::vector<int> cpu_affinity_;
   std::vector<pthread_t> pthreads_;
   std::vector<pthread_attr_t> pthread_attrs_;
@@ -47,6 +47,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/common/sst_event.h>
 #include <sstmac/common/stats/stat_collector.h>
 #include <sstmac/hardware/interconnect/interconnect.h>
+#include <sstmac/hardware/topology/topology.h>
 #include <sstmac/backends/common/sim_partition.h>
 #include <sstmac/backends/common/parallel_runtime.h>
 #include <sstmac/software/threading/threading_interface.h>
@@ -56,12 +57,22 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sprockit/util.h>
 #include <sprockit/output.h>
 #include <sprockit/thread_safe_new.h>
+#include <sprockit/keyword_registration.h>
 #include <limits>
+#include <algorithm>
 
 #include <cinttypes>
 
 RegisterDebugSlot(event_manager);
 
+RegisterNamespaces("event_manager");
+
+RegisterKeywords(
+  { "queue", "the event queue implementation: set (red-black tree) or ladder" },
+  { "queue_trace", "file prefix for recording binary traces of every event queue push/pop" },
+  { "partition_measure_file", "file to write a switch partition rebalanced on measured event counts" }
+);
+
 #define prll_debug(...) \
   debug_printf(sprockit::dbg::parallel, "LP %d: %s", rt_->me(), sprockit::sprintf(__VA_ARGS__).c_str())
 
@@ -114,7 +125,8 @@ EventManager::EventManager(SST::Params& params, ParallelRuntime *rt) :
   me_(rt->me()),
   nproc_(rt->nproc()),
   nthread_(rt->nthread()),
-  thread_id_(0)
+  thread_id_(0),
+  link_to_switch_(nullptr)
 {
   for (int i=0; i < num_pendingSlots; ++i){
     pending_events_[i].resize(nthread_);
@@ -132,6 +144,24 @@ EventManager::EventManager(SST::Params& params, ParallelRuntime *rt) :
 
   //make sure there's a good bit of space
   pending_serialization_.reserve(1024);
+
+  SST::Params queue_params = params.get_scoped_params("event_manager");
+  auto queue_type = queue_params.find<std::string>("queue", "set");
+  if (queue_type == "ladder"){
+    event_queue_.setType(EventQueue::ladder);
+  } else if (queue_type != "set"){
+    spkt_abort_printf("invalid event_manager.queue %s: must be set or ladder",
+                      queue_type.c_str());
+  }
+
+  if (queue_params.contains("queue_trace")){
+    //thread managers are all built before thread ids are assigned
+    static int num_traces = 0;
+    auto fname = queue_params.find<std::string>("queue_trace");
+    event_queue_.recordTrace(sprockit::sprintf("%s.%d.%d", fname.c_str(), me_, num_traces++));
+  }
+
+  partition_measure_file_ = params.find<std::string>("partition_measure_file", "");
 }
 
 EventManager::~EventManager()
@@ -160,9 +190,7 @@ void
 EventManager::stop()
 {
   printf("Shutting down simulation at t=%20.12fs\n", now().sec());
-  for (ExecutionEvent* ev : event_queue_){
-    delete ev;
-  }
+  event_queue_.forEach([](ExecutionEvent* ev){ delete ev; });
   event_queue_.clear();
   min_ipc_time_ = no_events_left_time;
   stopped_ = true;
@@ -182,8 +210,7 @@ EventManager::runEvents(Timestamp event_horizon)
   prll_debug("manager %d:%d running to horizon %10.5e with %llu events in queue on epoch %d",
              me_, thread_id_, event_horizon.sec(), event_queue_.size(), epoch());
   while (!event_queue_.empty()){
-    auto iter = event_queue_.begin();
-    ExecutionEvent* ev = *iter;
+    ExecutionEvent* ev = event_queue_.top();
     prll_debug("manager %d:%d pulled event %" PRIu32 " from link %" PRIu64 " at t=%10.7e on epoch %d",
                 me_, thread_id_, ev->seqnum(), ev->linkId(), ev->time().sec(), epoch());
 #if SSTMAC_SANITY_CHECK
@@ -198,7 +225,13 @@ EventManager::runEvents(Timestamp event_horizon)
       return ret;
     } else {
       now_ = ev->time();
-      event_queue_.erase(iter);
+      event_queue_.pop();
+      if (link_to_switch_){
+        uint64_t link = ev->linkId();
+        if (link < link_to_switch_->size() && (*link_to_switch_)[link] >= 0){
+          ++switch_load_[(*link_to_switch_)[link]];
+        }
+      }
       ev->execute();
       delete ev;
     }
@@ -217,6 +250,49 @@ EventManager::setInterconnect(hw::Interconnect* interconn)
 {
   lookahead_ = interconn->lookahead();
   interconn_ = interconn;
+  if (!partition_measure_file_.empty()){
+    link_to_switch_ = &interconn->linkToSwitch();
+    switch_load_.resize(interconn->topology()->numSwitches());
+  }
+}
+
+void
+EventManager::writeMeasuredPartition()
+{
+  if (partition_measure_file_.empty()) return;
+
+  int nswitches = interconn_->topology()->numSwitches();
+  std::vector<uint64_t> load(nswitches, 0);
+  for (int t=0; t < nthread_; ++t){
+    EventManager* mgr = threadManager(t);
+    for (int i=0; i < mgr->switch_load_.size(); ++i){
+      load[i] += mgr->switch_load_[i];
+    }
+  }
+  rt_->globalSum(load.data(), nswitches, 0);
+  if (me_ != 0) return;
+
+  int nworkers = nproc_ * nthread_;
+  Partition* part = topologyPartition();
+  std::vector<uint64_t> old_load(nworkers, 0);
+  std::vector<uint64_t> new_load(nworkers, 0);
+  std::vector<int> lpid, thread;
+  Partition::balanceSwitches(interconn_->topology(), load, nproc_, nthread_, lpid, thread);
+  uint64_t total = 0;
+  for (int i=0; i < nswitches; ++i){
+    old_load[part->lpidForSwitch(i)*nthread_ + part->threadForSwitch(i)] += load[i];
+    new_load[lpid[i]*nthread_ + thread[i]] += load[i];
+    total += load[i];
+  }
+  Partition::writeFile(partition_measure_file_, nproc_, nthread_, lpid, thread, load);
+
+  double avg = std::max(double(total) / nworkers, 1.0);
+  uint64_t old_max = *std::max_element(old_load.begin(), old_load.end());
+  uint64_t new_max = *std::max_element(new_load.begin(), new_load.end());
+  cout0 << sprockit::sprintf("Measured %" PRIu64 " switch events: max/avg load %.3f current, "
+                             "%.3f rebalanced -> %s\n",
+                             total, old_max / avg, new_max / avg,
+                             partition_measure_file_.c_str());
 }
 
 int
@@ -407,6 +483,8 @@ EventManager::run()
   final_time_ = now_;
 
   finalizeStatsOutput();
+
+  writeMeasuredPartition();
 }
 
 void
@@ -68,6 +68,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/common/event_scheduler_fwd.h>
 #include <sstmac/backends/native/manager_fwd.h>
 #include <sstmac/common/sst_event.h>
+#include <sstmac/common/event_queue.h>
 #include <sstmac/software/threading/threading_interface_fwd.h>
 
 #include <vector>
@@ -235,7 +236,7 @@ class EventManager
   Timestamp minEventTime() const {
     return event_queue_.empty()
           ? no_events_left_time
-          : (*event_queue_.begin())->time();
+          : event_queue_.top()->time();
   }
 
   void setComponentManager(uint32_t comp_id, int thread){
@@ -291,25 +292,19 @@ class EventManager
 
   void finalizeStatsInit();
 
+  /**
+   * @brief writeMeasuredPartition If partition_measure_file was given,
+   * reduce the per-switch event counts across all threads and ranks
+   * and write a rebalanced partition usable by partition = file.
+   * Collective across ranks, must be called from the main thread.
+   */
+  void writeMeasuredPartition();
+
   void scheduleIncoming(IpcEvent* iev);
 
   int serializeSchedule(char* buf);
 
-  struct EventCompare {
-    bool operator()(ExecutionEvent* lhs, ExecutionEvent* rhs) const {
-      bool neq = lhs->time() != rhs->time();
-      if (neq) return lhs->time() < rhs->time();
-
-      if (lhs->linkId() == rhs->linkId()){
-        return lhs->seqnum() < rhs->seqnum();
-      } else {
-        return lhs->linkId() < rhs->linkId();
-      }
-    }
-  };
-  using queue_t = std::set<ExecutionEvent*, EventCompare,
-                    sprockit::allocator<ExecutionEvent*>> ;
-  queue_t event_queue_;
+  EventQueue event_queue_;
 
   StatisticOutput* dflt_stat_output_;
 
@@ -319,6 +314,13 @@ class EventManager
 
   std::unordered_map<uint32_t,int> component_to_thread_;
 
+  std::string partition_measure_file_;
+
+  /** Maps event link ids to the switch that owns them, nullptr if not measuring */
+  const std::vector<int>* link_to_switch_;
+
+  std::vector<uint64_t> switch_load_;
+
 };
 
 class NullEventManager : public EventManager
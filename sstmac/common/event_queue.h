@@ -0,0 +1,199 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#ifndef SSTMAC_COMMON_EVENT_QUEUE_H_INCLUDED
+#define SSTMAC_COMMON_EVENT_QUEUE_H_INCLUDED
+
+#include <sstmac/common/sst_event.h>
+#include <sstmac/common/ladder_queue.h>
+#include <sprockit/allocator.h>
+#include <sprockit/errors.h>
+#include <set>
+#include <string>
+#include <cstdio>
+
+namespace sstmac {
+
+struct EventCompare {
+  bool operator()(ExecutionEvent* lhs, ExecutionEvent* rhs) const {
+    bool neq = lhs->time() != rhs->time();
+    if (neq) return lhs->time() < rhs->time();
+
+    if (lhs->linkId() == rhs->linkId()){
+      return lhs->seqnum() < rhs->seqnum();
+    } else {
+      return lhs->linkId() < rhs->linkId();
+    }
+  }
+
+  /** Timestamp epochs are never carried into (carry_bits_mask is zero), so ticks alone order events */
+  static uint64_t ticks(ExecutionEvent* ev) {
+    return ev->time().time.ticks();
+  }
+};
+
+/**
+ * One schedule or pop operation on an event queue, as recorded by
+ * EventQueue::recordTrace and replayed by benchmarks/event_queue
+ */
+struct EventQueueTraceRecord {
+  enum op_t : uint32_t { push=0, pop=1 };
+  uint32_t op;
+  uint32_t linkId;
+  uint32_t seqnum;
+  uint32_t padding;
+  uint64_t ticks;
+};
+
+/**
+ * @brief The EventQueue class
+ * Time-ordered queue of pending events for an EventManager.
+ * The red-black tree is the historical default. The ladder queue gives
+ * amortized O(1) schedule/pop for large event populations and pops events
+ * in exactly the same (time, linkId, seqnum) order.
+ */
+class EventQueue
+{
+ public:
+  enum type_t {
+    rb_tree,
+    ladder
+  };
+
+  EventQueue() :
+    type_(rb_tree),
+    trace_(nullptr)
+  {
+  }
+
+  ~EventQueue(){
+    if (trace_) fclose(trace_);
+  }
+
+  void setType(type_t ty){
+    type_ = ty;
+  }
+
+  type_t type() const {
+    return type_;
+  }
+
+  /**
+   * @brief recordTrace Dump every push/pop as a binary EventQueueTraceRecord
+   * @param fname
+   */
+  void recordTrace(const std::string& fname){
+    trace_ = fopen(fname.c_str(), "wb");
+    if (!trace_){
+      spkt_abort_printf("could not open event queue trace file %s", fname.c_str());
+    }
+  }
+
+  bool empty() const {
+    return type_ == ladder ? ladder_.empty() : set_.empty();
+  }
+
+  size_t size() const {
+    return type_ == ladder ? ladder_.size() : set_.size();
+  }
+
+  /**
+   * @return The next event to run, queue must not be empty
+   */
+  ExecutionEvent* top() const {
+    return type_ == ladder ? ladder_.top() : *set_.begin();
+  }
+
+  void pop(){
+    if (trace_) record(EventQueueTraceRecord::pop, top());
+    if (type_ == ladder){
+      ladder_.pop();
+    } else {
+      set_.erase(set_.begin());
+    }
+  }
+
+  void insert(ExecutionEvent* ev){
+    if (trace_) record(EventQueueTraceRecord::push, ev);
+    if (type_ == ladder){
+      ladder_.push(ev);
+    } else {
+      set_.insert(ev);
+    }
+  }
+
+  template <class Fxn>
+  void forEach(Fxn&& fxn) const {
+    if (type_ == ladder){
+      ladder_.forEach(fxn);
+    } else {
+      for (ExecutionEvent* ev : set_) fxn(ev);
+    }
+  }
+
+  void clear(){
+    ladder_.clear();
+    set_.clear();
+  }
+
+ private:
+  void record(EventQueueTraceRecord::op_t op, ExecutionEvent* ev){
+    EventQueueTraceRecord rec;
+    rec.op = op;
+    rec.linkId = ev->linkId();
+    rec.seqnum = ev->seqnum();
+    rec.padding = 0;
+    rec.ticks = EventCompare::ticks(ev);
+    fwrite(&rec, sizeof(rec), 1, trace_);
+  }
+
+  type_t type_;
+  std::set<ExecutionEvent*, EventCompare, sprockit::allocator<ExecutionEvent*>> set_;
+  LadderQueue<ExecutionEvent*, EventCompare> ladder_;
+  FILE* trace_;
+};
+
+}
+
+#endif
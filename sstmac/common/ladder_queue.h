@@ -0,0 +1,275 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#ifndef SSTMAC_COMMON_LADDER_QUEUE_H_INCLUDED
+#define SSTMAC_COMMON_LADDER_QUEUE_H_INCLUDED
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+
+namespace sstmac {
+
+/**
+ * @brief The LadderQueue class
+ * A priority queue for discrete event scheduling based on the ladder queue
+ * of Tang, Goh, and Thng (ACM TOMACS 2005). Events far in the future sit in an
+ * unsorted top list, are spread into calendar buckets (rungs) of
+ * progressively finer width as simulation time approaches, and only the
+ * handful of events in the current bucket are kept in a (small) binary heap.
+ * Schedule and pop are amortized O(1) instead of the O(log n) of a tree.
+ *
+ * Buckets are keyed only on the integer tick of an event. All events sharing a tick
+ * always land in the same bucket, so the final order is entirely decided by
+ * Compare and is identical to a std::set<T,Compare>.
+ *
+ * Compare must provide bool operator()(T,T) (strict weak ordering, smallest first)
+ * and a static uint64_t ticks(T) consistent with that ordering.
+ */
+template <class T, class Compare>
+class LadderQueue
+{
+ public:
+  using tick_t = uint64_t;
+
+  LadderQueue() :
+    size_(0),
+    topBoundary_(0),
+    topMin_(0),
+    topMax_(0),
+    nrungs_(0),
+    rungs_(max_rungs)
+  {
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  /**
+   * @return The smallest element, queue must not be empty
+   */
+  T top() const {
+    return bottom_.front();
+  }
+
+  void push(T t){
+    tick_t ticks = Compare::ticks(t);
+    if (size_ == 0){
+      //restart the ladder from scratch
+      nrungs_ = 0;
+      topBoundary_ = ticks;
+      ++size_;
+      bottom_.push_back(t);
+      return;
+    }
+
+    ++size_;
+    if (ticks > topBoundary_){
+      if (top_.empty()){
+        topMin_ = topMax_ = ticks;
+      } else {
+        topMin_ = std::min(topMin_, ticks);
+        topMax_ = std::max(topMax_, ticks);
+      }
+      top_.push_back(t);
+      return;
+    }
+
+    for (int r=0; r < nrungs_; ++r){
+      Rung& rung = rungs_[r];
+      if (ticks >= rung.start){
+        tick_t idx = (ticks - rung.start) / rung.width;
+        if (idx >= rung.current){
+          rung.buckets[idx].push_back(t);
+          return;
+        }
+      }
+    }
+
+    bottom_.push_back(t);
+    std::push_heap(bottom_.begin(), bottom_.end(), greater_);
+  }
+
+  void pop(){
+    std::pop_heap(bottom_.begin(), bottom_.end(), greater_);
+    bottom_.pop_back();
+    --size_;
+    if (bottom_.empty() && size_ > 0){
+      refill();
+    }
+  }
+
+  /**
+   * @brief forEach Visit every element in no particular order
+   */
+  template <class Fxn>
+  void forEach(Fxn&& fxn) const {
+    for (T t : bottom_) fxn(t);
+    for (T t : top_) fxn(t);
+    for (int r=0; r < nrungs_; ++r){
+      for (auto& bucket : rungs_[r].buckets){
+        for (T t : bucket) fxn(t);
+      }
+    }
+  }
+
+  void clear(){
+    bottom_.clear();
+    top_.clear();
+    for (auto& rung : rungs_){
+      for (auto& bucket : rung.buckets){
+        bucket.clear();
+      }
+    }
+    nrungs_ = 0;
+    size_ = 0;
+  }
+
+ private:
+  /** Beyond this many events, a bucket is spread into a finer rung instead of heaped */
+  static constexpr size_t bottom_threshold = 50;
+  static constexpr int max_rungs = 8;
+  static constexpr size_t max_buckets = 1 << 15;
+
+  struct Rung {
+    tick_t start;
+    tick_t width;
+    /** Buckets below current have already been consumed */
+    size_t current;
+    size_t nbuckets;
+    std::vector<std::vector<T>> buckets;
+  };
+
+  struct Greater {
+    bool operator()(T lhs, T rhs) const {
+      return Compare()(rhs, lhs);
+    }
+  };
+
+  /**
+   * @brief spawnRung Spread events into a new rung covering [min,max]
+   * @return The last tick (inclusive) covered by the new rung
+   */
+  tick_t spawnRung(std::vector<T>& events, tick_t min, tick_t max){
+    Rung& rung = rungs_[nrungs_++];
+    tick_t range = max - min;
+    tick_t width = std::max(range / events.size(), range / max_buckets) + 1;
+    rung.start = min;
+    rung.width = width;
+    rung.current = 0;
+    rung.nbuckets = range / width + 1;
+    if (rung.buckets.size() < rung.nbuckets){
+      rung.buckets.resize(rung.nbuckets);
+    }
+    for (T t : events){
+      rung.buckets[(Compare::ticks(t) - min) / width].push_back(t);
+    }
+    events.clear();
+
+    return lastTick(min + (rung.nbuckets - 1) * width, width);
+  }
+
+  static tick_t lastTick(tick_t bucketStart, tick_t width){
+    tick_t maxTick = std::numeric_limits<tick_t>::max();
+    return (maxTick - bucketStart) < (width - 1) ? maxTick : bucketStart + (width - 1);
+  }
+
+  void refill(){
+    while (true){
+      if (nrungs_ == 0){
+        topBoundary_ = spawnRung(top_, topMin_, topMax_);
+        continue;
+      }
+
+      Rung& rung = rungs_[nrungs_-1];
+      while (rung.current < rung.nbuckets && rung.buckets[rung.current].empty()){
+        ++rung.current;
+      }
+      if (rung.current == rung.nbuckets){
+        --nrungs_;
+        continue;
+      }
+
+      std::vector<T>& bucket = rung.buckets[rung.current];
+      tick_t bucketStart = rung.start + rung.current * rung.width;
+      ++rung.current;
+      if (bucket.size() > bottom_threshold && rung.width > 1 && nrungs_ < max_rungs){
+        tick_t min = std::numeric_limits<tick_t>::max();
+        for (T t : bucket){
+          min = std::min(min, Compare::ticks(t));
+        }
+        //the new rung must cover the remainder of the bucket for future pushes
+        spawnRung(bucket, min, lastTick(bucketStart, rung.width));
+      } else {
+        //bottom is empty - swapping recycles its storage for the bucket
+        bottom_.swap(bucket);
+        std::make_heap(bottom_.begin(), bottom_.end(), greater_);
+        return;
+      }
+    }
+  }
+
+  size_t size_;
+  /** Events strictly after this tick go into the unsorted top list */
+  tick_t topBoundary_;
+  tick_t topMin_;
+  tick_t topMax_;
+  std::vector<T> top_;
+  int nrungs_;
+  std::vector<Rung> rungs_;
+  /** Binary heap (smallest first) of the events in the current bucket */
+  std::vector<T> bottom_;
+  Greater greater_;
+};
+
+}
+
+#endif
@@ -0,0 +1,476 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#include <sstmac/common/stats/stat_binary.h>
+#include <sprockit/sim_parameters.h>
+#include <sprockit/errors.h>
+#include <sprockit/keyword_registration.h>
+
+#if !SSTMAC_INTEGRATED_SST_CORE
+
+RegisterKeywords(
+{ "block_rows", "the number of rows buffered before a binary stats block is handed to the writer" },
+{ "max_blocks", "the number of binary stats blocks that can be filled or waiting on the writer at once" },
+);
+
+namespace sstmac {
+
+static const char stat_binary_magic[] = "SSTMSTAT";
+static const uint32_t stat_binary_byte_order = 0x01020304;
+static const uint32_t stat_binary_version = 2;
+static const uint32_t stat_binary_schema = 0xFFFFFFFF;
+
+static int
+statTypeSize(int type)
+{
+  switch (type){
+    case StatisticFieldsOutput::INT32:
+    case StatisticFieldsOutput::UINT32:
+    case StatisticFieldsOutput::FLOAT:
+      return 4;
+    case StatisticFieldsOutput::INT64:
+    case StatisticFieldsOutput::UINT64:
+    case StatisticFieldsOutput::DOUBLE:
+      return 8;
+    default:
+      spkt_abort_printf("invalid binary stats column type %d", type);
+      return 0;
+  }
+}
+
+void
+StatBinaryBlock::allocate(const std::vector<int>& col_types, int max_rows)
+{
+  types = col_types;
+  names.resize(max_rows);
+  components.resize(max_rows);
+  values.resize(types.size());
+  valid.resize(types.size());
+  for (size_t i=0; i < types.size(); ++i){
+    values[i].resize(max_rows * statTypeSize(types[i]));
+    //the bitmaps must start cleared, even when reusing a block
+    valid[i].assign((max_rows + 7) / 8, 0);
+  }
+}
+
+void
+StatBinaryBlock::clear()
+{
+  int nbytes = (nrows + 7) / 8;
+  for (auto& bits : valid){
+    ::memset(bits.data(), 0, nbytes);
+  }
+  new_strings.clear();
+  new_columns.clear();
+  nrows = 0;
+}
+
+StatOutputBinary::StatOutputBinary(SST::Params& params) :
+  StatisticFieldsOutput(params),
+  num_blocks_(0),
+  row_(0),
+  active_(nullptr),
+  writing_(false),
+  done_(false)
+{
+  block_rows_ = params.find<int>("block_rows", 4096);
+  if (block_rows_ <= 0){
+    spkt_abort_printf("binary stats block_rows must be positive, got %d", block_rows_);
+  }
+  max_blocks_ = params.find<int>("max_blocks", 8);
+  if (max_blocks_ < 2){
+    spkt_abort_printf("binary stats max_blocks must be at least 2, got %d", max_blocks_);
+  }
+}
+
+StatOutputBinary::~StatOutputBinary()
+{
+  if (writer_.joinable()){
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      done_ = true;
+    }
+    full_cv_.notify_one();
+    writer_.join();
+  }
+  delete active_;
+  for (auto* block : free_) delete block;
+}
+
+void
+StatOutputBinary::startOutputGroup(StatisticGroup *grp)
+{
+  if (grp->columns.empty()) return;
+
+  if (!out_.is_open()){
+    std::string fname = grp->name + ".bin";
+    out_.open(fname, std::ios::binary);
+    if (!out_.good()){
+      spkt_abort_printf("could not open binary stats file %s", fname.c_str());
+    }
+    out_.write(stat_binary_magic, 8);
+    out_.write((const char*)&stat_binary_byte_order, sizeof(uint32_t));
+    out_.write((const char*)&stat_binary_version, sizeof(uint32_t));
+    writer_ = std::thread(&StatOutputBinary::runWriter, this);
+  }
+
+  std::vector<std::string> columns;
+  std::vector<int> types;
+  for (auto& pair : grp->columns){
+    columns.push_back(pair.second);
+    types.push_back(grp->columnTypes[pair.first]);
+  }
+  bool new_schema = columns != columns_ || types != types_;
+  if (new_schema){
+    columns_ = std::move(columns);
+    types_ = std::move(types);
+    widths_.clear();
+    for (int type : types_){
+      widths_.push_back(statTypeSize(type));
+    }
+  }
+
+  active_ = nextBlock();
+  if (new_schema){
+    active_->new_columns = columns_;
+  }
+}
+
+void
+StatOutputBinary::startOutputEntries(StatisticBase *stat)
+{
+  row_ = active_->nrows;
+  active_->names[row_] = stringId(stat->getStatName());
+  active_->components[row_] = stringId(stat->getStatSubId());
+}
+
+void
+StatOutputBinary::stopOutputEntries()
+{
+  active_->nrows++;
+  if (active_->nrows == block_rows_){
+    submit();
+    active_ = nextBlock();
+  }
+}
+
+void
+StatOutputBinary::stopOutputGroup()
+{
+  if (!active_) return;
+
+  if (active_->nrows > 0 || !active_->new_columns.empty()){
+    submit();
+  } else {
+    std::lock_guard<std::mutex> guard(lock_);
+    free_.push_back(active_);
+  }
+  active_ = nullptr;
+
+  //the dump is complete once the writer has caught up
+  std::unique_lock<std::mutex> lock(lock_);
+  free_cv_.wait(lock, [this]{ return full_.empty() && !writing_; });
+  out_.flush();
+}
+
+uint32_t
+StatOutputBinary::stringId(const std::string &str)
+{
+  auto iter = strings_.find(str);
+  if (iter != strings_.end()){
+    return iter->second;
+  }
+  uint32_t id = strings_.size();
+  strings_[str] = id;
+  active_->new_strings.push_back(str);
+  return id;
+}
+
+StatBinaryBlock*
+StatOutputBinary::nextBlock()
+{
+  StatBinaryBlock* block = nullptr;
+  {
+    std::unique_lock<std::mutex> lock(lock_);
+    if (free_.empty() && num_blocks_ == max_blocks_){
+      //bound the memory held by a writer that cannot keep up
+      free_cv_.wait(lock, [this]{ return !free_.empty(); });
+    }
+    if (!free_.empty()){
+      block = free_.back();
+      free_.pop_back();
+    }
+  }
+
+  if (!block){
+    block = new StatBinaryBlock;
+    ++num_blocks_;
+    block->allocate(types_, block_rows_);
+  } else if (block->types != types_){
+    block->allocate(types_, block_rows_);
+  }
+  return block;
+}
+
+void
+StatOutputBinary::submit()
+{
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    full_.push_back(active_);
+  }
+  full_cv_.notify_one();
+}
+
+void
+StatOutputBinary::runWriter()
+{
+  std::unique_lock<std::mutex> lock(lock_);
+  while (true){
+    full_cv_.wait(lock, [this]{ return done_ || !full_.empty(); });
+    if (full_.empty()){
+      return;
+    }
+    StatBinaryBlock* block = full_.front();
+    full_.pop_front();
+    writing_ = true;
+    lock.unlock();
+    writeBlock(*block);
+    block->clear();
+    lock.lock();
+    writing_ = false;
+    free_.push_back(block);
+    free_cv_.notify_one();
+  }
+}
+
+void
+StatOutputBinary::writeBlock(const StatBinaryBlock &block)
+{
+  if (!block.new_columns.empty()){
+    uint32_t ncols = block.new_columns.size();
+    out_.write((const char*)&stat_binary_schema, sizeof(uint32_t));
+    out_.write((const char*)&ncols, sizeof(uint32_t));
+    for (uint32_t i=0; i < ncols; ++i){
+      uint8_t type = block.types[i];
+      uint32_t len = block.new_columns[i].size();
+      out_.write((const char*)&type, sizeof(uint8_t));
+      out_.write((const char*)&len, sizeof(uint32_t));
+      out_.write(block.new_columns[i].data(), len);
+    }
+  }
+  if (block.nrows == 0) return;
+
+  uint32_t nrows = block.nrows;
+  uint32_t nstrings = block.new_strings.size();
+  out_.write((const char*)&nrows, sizeof(uint32_t));
+  out_.write((const char*)&nstrings, sizeof(uint32_t));
+  for (auto& str : block.new_strings){
+    uint32_t len = str.size();
+    out_.write((const char*)&len, sizeof(uint32_t));
+    out_.write(str.data(), len);
+  }
+  out_.write((const char*)block.names.data(), nrows * sizeof(uint32_t));
+  out_.write((const char*)block.components.data(), nrows * sizeof(uint32_t));
+  for (size_t i=0; i < block.types.size(); ++i){
+    int width = statTypeSize(block.types[i]);
+    out_.write((const char*)block.valid[i].data(), (nrows + 7) / 8);
+    out_.write(block.values[i].data(), nrows * width);
+  }
+}
+
+StatBinaryReader::StatBinaryReader(const std::string &fname) :
+  in_(fname, std::ios::binary),
+  fname_(fname)
+{
+  if (!in_.good()){
+    spkt_abort_printf("could not open binary stats file %s", fname.c_str());
+  }
+  char magic[8];
+  in_.read(magic, 8);
+  uint32_t order;
+  read(order);
+  read(version_);
+  if (!in_ || ::memcmp(magic, stat_binary_magic, 8) != 0){
+    spkt_abort_printf("%s is not a binary stats file", fname.c_str());
+  }
+  if (order != stat_binary_byte_order){
+    spkt_abort_printf("%s was written with a different byte order", fname.c_str());
+  }
+  if (version_ == 1){
+    readSchema();
+  } else if (version_ != stat_binary_version){
+    spkt_abort_printf("%s has binary stats version %u, expected at most %u",
+                      fname.c_str(), version_, stat_binary_version);
+  }
+}
+
+void
+StatBinaryReader::readSchema()
+{
+  uint32_t ncols;
+  read(ncols);
+  columns_.clear();
+  types_.clear();
+  for (uint32_t i=0; i < ncols; ++i){
+    uint8_t type;
+    read(type);
+    statTypeSize(type); //validate
+    types_.push_back(type);
+    columns_.push_back(readString());
+  }
+  if (!in_){
+    spkt_abort_printf("binary stats file %s is truncated", fname_.c_str());
+  }
+}
+
+std::string
+StatBinaryReader::readString()
+{
+  uint32_t len;
+  read(len);
+  std::string str(len, '\0');
+  in_.read(&str[0], len);
+  return str;
+}
+
+bool
+StatBinaryReader::nextBlock(StatBinaryBlock &block)
+{
+  block.new_columns.clear();
+  uint32_t nrows;
+  read(nrows);
+  while (in_ && nrows == stat_binary_schema){
+    readSchema();
+    block.new_columns = columns_;
+    read(nrows);
+  }
+  if (!in_) return false;
+
+  uint32_t nstrings;
+  read(nstrings);
+  block.new_strings.clear();
+  for (uint32_t i=0; i < nstrings; ++i){
+    block.new_strings.push_back(readString());
+    strings_.push_back(block.new_strings.back());
+  }
+  block.allocate(types_, nrows);
+  block.nrows = nrows;
+  in_.read((char*)block.names.data(), nrows * sizeof(uint32_t));
+  in_.read((char*)block.components.data(), nrows * sizeof(uint32_t));
+  for (size_t i=0; i < types_.size(); ++i){
+    in_.read((char*)block.valid[i].data(), block.valid[i].size());
+    in_.read(block.values[i].data(), block.values[i].size());
+  }
+  if (!in_){
+    spkt_abort_printf("binary stats file %s is truncated", fname_.c_str());
+  }
+  for (uint32_t r=0; r < nrows; ++r){
+    if (block.names[r] >= strings_.size() || block.components[r] >= strings_.size()){
+      spkt_abort_printf("binary stats file %s has an invalid string id", fname_.c_str());
+    }
+  }
+  return true;
+}
+
+template <class T> static void
+printColumn(std::ostream& os, const std::vector<char>& values, int row)
+{
+  T t;
+  ::memcpy(&t, values.data() + row * sizeof(T), sizeof(T));
+  os << t;
+}
+
+void
+StatBinaryReader::printValue(std::ostream &os, const StatBinaryBlock &block, int col, int row) const
+{
+  const std::vector<char>& values = block.values[col];
+  switch (types_[col]){
+    case StatisticFieldsOutput::INT32:  printColumn<int32_t>(os, values, row); break;
+    case StatisticFieldsOutput::UINT32: printColumn<uint32_t>(os, values, row); break;
+    case StatisticFieldsOutput::INT64:  printColumn<int64_t>(os, values, row); break;
+    case StatisticFieldsOutput::UINT64: printColumn<uint64_t>(os, values, row); break;
+    case StatisticFieldsOutput::FLOAT:  printColumn<float>(os, values, row); break;
+    case StatisticFieldsOutput::DOUBLE: printColumn<double>(os, values, row); break;
+  }
+}
+
+void
+StatBinaryReader::toCsv(std::ostream &os)
+{
+  bool first_header = true;
+  auto printHeader = [&]{
+    if (!first_header) os << "\n";
+    first_header = false;
+    os << "name,component";
+    for (auto& col : columns_){
+      os << "," << col;
+    }
+  };
+
+  //version 1 files only have the header schema
+  if (version_ == 1) printHeader();
+
+  StatBinaryBlock block;
+  while (nextBlock(block)){
+    if (!block.new_columns.empty()) printHeader();
+    int ncols = columns_.size();
+    for (int r=0; r < block.nrows; ++r){
+      os << "\n" << strings_[block.names[r]] << "," << strings_[block.components[r]];
+      //like the csv output, a row stops after its last field
+      int last = ncols - 1;
+      while (last >= 0 && !block.isValid(last, r)) --last;
+      for (int c=0; c <= last; ++c){
+        os << ",";
+        if (block.isValid(c, r)){
+          printValue(os, block, c, r);
+        }
+      }
+    }
+  }
+}
+
+}
+
+#endif
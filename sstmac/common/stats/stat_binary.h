@@ -0,0 +1,260 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#ifndef SSTMAC_COMMON_STATS_STAT_BINARY_H_INCLUDED
+#define SSTMAC_COMMON_STATS_STAT_BINARY_H_INCLUDED
+
+#include <sstmac/common/stats/stat_collector.h>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if !SSTMAC_INTEGRATED_SST_CORE
+namespace sstmac {
+
+/**
+ * Layout of a binary statistics file, all integers in host byte order:
+ *   header: magic "SSTMSTAT", uint32 byte order mark, uint32 version
+ *   then records, each starting with a uint32 nrows:
+ *   schema: nrows is stat_binary_schema, followed by uint32 ncolumns and per
+ *           column a uint8 type and a string. Blocks use the columns of the
+ *           last schema before them, so groups with different columns can
+ *           share a file
+ *   blocks: uint32 nrows, uint32 nstrings followed by that many strings
+ *           added to the string table, uint32 name ids[nrows],
+ *           uint32 component ids[nrows], then per column a validity
+ *           bitmap of (nrows+7)/8 bytes and nrows packed values
+ * Strings are a uint32 length followed by the characters.
+ * Version 1 files have a single schema inside the header, after the version.
+ */
+struct StatBinaryBlock {
+  int nrows;
+  /** The column types the values are packed with */
+  std::vector<int> types;
+  /** Nonempty if the columns changed starting with this block */
+  std::vector<std::string> new_columns;
+  std::vector<std::string> new_strings;
+  std::vector<uint32_t> names;
+  std::vector<uint32_t> components;
+  std::vector<std::vector<char>> values;
+  std::vector<std::vector<uint8_t>> valid;
+
+  StatBinaryBlock() : nrows(0) {}
+
+  void allocate(const std::vector<int>& types, int max_rows);
+
+  bool isValid(int col, int row) const {
+    return valid[col][row/8] & (1 << (row%8));
+  }
+
+  void clear();
+};
+
+/**
+ * Writes every statistic in a group as one row of typed columns into
+ * <group>.bin. Rows are packed into preallocated blocks on the simulation
+ * thread, and full blocks are written out by a background writer thread
+ * that lives as long as the output. At most max_blocks blocks exist, so the
+ * simulation thread waits on the writer rather than buffering without bound.
+ */
+class StatOutputBinary : public StatisticFieldsOutput {
+ public:
+  SST_ELI_REGISTER_DERIVED(
+      StatisticOutput,
+      StatOutputBinary,
+      "macro",
+      "binary",
+      SST_ELI_ELEMENT_VERSION(1,0,0),
+      "writes typed binary columns from a background thread")
+
+  StatOutputBinary(SST::Params& params);
+
+  ~StatOutputBinary() override;
+
+  void outputField(fieldHandle_t fieldHandle, int32_t data) override {
+    output(fieldHandle, data);
+  }
+
+  void outputField(fieldHandle_t fieldHandle, uint32_t data) override {
+    output(fieldHandle, data);
+  }
+
+  void outputField(fieldHandle_t fieldHandle, int64_t data) override {
+    output(fieldHandle, data);
+  }
+
+  void outputField(fieldHandle_t fieldHandle, uint64_t data) override {
+    output(fieldHandle, data);
+  }
+
+  void outputField(fieldHandle_t fieldHandle, float data) override {
+    output(fieldHandle, data);
+  }
+
+  void outputField(fieldHandle_t fieldHandle, double data) override {
+    output(fieldHandle, data);
+  }
+
+  void startOutputGroup(StatisticGroup* grp) override;
+
+  void startOutputEntries(StatisticBase *stat) override;
+
+  void stopOutputEntries() override;
+
+  void stopOutputGroup() override;
+
+  bool checkOutputParameters() override { return true; }
+  void startOfSimulation() override {}
+  void endOfSimulation() override {}
+  void printUsage() override {}
+
+ private:
+  template <class T> void output(fieldHandle_t handle, T data){
+    char* dst = active_->values[handle].data() + row_ * widths_[handle];
+    switch (types_[handle]){
+      case INT32:  store<int32_t>(dst, data); break;
+      case UINT32: store<uint32_t>(dst, data); break;
+      case INT64:  store<int64_t>(dst, data); break;
+      case UINT64: store<uint64_t>(dst, data); break;
+      case FLOAT:  store<float>(dst, data); break;
+      case DOUBLE: store<double>(dst, data); break;
+    }
+    active_->valid[handle][row_/8] |= 1 << (row_%8);
+  }
+
+  template <class Col, class T> static void store(char* dst, T data){
+    Col val = data;
+    ::memcpy(dst, &val, sizeof(Col));
+  }
+
+  uint32_t stringId(const std::string& str);
+
+  StatBinaryBlock* nextBlock();
+
+  void submit();
+
+  void runWriter();
+
+  void writeBlock(const StatBinaryBlock& block);
+
+  std::ofstream out_;
+  std::vector<std::string> columns_;
+  std::vector<int> types_;
+  std::vector<int> widths_;
+  std::unordered_map<std::string,uint32_t> strings_;
+  int block_rows_;
+  int max_blocks_;
+  int num_blocks_;
+  int row_;
+  StatBinaryBlock* active_;
+
+  std::thread writer_;
+  std::mutex lock_;
+  /** Signals the writer that a block is full or that the output is done */
+  std::condition_variable full_cv_;
+  /** Signals the simulation thread that the writer finished a block */
+  std::condition_variable free_cv_;
+  std::deque<StatBinaryBlock*> full_;
+  std::vector<StatBinaryBlock*> free_;
+  bool writing_;
+  bool done_;
+};
+
+/**
+ * Reads back a file written by StatOutputBinary one block at a time
+ */
+class StatBinaryReader {
+ public:
+  StatBinaryReader(const std::string& fname);
+
+  const std::vector<std::string>& columns() const {
+    return columns_;
+  }
+
+  const std::vector<int>& types() const {
+    return types_;
+  }
+
+  /**
+   * @return false once the end of the file is reached. If the columns changed
+   *         before the block, block.new_columns holds them and columns()
+   *         and types() are updated
+   */
+  bool nextBlock(StatBinaryBlock& block);
+
+  /**
+   * Writes the same layout as StatOutputCSV, leaving missing fields empty.
+   * A new header line starts wherever the columns change.
+   */
+  void toCsv(std::ostream& os);
+
+  void printValue(std::ostream& os, const StatBinaryBlock& block, int col, int row) const;
+
+ private:
+  std::string readString();
+
+  void readSchema();
+
+  template <class T> void read(T& t){
+    in_.read((char*)&t, sizeof(T));
+  }
+
+  std::ifstream in_;
+  std::string fname_;
+  std::vector<std::string> columns_;
+  std::vector<int> types_;
+  std::vector<std::string> strings_;
+  uint32_t version_;
+};
+
+}
+#endif
+
+#endif
@@ -68,7 +68,7 @@ StatisticBase::StatisticBase(MacroBaseComponent * /*parent*/, const std::string
 }
 
 StatisticFieldsOutput::fieldHandle_t
-StatisticFieldsOutput::implRegisterField(const char *fieldName)
+StatisticFieldsOutput::implRegisterField(const char *fieldName, fieldType_t type)
 {
   auto* grp = active_group_;
   auto iter = grp->ids.find(fieldName);
@@ -76,6 +76,7 @@ StatisticFieldsOutput::implRegisterField(const char *fieldName)
     int idx = grp->ids.size();
     grp->ids[fieldName] = idx;
     grp->columns[idx] = fieldName;
+    grp->columnTypes[idx] = type;
     return idx;
   } else {
     return iter->second;
@@ -64,6 +64,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/sst_core/integrated_component.h>
 
 #include <sstream>
+#include <type_traits>
 
 #if !SSTMAC_INTEGRATED_SST_CORE
 namespace sstmac {
@@ -148,6 +149,7 @@ struct StatisticGroup {
   std::string name;
   std::map<std::string,int> ids;
   std::map<int,std::string> columns;
+  std::map<int,int> columnTypes;
   StatisticGroup(const std::string& n) :
     output(nullptr), name(n)
   {}
@@ -168,8 +170,25 @@ class StatisticFieldsOutput : public StatisticOutput
  public:
   using fieldHandle_t = int;
 
+  enum fieldType_t {
+    INT32 = 0,
+    UINT32 = 1,
+    INT64 = 2,
+    UINT64 = 3,
+    FLOAT = 4,
+    DOUBLE = 5
+  };
+
+  template<typename T> static constexpr fieldType_t fieldType(){
+    return std::is_floating_point<T>::value
+        ? (sizeof(T) == sizeof(float) ? FLOAT : DOUBLE)
+        : (sizeof(T) <= sizeof(int32_t)
+           ? (std::is_signed<T>::value ? INT32 : UINT32)
+           : (std::is_signed<T>::value ? INT64 : UINT64));
+  }
+
   template<typename T> fieldHandle_t registerField(const char* fieldName){
-    return implRegisterField(fieldName);
+    return implRegisterField(fieldName, fieldType<T>());
   }
 
   virtual void startOutputEntries(StatisticBase* statistic){
@@ -196,7 +215,7 @@ class StatisticFieldsOutput : public StatisticOutput
   void registerStatistic(StatisticBase* stat) override;
 
  private:
-  fieldHandle_t implRegisterField(const char* fieldName);
+  fieldHandle_t implRegisterField(const char* fieldName, fieldType_t type);
 
   StatisticBase* active_stat_;
 
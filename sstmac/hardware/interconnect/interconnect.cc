@@ -167,6 +167,14 @@ Interconnect::Interconnect(SST::Params& params, SSTMAC_MAYBE_UNUSED EventManager
     linkId = connectSwitches(linkId, mgr, switch_params);
     linkId = connectEndpoints(linkId, mgr, nic_params, switch_params);
     configureInterconnectLookahead(params);
+    int nworkers = rt_->nproc() * rt_->nthread();
+    if (nworkers > 1 && rt_->me() == 0){
+      int num_links, max_per_worker;
+      int cut = partition_->countCut(top, num_links, max_per_worker);
+      cout0 << sprockit::sprintf("Partition cuts %d of %d switch links with at most %d of %d switches "
+                                 "per worker: predicted lookahead %10.6fus\n",
+                                 cut, num_links, max_per_worker, num_switches_, lookahead_.usec());
+    }
   } else {
     //lookahead is actually higher
     LogPSwitch* lsw = logp_switches_[0];
@@ -202,6 +210,17 @@ Interconnect::configureInterconnectLookahead(SST::Params& params)
   TimeDelta injection_latency = TimeDelta(inj_params.find<SST::UnitAlgebra>("latency").getValue().toDouble());
 
   lookahead_ = std::min(injection_latency, hop_latency);
+
+  //the links are built, so the shortest one crossing workers is the real lookahead
+  TimeDelta remote = EventLink::minRemoteLatency();
+  TimeDelta thread = EventLink::minThreadLatency();
+  if (remote.ticks() > 0 && thread.ticks() > 0){
+    lookahead_ = std::min(remote, thread);
+  } else if (remote.ticks() > 0){
+    lookahead_ = remote;
+  } else if (thread.ticks() > 0){
+    lookahead_ = thread;
+  }
 }
 #endif
 
@@ -250,6 +269,7 @@ Interconnect::connectEndpoints(uint64_t linkIdOffset,
 
     NetworkSwitch* injsw = switches_[i];
     NetworkSwitch* ejsw = switches_[i];
+    uint64_t firstLinkId = linkId;
 
     topology_->endpointsConnectedToInjectionSwitch(i, ports);
     for (Topology::InjectionPort& p : ports){
@@ -288,6 +308,7 @@ Interconnect::connectEndpoints(uint64_t linkIdOffset,
         linkId += 2;
       }
     }
+    tagLinks(firstLinkId, linkId, i);
   }
   return linkId;
 }
@@ -342,6 +363,7 @@ Interconnect::connectLogP(
     int target_rank = partition_->lpidForSwitch(sid);
     LogPSwitch* local_logp_switch = logp_switches_[target_thread];
     TimeDelta logp_link_latency = local_logp_switch->out_in_latency();
+    uint64_t firstLinkId = linkId;
 
     for (Topology::InjectionPort& conn : nodes){
       Node* nd = nodes_[conn.nid];
@@ -410,6 +432,7 @@ Interconnect::connectLogP(
         }
       }
     }
+    tagLinks(firstLinkId, linkId, sid);
   }
   return linkId;
 }
@@ -527,7 +550,7 @@ Interconnect::connectSwitches(uint64_t linkIdOffset, EventManager* mgr, SST::Par
   uint64_t linkId = linkIdOffset;
 
   SST::Params port_params = switch_params.get_namespace("link");
-  TimeDelta linkLatency(port_params.find<SST::UnitAlgebra>("latency").getValue().toDouble());
+  TimeDelta hopLatency(port_params.find<SST::UnitAlgebra>("latency").getValue().toDouble());
 
   for (int i=0; i < num_switches_; ++i){
     interconn_debug("interconnect: connecting switch %i", i);
@@ -538,6 +561,10 @@ Interconnect::connectSwitches(uint64_t linkIdOffset, EventManager* mgr, SST::Par
     for (Topology::Connection& conn : outports){
       int dst_rank = partition_->lpidForSwitch(conn.dst);
       int dst_thread = partition_->threadForSwitch(conn.dst);
+      TimeDelta linkLatency = hopLatency * topology_->portLatencyScaleFactor(src, conn.src_outport);
+      //the payload link delivers to dst, the credit link right after it delivers to src
+      tagLinks(linkId, linkId+1, conn.dst);
+      tagLinks(linkId+1, linkId+2, src);
 
       interconn_debug("%s connecting to %s on ports %d:%d",
                 topology_->switchLabel(src).c_str(),
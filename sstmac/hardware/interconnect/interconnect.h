@@ -163,7 +163,27 @@ class Interconnect
     return components_[id];
   }
 
+  /**
+   * @brief linkToSwitch
+   * Link IDs are numbered identically on every rank, so this map
+   * attributes the events on any link to the switch (and its attached endpoints)
+   * whose partition owns the receiving handler
+   * @return The switch for each link ID
+   */
+  const std::vector<int>& linkToSwitch() const {
+    return link_to_switch_;
+  }
+
  private:
+  void tagLinks(uint64_t first, uint64_t last, int sw){
+    if (link_to_switch_.size() < last){
+      link_to_switch_.resize(last, -1);
+    }
+    for (uint64_t id=first; id < last; ++id){
+      link_to_switch_[id] = sw;
+    }
+  }
+
   uint32_t switchComponentId(SwitchId sid) const;
 
   uint32_t nodeComponentId(NodeId nid) const;
@@ -223,6 +243,8 @@ class Interconnect
 
   Partition* partition_;
   ParallelRuntime* rt_;
+
+  std::vector<int> link_to_switch_;
 #endif
 };
 
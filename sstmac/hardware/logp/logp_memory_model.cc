@@ -79,6 +79,18 @@ LogPMemoryModel::accessFlow(uint64_t bytes, TimeDelta byte_request_delay, Callba
   parent_node_->sendDelayedExecutionEvent(delta_t, cb);
 }
 
+bool
+LogPMemoryModel::accessFlowTime(uint64_t bytes, TimeDelta byte_request_delay,
+                                Timestamp start, TimeDelta& delay)
+{
+  mem_debug("simple model: evaluating access of %ld bytes", bytes);
+
+  //flows evaluated ahead of time do not occupy the link,
+  //or flows from other threads would queue behind all of them
+  delay = link_->accessTime(start, bytes, byte_request_delay);
+  return true;
+}
+
 void
 LogPMemoryModel::accessRequest(int  /*linkId*/, Request * /*req*/)
 {
@@ -96,6 +108,15 @@ LogPMemoryModel::Link::newAccess(Timestamp now, uint64_t size, TimeDelta byte_re
   return delta;
 }
 
+TimeDelta
+LogPMemoryModel::Link::accessTime(Timestamp now, uint64_t size, TimeDelta byte_request_delay) const
+{
+  TimeDelta actual_byte_delay = byte_request_delay + byte_delay_;
+  Timestamp base = std::max(now, last_access_);
+  TimeDelta access = lat_ + actual_byte_delay * size;
+  return (base + access) - now;
+}
+
 
 
 }
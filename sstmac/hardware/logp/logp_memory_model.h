@@ -85,6 +85,8 @@ class LogPMemoryModel : public MemoryModel
 
   void accessFlow(uint64_t bytes, TimeDelta byte_delay, Callback* cb) override;
 
+  bool accessFlowTime(uint64_t bytes, TimeDelta byte_delay, Timestamp start, TimeDelta& delay) override;
+
   void accessRequest(int linkId, Request* req) override;
 
 
@@ -106,6 +108,15 @@ class LogPMemoryModel : public MemoryModel
      */
     TimeDelta newAccess(Timestamp now, uint64_t size, TimeDelta min_byte_delay);
 
+    /**
+     * @brief accessTime
+     * @param now
+     * @param size
+     * @param max_bw
+     * @return The deltaT from now an access would finish, without occupying the link
+     */
+    TimeDelta accessTime(Timestamp now, uint64_t size, TimeDelta min_byte_delay) const;
+
    protected:
     TimeDelta byte_delay_;
     TimeDelta lat_;
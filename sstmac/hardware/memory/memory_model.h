@@ -116,6 +116,21 @@ class MemoryModel : public SubComponent
    */
   virtual void accessFlow(uint64_t bytes, TimeDelta byte_request_delay, Callback* cb) = 0;
 
+  /**
+   * @brief accessFlowTime Evaluate an entire flow in one step without scheduling any events.
+   *        Models that track contention between flows cannot do this and return false.
+   *        Other flows do not queue behind a flow evaluated this way.
+   * @param bytes
+   * @param byte_request_delay
+   * @param start The time at which the flow would begin
+   * @param delay [out] How long after start the flow completes
+   * @return Whether the model could evaluate the flow analytically
+   */
+  virtual bool accessFlowTime(uint64_t /*bytes*/, TimeDelta /*byte_request_delay*/,
+                              Timestamp /*start*/, TimeDelta& /*delay*/){
+    return false;
+  }
+
   /**
    * @brief access Call for individal requests
    * @param linkId
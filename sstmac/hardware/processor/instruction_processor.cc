@@ -114,6 +114,24 @@ InstructionProcessor::compute(Event* ev, ExecutionEvent* cb)
   }
 }
 
+bool
+InstructionProcessor::computeTime(Event* ev, Timestamp start, TimeDelta& delay)
+{
+  sw::BasicComputeEvent* bev = test_cast(sw::BasicComputeEvent, ev);
+  if (!bev) return false;
+
+  sw::basic_instructions_st& st = bev->data();
+  TimeDelta instr_time = instructionTime(bev) / st.nthread;
+  uint64_t bytes = st.mem_sequential;
+  if (bytes <= negligible_bytes_) {
+    delay = instr_time;
+    return true;
+  } else {
+    TimeDelta byte_request_delay = instr_time / bytes;
+    return mem_->accessFlowTime(bytes, byte_request_delay, start, delay);
+  }
+}
+
 
 
 }
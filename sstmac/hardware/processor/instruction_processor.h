@@ -73,6 +73,8 @@ class InstructionProcessor :
 
   void compute(Event* ev, ExecutionEvent* cb) override;
 
+  bool computeTime(Event* ev, Timestamp start, TimeDelta& delay) override;
+
  protected:
   void setMemopDistribution(double stdev);
 
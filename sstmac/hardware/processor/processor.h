@@ -75,6 +75,17 @@ class Processor
 
   virtual void compute(Event* cev, ExecutionEvent* cb) = 0;
 
+  /**
+   * @brief computeTime Evaluate a compute request in one step without scheduling any events
+   * @param cev
+   * @param start The time at which the compute would begin
+   * @param delay [out] How long after start the compute completes
+   * @return Whether the model could evaluate the request analytically
+   */
+  virtual bool computeTime(Event* /*cev*/, Timestamp /*start*/, TimeDelta& /*delay*/){
+    return false;
+  }
+
   int ncores() const {
     return ncores_;
   }
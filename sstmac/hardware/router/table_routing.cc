@@ -48,10 +48,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sprockit/util.h>
 #include <sprockit/sim_parameters.h>
 #include <sprockit/keyword_registration.h>
-#include <sstmac/hardware/topology/file.h>
-#include <sstmac/libraries/nlohmann/json.hpp>
-#include <sstream>
-#include <fstream>
+#include <sstmac/hardware/topology/routing_table.h>
 
 
 namespace sstmac {
@@ -63,33 +60,6 @@ class TableRouter : public Router {
     uint8_t num_hops;
   };
 
-  struct Port {
-    Port(const nlohmann::json& pch) :
-      rotater(0)
-    {
-      for (auto p : pch.at("ports")){
-        ports.push_back(p);
-      }
-    }
-
-    Port(int port) :
-      ports(1, port),
-      rotater(0)
-    {
-    }
-
-    Port() : rotater(0), ports(0) {}
-
-    int nextPort(){
-      int ret = ports[rotater];
-      rotater = (rotater + 1) % ports.size();
-      return ret;
-    }
-
-    std::vector<int> ports;
-    int rotater;
-  };
-
  public:
   SST_ELI_REGISTER_DERIVED(
     Router,
@@ -101,43 +71,21 @@ class TableRouter : public Router {
 
   TableRouter(SST::Params& params, Topology* top, NetworkSwitch* sw) :
     Router(params, top, sw),
-    table_(top->numNodes()),
     num_vcs_(1)
   {
-
-    FileTopology* file_topo = dynamic_cast<FileTopology*>(top);
-    nlohmann::json port_channels;
-    if (file_topo){
-      try {
-        nlohmann::json switch_ports = file_topo->getSwitchJson(my_addr_);
-        auto pch_it = switch_ports.find("port_channels");
-        if (pch_it != switch_ports.end()){
-          port_channels = *pch_it;
-        }
-      } catch (nlohmann::detail::exception& e) {
-        spkt_abort_printf("failed getting switch JSON info in TableRouter for switch %d",
-                          int(addr()));
-      }
+    table_ = top->routingTable();
+    if (!table_){
+      spkt_abort_printf("table router on switch %d requires topology.routing_tables",
+                        int(addr()));
     }
-
-    nlohmann::json routes = top->getRoutingTable(my_addr_);
-    for (auto it = routes.begin(); it != routes.end(); ++it){
-      NodeId dest_nid = top->nodeNameToId(it.key());
-      if (it.value().is_number()){
-        //this is a single port
-        table_[dest_nid] = Port(int(it.value()));
-      } else {
-        std::string pch_name = it.value();
-        table_[dest_nid] = Port(port_channels.at(pch_name));
-      }
-    }
-
-
-    int size = table_.size();
-    for (int i=0; i < size; ++i){
-      if (table_[i].ports.size() == 0){
-        spkt_abort_printf("No port specified on switch %d to destination %d",
-                          my_addr_, i);
+    //round-robin state per destination, only needed if this switch has port channels
+    int num_local = table_->numLocalChannels(my_addr_);
+    for (int local=0; local < num_local; ++local){
+      int num_ports;
+      table_->ports(my_addr_, local, num_ports);
+      if (num_ports > 1){
+        rotaters_.resize(top->numNodes(), 0);
+        break;
       }
     }
 
@@ -157,7 +105,15 @@ class TableRouter : public Router {
   }
 
   void route(Packet *pkt) override {
-    int port = table_[pkt->toaddr()].nextPort();
+    int local = table_->localChannel(my_addr_, pkt->toaddr());
+    int num_ports;
+    const uint32_t* ports = table_->ports(my_addr_, local, num_ports);
+    int port = ports[0];
+    if (num_ports > 1){
+      uint16_t& rotater = rotaters_[pkt->toaddr()];
+      port = ports[rotater];
+      rotater = (rotater + 1) % num_ports;
+    }
     pkt->setEdgeOutport(port);
 
     auto* hdr = pkt->rtrHeader<header>();
@@ -173,7 +129,8 @@ class TableRouter : public Router {
   }
 
  private:
-  std::vector<Port> table_;
+  const CompactRoutingTable* table_;
+  std::vector<uint16_t> rotaters_;
   bool increment_vcs_;
   int num_vcs_;
 };
@@ -48,6 +48,7 @@ Questions? Contact sst-macro-help@sandia.gov
 
 #include <inttypes.h>
 #include <queue>
+#include <cstring>
 
 #include <sstmac/hardware/snappr/snappr.h>
 
@@ -70,10 +71,32 @@ SnapprPacket::SnapprPacket(
   offset_(offset),
   priority_(0),
   inport_(-1),
-  deadlocked_(false)
+  flow_mtu_(0),
+  deadlocked_(false),
+  credits_consumed_(true)
 {
 }
 
+SnapprPacket*
+SnapprPacket::splitFlow(uint64_t offset, uint32_t num_bytes) const
+{
+  bool is_tail = offset + num_bytes == byteLength();
+  SnapprPacket* pkt = new SnapprPacket(is_tail ? flow() : nullptr, num_bytes, is_tail,
+                                       flowId(), offset_ + offset, toaddr(), fromaddr(), qos());
+  //carry over any routing decisions already made for the flow
+  ::memcpy(pkt->rtrHeader<char>(), rtrHeader<char>(), MAX_HEADER_BYTES);
+  pkt->rtrHeader<Header>()->is_tail = is_tail;
+  pkt->seqnum_ = seqnum_;
+  pkt->arrival_ = arrival_;
+  pkt->congestion_delay_ = congestion_delay_;
+  pkt->vl_ = vl_;
+  pkt->priority_ = priority_;
+  pkt->inport_ = inport_;
+  pkt->input_vl_ = input_vl_;
+  pkt->credits_consumed_ = false;
+  return pkt;
+}
+
 std::string
 SnapprPacket::toString() const
 {
@@ -96,7 +119,9 @@ SnapprPacket::serialize_order(serializer& ser)
   ser & priority_;
   ser & inport_;
   ser & input_vl_;
+  ser & flow_mtu_;
   ser & deadlocked_;
+  ser & credits_consumed_;
 }
 
 std::string
@@ -170,6 +170,45 @@ class SnapprPacket :
     inport_ = port;
   }
 
+  /**
+   * In hybrid mode, a flow packet carries an entire message across
+   * idle ports as a single event. The first busy port splits it
+   * into packets of size flowMtu() that are simulated normally.
+   */
+  bool isFlow() const {
+    return flow_mtu_ != 0;
+  }
+
+  uint32_t flowMtu() const {
+    return flow_mtu_;
+  }
+
+  void setFlowMtu(uint32_t mtu){
+    flow_mtu_ = mtu;
+  }
+
+  /**
+   * @return Whether the sender consumed credits for this packet
+   *         and expects them to be returned. Flows and packets split
+   *         from a flow did not consume credits at the previous hop.
+   */
+  bool creditsConsumed() const {
+    return credits_consumed_;
+  }
+
+  void setCreditsConsumed(bool flag){
+    credits_consumed_ = flag;
+  }
+
+  /**
+   * Create a packet covering part of this flow. The packet inherits
+   * routing and queueing state, but only the packet at the end of the
+   * flow carries the message payload.
+   * @param offset The byte offset relative to the start of this flow
+   * @param num_bytes The size of the packet
+   */
+  SnapprPacket* splitFlow(uint64_t offset, uint32_t num_bytes) const;
+
   void serialize_order(serializer& ser) override;
 
  private:
@@ -191,8 +230,12 @@ class SnapprPacket :
 
   int input_vl_;
 
+  uint32_t flow_mtu_;
+
   bool deadlocked_;
 
+  bool credits_consumed_;
+
 };
 
 /**
@@ -146,6 +146,10 @@ SnapprNIC::SnapprNIC(uint32_t id, SST::Params& params, Node* parent) :
 
   buffer_remaining_ = params.find<SST::UnitAlgebra>("buffer", "4MB").getRoundedValue();
   ignore_memory_ = params.find<bool>("ignore_memory", true);
+  hybrid_ = params.find<bool>("hybrid", false);
+  if (hybrid_ && !ignore_memory_){
+    spkt_abort_printf("snappr NIC requires ignore_memory=true when hybrid=true");
+  }
 
   configureLinks();
 }
@@ -259,8 +263,15 @@ SnapprNIC::doSend(NetworkMessage* payload)
   nic_debug("snappr: sending %s", payload->toString().c_str());
 
   payload->setInjectionStarted(now());
-  inject_queue_->insert(0, payload);
-  copyToNicBuffer();
+  //an idle injection port with nothing else pending can send the whole
+  //message as a flow - any contention on the path falls back to packets
+  if (hybrid_ && inject_queue_->empty() && outports_[0]->flowReady()
+      && payload->byteLength() <= std::numeric_limits<uint32_t>::max()){
+    injectFlow(payload);
+  } else {
+    inject_queue_->insert(0, payload);
+    copyToNicBuffer();
+  }
 }
 
 void
@@ -307,7 +318,7 @@ SnapprNIC::eject(SnapprPacket* pkt)
   }
 
   sendExecutionEvent(ej_next_free_, qev);
-  if (flow_control_){
+  if (flow_control_ && pkt->creditsConsumed()){
     auto* credit = new SnapprCredit(pkt->byteLength(), pkt->virtualLane(), switch_outport_);
     pkt_debug("crediting with switch port %d:%d for %" PRIu64 " offset=%" PRIu64,
               switch_outport_, pkt->virtualLane(), pkt->flowId(), pkt->offset());
@@ -326,6 +337,13 @@ SnapprNIC::handlePayload(Event *ev)
 
 
   TimeDelta time_to_send = pkt->byteLength() * inj_byte_delay_;
+  if (pkt->isFlow()){
+    //packets split from this flow would each eject as they arrive,
+    //so the flow is only done once its last packet would have arrived
+    uint32_t tail_bytes = pkt->byteLength() % pkt->flowMtu();
+    if (tail_bytes == 0) tail_bytes = std::min(pkt->byteLength(), pkt->flowMtu());
+    time_to_send = tail_bytes * inj_byte_delay_;
+  }
   if (time_to_send < pkt->timeToSend()){
     pkt_debug("delaying packet ejection - time to arrive=%10.4e, time to inject=%10.4e: %s",
               pkt->timeToSend().sec(), time_to_send.sec(), pkt->toString().c_str());
@@ -367,12 +385,10 @@ SnapprNIC::handleTailPacket(Timestamp done, SnapprPacket* pkt)
   pkt->clearCongestionDelay();
 }
 
-void
-SnapprNIC::injectPacket(uint32_t  /*ptk_size*/, uint64_t byte_offset, NetworkMessage* payload)
+SnapprPacket*
+SnapprNIC::newPacket(uint32_t pkt_size, uint64_t byte_offset, NetworkMessage* payload)
 {
-  uint64_t bytes_left = payload->byteLength() - byte_offset;
-  uint32_t pkt_size = std::min(bytes_left, uint64_t(packet_size_));
-  bool is_tail = bytes_left == pkt_size;
+  bool is_tail = payload->byteLength() == byte_offset + pkt_size;
   NodeId to = payload->toaddr();
   NodeId from = payload->fromaddr();
   uint64_t fid = payload->flowId();
@@ -392,11 +408,30 @@ SnapprNIC::injectPacket(uint32_t  /*ptk_size*/, uint64_t byte_offset, NetworkMes
   } else {
     pkt->setVirtualLane(payload->qos());
   }
+  return pkt;
+}
 
+void
+SnapprNIC::injectPacket(uint32_t  /*ptk_size*/, uint64_t byte_offset, NetworkMessage* payload)
+{
+  uint64_t bytes_left = payload->byteLength() - byte_offset;
+  uint32_t pkt_size = std::min(bytes_left, uint64_t(packet_size_));
+  SnapprPacket* pkt = newPacket(pkt_size, byte_offset, payload);
   //no multi-rail or multi-injection for now
   outports_[0]->tryToSendPacket(pkt);
 }
 
+void
+SnapprNIC::injectFlow(NetworkMessage* payload)
+{
+  nic_debug("injecting flow of size=%" PRIu64 ": %s",
+            payload->byteLength(), payload->toString().c_str());
+  SnapprPacket* pkt = newPacket(payload->byteLength(), 0, payload);
+  pkt->setFlowMtu(packet_size_);
+  pkt->setCreditsConsumed(false);
+  outports_[0]->tryToSendPacket(pkt);
+}
+
 void
 SnapprNIC::handleMemoryResponse(MemoryModel::Request* req)
 {
@@ -140,6 +140,10 @@ class SnapprNIC :
 
   void injectPacket(uint32_t pkt_size, uint64_t byte_offset, NetworkMessage* payload);
 
+  void injectFlow(NetworkMessage* payload);
+
+  SnapprPacket* newPacket(uint32_t pkt_size, uint64_t byte_offset, NetworkMessage* payload);
+
   void handleMemoryResponse(MemoryModel::Request* req);
 
   EventLink::ptr credit_link_;
@@ -162,6 +166,7 @@ class SnapprNIC :
   MemoryModel* mem_model_;
   int mem_req_id_;
   bool ignore_memory_;
+  bool hybrid_;
 
   int qos_levels_;
   bool scatter_qos_;
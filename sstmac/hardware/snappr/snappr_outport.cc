@@ -106,6 +106,10 @@ SnapprOutPort::SnapprOutPort(uint32_t id, SST::Params& params,
   flit_overhead = flit_size * byte_delay;
 
   debug_qos_ = params.find<int>("debug_qos", -1);
+
+  //in hybrid mode, flows cross this port analytically as long as
+  //no more than this many bytes are still waiting to leave
+  flow_threshold_ = params.find<SST::UnitAlgebra>("flow_threshold", "0B").getRoundedValue();
 }
 
 void
@@ -194,10 +198,14 @@ SnapprOutPort::send(SnapprPacket* pkt, Timestamp now)
     auto* ev = newCallback(this, &SnapprOutPort::handleCredit, credit); //port doesn't matter
     parent_->sendExecutionEvent(next_free, ev);
   } else {
-    //actually send it
-    link->send(flit_overhead, pkt);
+    //flows never consume credits, but anything queued here did
+    bool return_credits = pkt->creditsConsumed();
+    pkt->setCreditsConsumed(!pkt->isFlow());
+    //actually send it - flows may be reserved to start after
+    //the bytes already in flight have left the port
+    link->send(flit_overhead + (now - parent_->now()), pkt);
     if (flow_control_){
-      if (inports){
+      if (inports && return_credits){
         auto& inport = inports[pkt->inport()];
         auto* credit = new SnapprCredit(pkt->byteLength(), pkt->inputVirtualLane(), inport.src_outport);
         pkt_debug("sending credit to port=%d on vl=%d at t=%8.4e: %s",
@@ -325,9 +333,56 @@ SnapprOutPort::logQueueDepth()
 #endif
 }
 
+bool
+SnapprOutPort::flowReady() const
+{
+  if (!empty()){
+    return false;
+  }
+  Timestamp now = parent_->now();
+  if (next_free <= now){
+    return true;
+  }
+  return (next_free - now) <= flow_threshold_ * byte_delay;
+}
+
+void
+SnapprOutPort::sendFlow(SnapprPacket* pkt)
+{
+  Timestamp now = parent_->now();
+  pkt->setArrival(now);
+  Timestamp start = next_free > now ? next_free : now;
+  pkt_debug("flow crossing port=%d vl=%d at t=%8.4e: %s",
+            number_, pkt->virtualLane(), start.sec(), pkt->toString().c_str());
+  send(pkt, start);
+}
+
+void
+SnapprOutPort::splitFlow(SnapprPacket* flow)
+{
+  pkt_debug("contention on port=%d with %d queued - splitting flow %s",
+            number_, queueLength(), flow->toString().c_str());
+  uint64_t offset = 0;
+  do {
+    uint32_t pkt_size = std::min(uint64_t(flow->flowMtu()), flow->byteLength() - offset);
+    tryToSendPacket(flow->splitFlow(offset, pkt_size));
+    offset += pkt_size;
+  } while (offset < flow->byteLength());
+  delete flow;
+}
+
 void
 SnapprOutPort::tryToSendPacket(SnapprPacket* pkt)
 {
+  if (pkt->isFlow() && congestion_){
+    if (flowReady()){
+      sendFlow(pkt);
+    } else {
+      splitFlow(pkt);
+    }
+    return;
+  }
+
   pkt_debug("trying to send payload %s on inport %d:%d going to port %d:%d:%d",
             pkt->toString().c_str(), pkt->inport(), pkt->inputVirtualLane(),
             pkt->nextPort(), pkt->virtualLane(), pkt->deadlockVC());
@@ -182,6 +182,13 @@ struct SnapprOutPort : public SubComponent {
 
   void tryToSendPacket(SnapprPacket* pkt);
 
+  /**
+   * @return Whether a flow arriving now can cross this port as a single
+   *         event, i.e. nothing is queued and the bytes still in flight
+   *         are within the flow threshold
+   */
+  bool flowReady() const;
+
   void setVirtualLanes(const std::vector<uint32_t>& credits){
     arb_->setVirtualLanes(credits);
   }
@@ -225,6 +232,10 @@ struct SnapprOutPort : public SubComponent {
 
   void send(SnapprPacket* pktr, Timestamp now);
 
+  void sendFlow(SnapprPacket* pkt);
+
+  void splitFlow(SnapprPacket* pkt);
+
   int debug_qos_;
   SnapprPortArbitrator* arb_;
   Component* parent_;
@@ -235,6 +246,7 @@ struct SnapprOutPort : public SubComponent {
   int number_;
   TailNotifier* notifier_;
   std::set<int> deadlocked_vls_;
+  uint32_t flow_threshold_;
 
 };
 
@@ -64,6 +64,7 @@ RegisterKeywords(
 { "h", "the number inter-group connections per router" },
 { "group_connections", "the number of inter-group connections per router"},
 { "inter_group", "the inter-group wiring scheme"},
+{ "global_link_latency_scale", "the multiple of the switch link latency for inter-group links"},
 );
 
 namespace sstmac {
@@ -98,6 +99,13 @@ Dragonfly::Dragonfly(SST::Params& params) :
 
   group_wiring_ = sprockit::create<InterGroupWiring>(
    "macro", params.find<std::string>("inter_group", "circulant"), params, a_, g_, h_);
+
+  //inter-group cables are usually much longer than those inside a group
+  global_latency_scale_ = params.find<double>("global_link_latency_scale", 1.0);
+  if (global_latency_scale_ <= 0){
+    spkt_abort_printf("dragonfly global_link_latency_scale=%f must be positive",
+                      global_latency_scale_);
+  }
 }
 
 void
@@ -223,6 +223,11 @@ class Dragonfly : public CartesianTopology
     return 3;
   }
 
+  double portLatencyScaleFactor(uint32_t  /*addr*/, int port) const override {
+    //ports a..a+h-1 are the inter-group links
+    return port >= a_ && port < a_ + h_ ? global_latency_scale_ : 1.0;
+  }
+
   void endpointsConnectedToInjectionSwitch(SwitchId swaddr,
          std::vector<InjectionPort>& nodes) const override;
 
@@ -259,6 +264,8 @@ class Dragonfly : public CartesianTopology
   double vtk_group_radians_;
   double vtk_switch_radians_;
 
+  double global_latency_scale_;
+
   InterGroupWiring* group_wiring_;
 
 };
@@ -0,0 +1,358 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#include <sstmac/hardware/topology/routing_table.h>
+#include <sstmac/hardware/topology/topology.h>
+#include <sstmac/hardware/topology/file.h>
+#include <sprockit/errors.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace sstmac {
+namespace hw {
+
+static const char routing_table_magic[8] = {'S','S','T','M','R','T','B','1'};
+
+/**
+ * Layout of the binary file, all native-endian. The header is followed by
+ *   uint32 node_switch[num_nodes]
+ *   uint32 channel_offsets[num_channels+1]
+ *   uint32 ports[num_ports]
+ *   uint32 local_offsets[num_switches+1]
+ *   uint32 local_channels[num_local]
+ *   uint32 exception_offsets[num_switches+1]
+ *   uint32 exceptions[2*num_exceptions]   (node, local channel) sorted by node
+ *   uint16 routes[num_switches*num_switches]
+ * This must be kept consistent with bin/tools/routing_table_convert.py
+ */
+struct RoutingTableHeader {
+  char magic[8];
+  uint32_t num_switches;
+  uint32_t num_nodes;
+  uint32_t num_channels;
+  uint32_t num_ports;
+  uint32_t num_local;
+  uint32_t num_exceptions;
+};
+
+static size_t
+tableSize(const RoutingTableHeader& hdr)
+{
+  size_t num_u32 = size_t(hdr.num_nodes)
+      + hdr.num_channels + 1
+      + hdr.num_ports
+      + hdr.num_switches + 1
+      + hdr.num_local
+      + hdr.num_switches + 1
+      + 2*size_t(hdr.num_exceptions);
+  return sizeof(RoutingTableHeader) + num_u32*sizeof(uint32_t)
+      + size_t(hdr.num_switches)*hdr.num_switches*sizeof(uint16_t);
+}
+
+bool
+CompactRoutingTable::isBinaryFile(const std::string& fname)
+{
+  std::ifstream in(fname, std::ios::binary);
+  char magic[sizeof(routing_table_magic)];
+  if (!in.read(magic, sizeof(magic))) return false;
+  return ::memcmp(magic, routing_table_magic, sizeof(magic)) == 0;
+}
+
+void
+CompactRoutingTable::setPointers(const char* data, bool check)
+{
+  RoutingTableHeader hdr;
+  ::memcpy(&hdr, data, sizeof(hdr));
+  if (check && tableSize(hdr) != mapping_size_){
+    spkt_abort_printf("binary routing table has size %lu, but its header implies %lu",
+                      mapping_size_, tableSize(hdr));
+  }
+
+  num_switches_ = hdr.num_switches;
+  num_nodes_ = hdr.num_nodes;
+  num_channels_ = hdr.num_channels;
+
+  const uint32_t* ptr = (const uint32_t*) (data + sizeof(RoutingTableHeader));
+  node_switch_ = ptr;        ptr += hdr.num_nodes;
+  channel_offsets_ = ptr;    ptr += hdr.num_channels + 1;
+  ports_ = ptr;              ptr += hdr.num_ports;
+  local_offsets_ = ptr;      ptr += hdr.num_switches + 1;
+  local_channels_ = ptr;     ptr += hdr.num_local;
+  exception_offsets_ = ptr;  ptr += hdr.num_switches + 1;
+  exceptions_ = ptr;         ptr += 2*size_t(hdr.num_exceptions);
+  routes_ = (const uint16_t*) ptr;
+}
+
+CompactRoutingTable::CompactRoutingTable(Topology* top, const std::string& fname) :
+  mapping_(nullptr),
+  mapping_size_(0)
+{
+  int fd = ::open(fname.c_str(), O_RDONLY);
+  if (fd < 0){
+    spkt_abort_printf("failed opening binary routing table %s", fname.c_str());
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(RoutingTableHeader)){
+    spkt_abort_printf("binary routing table %s is truncated", fname.c_str());
+  }
+  mapping_size_ = st.st_size;
+  //the mapping is read-only and shared, so every switch, thread,
+  //and process on the host uses the same physical pages
+  mapping_ = ::mmap(nullptr, mapping_size_, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapping_ == MAP_FAILED){
+    spkt_abort_printf("failed mapping binary routing table %s", fname.c_str());
+  }
+
+  setPointers((const char*) mapping_, true);
+
+  if (num_switches_ != top->numSwitches() || num_nodes_ != top->numNodes()){
+    spkt_abort_printf("binary routing table %s has %u switches and %u nodes, "
+                      "but topology has %d switches and %d nodes",
+                      fname.c_str(), num_switches_, num_nodes_,
+                      int(top->numSwitches()), int(top->numNodes()));
+  }
+  for (NodeId nid=0; nid < num_nodes_; ++nid){
+    if (node_switch_[nid] != top->endpointToSwitch(nid)){
+      spkt_abort_printf("binary routing table %s places node %d on switch %u, "
+                        "but the topology places it on switch %d",
+                        fname.c_str(), int(nid), node_switch_[nid],
+                        int(top->endpointToSwitch(nid)));
+    }
+  }
+}
+
+CompactRoutingTable::CompactRoutingTable(Topology* top, const nlohmann::json& switches) :
+  mapping_(nullptr),
+  mapping_size_(0)
+{
+  uint32_t num_switches = top->numSwitches();
+  uint32_t num_nodes = top->numNodes();
+
+  std::vector<uint32_t> node_switch(num_nodes);
+  std::vector<std::vector<NodeId>> switch_nodes(num_switches);
+  for (NodeId nid=0; nid < num_nodes; ++nid){
+    SwitchId sid = top->endpointToSwitch(nid);
+    node_switch[nid] = sid;
+    switch_nodes[sid].push_back(nid);
+  }
+
+  std::map<std::vector<uint32_t>, uint32_t> channel_ids;
+  std::vector<uint32_t> channel_offsets(1, 0);
+  std::vector<uint32_t> ports;
+  std::vector<uint32_t> local_offsets(1, 0);
+  std::vector<uint32_t> local_channels;
+  std::vector<uint32_t> exception_offsets(1, 0);
+  std::vector<uint32_t> exceptions;
+  std::vector<uint16_t> routes(size_t(num_switches)*num_switches);
+
+  FileTopology* file_topo = dynamic_cast<FileTopology*>(top);
+  std::vector<int> node_local(num_nodes);
+  for (SwitchId sid=0; sid < num_switches; ++sid){
+    nlohmann::json port_channels;
+    if (file_topo){
+      try {
+        nlohmann::json switch_ports = file_topo->getSwitchJson(sid);
+        auto pch_it = switch_ports.find("port_channels");
+        if (pch_it != switch_ports.end()){
+          port_channels = *pch_it;
+        }
+      } catch (nlohmann::detail::exception& e) {
+        spkt_abort_printf("failed getting switch JSON info in routing table for switch %d",
+                          int(sid));
+      }
+    }
+
+    std::fill(node_local.begin(), node_local.end(), -1);
+    std::map<uint32_t, int> local_ids;
+    const nlohmann::json& sw_routes = switches.at(top->switchIdToName(sid)).at("routes");
+    for (auto it = sw_routes.begin(); it != sw_routes.end(); ++it){
+      NodeId dest_nid = top->nodeNameToId(it.key());
+      std::vector<uint32_t> pch;
+      if (it.value().is_number()){
+        //this is a single port
+        pch.push_back(int(it.value()));
+      } else {
+        std::string pch_name = it.value();
+        for (auto p : port_channels.at(pch_name).at("ports")){
+          pch.push_back(int(p));
+        }
+      }
+
+      auto ch_it = channel_ids.find(pch);
+      uint32_t channel;
+      if (ch_it == channel_ids.end()){
+        channel = channel_ids.size();
+        channel_ids[pch] = channel;
+        ports.insert(ports.end(), pch.begin(), pch.end());
+        channel_offsets.push_back(ports.size());
+      } else {
+        channel = ch_it->second;
+      }
+
+      auto loc_it = local_ids.find(channel);
+      int local;
+      if (loc_it == local_ids.end()){
+        local = local_ids.size();
+        if (local >= no_route){
+          spkt_abort_printf("switch %d uses too many distinct port channels", int(sid));
+        }
+        local_ids[channel] = local;
+        local_channels.push_back(channel);
+      } else {
+        local = loc_it->second;
+      }
+      node_local[dest_nid] = local;
+    }
+    local_offsets.push_back(local_channels.size());
+
+    for (NodeId nid=0; nid < num_nodes; ++nid){
+      if (node_local[nid] < 0){
+        spkt_abort_printf("No port specified on switch %d to destination %d",
+                          int(sid), int(nid));
+      }
+    }
+
+    uint16_t* row = &routes[size_t(sid)*num_switches];
+    for (SwitchId dst=0; dst < num_switches; ++dst){
+      auto& nodes = switch_nodes[dst];
+      if (nodes.empty()){
+        row[dst] = no_route;
+        continue;
+      }
+      int local = node_local[nodes.front()];
+      bool uniform = true;
+      for (NodeId nid : nodes){
+        if (node_local[nid] != local){
+          uniform = false;
+          break;
+        }
+      }
+      if (uniform){
+        row[dst] = local;
+      } else {
+        row[dst] = per_node;
+      }
+    }
+
+    //nodes are visited in order, so exceptions are sorted by node
+    for (NodeId nid=0; nid < num_nodes; ++nid){
+      if (row[node_switch[nid]] == per_node){
+        exceptions.push_back(nid);
+        exceptions.push_back(node_local[nid]);
+      }
+    }
+    exception_offsets.push_back(exceptions.size() / 2);
+  }
+
+  RoutingTableHeader hdr;
+  ::memcpy(hdr.magic, routing_table_magic, sizeof(hdr.magic));
+  hdr.num_switches = num_switches;
+  hdr.num_nodes = num_nodes;
+  hdr.num_channels = channel_ids.size();
+  hdr.num_ports = ports.size();
+  hdr.num_local = local_channels.size();
+  hdr.num_exceptions = exceptions.size() / 2;
+
+  buffer_.resize(tableSize(hdr));
+  char* ptr = buffer_.data();
+  auto append = [&](const void* src, size_t bytes){
+    ::memcpy(ptr, src, bytes);
+    ptr += bytes;
+  };
+  append(&hdr, sizeof(hdr));
+  append(node_switch.data(), node_switch.size()*sizeof(uint32_t));
+  append(channel_offsets.data(), channel_offsets.size()*sizeof(uint32_t));
+  append(ports.data(), ports.size()*sizeof(uint32_t));
+  append(local_offsets.data(), local_offsets.size()*sizeof(uint32_t));
+  append(local_channels.data(), local_channels.size()*sizeof(uint32_t));
+  append(exception_offsets.data(), exception_offsets.size()*sizeof(uint32_t));
+  append(exceptions.data(), exceptions.size()*sizeof(uint32_t));
+  append(routes.data(), routes.size()*sizeof(uint16_t));
+
+  setPointers(buffer_.data(), false);
+}
+
+CompactRoutingTable::~CompactRoutingTable()
+{
+  if (mapping_){
+    ::munmap(mapping_, mapping_size_);
+  }
+}
+
+int
+CompactRoutingTable::localChannel(SwitchId sid, NodeId dst) const
+{
+  uint16_t local = routes_[size_t(sid)*num_switches_ + node_switch_[dst]];
+  if (local == per_node){
+    const uint32_t* first = exceptions_ + 2*exception_offsets_[sid];
+    const uint32_t* last = exceptions_ + 2*exception_offsets_[sid+1];
+    //binary search over (node, channel) pairs
+    size_t lo = 0, hi = (last - first) / 2;
+    while (lo < hi){
+      size_t mid = (lo + hi) / 2;
+      if (first[2*mid] < dst) lo = mid + 1;
+      else hi = mid;
+    }
+    if (lo < size_t(last - first)/2 && first[2*lo] == dst){
+      return first[2*lo+1];
+    }
+    local = no_route;
+  }
+
+  if (local == no_route){
+    spkt_abort_printf("No port specified on switch %d to destination %d",
+                      int(sid), int(dst));
+  }
+  return local;
+}
+
+}
+}
@@ -0,0 +1,150 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#ifndef SSTMAC_HARDWARE_TOPOLOGY_ROUTING_TABLE_H_INCLUDED
+#define SSTMAC_HARDWARE_TOPOLOGY_ROUTING_TABLE_H_INCLUDED
+
+#include <sstmac/hardware/topology/topology_fwd.h>
+#include <sstmac/common/node_address.h>
+#include <sstmac/libraries/nlohmann/json.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sstmac {
+namespace hw {
+
+/**
+ * @brief The CompactRoutingTable class
+ * Read-only routing table shared by all switches and threads.
+ * Routes are keyed by destination switch: each switch has one row with an entry
+ * per destination switch giving the port channel to use. Destinations whose nodes
+ * need different port channels (e.g. the ejection ports on the switch itself)
+ * are marked and resolved through a short sorted per-node list.
+ * Port channels are interned globally so identical port lists are stored once,
+ * and each switch refers to its channels through a small local index.
+ *
+ * The table can be built from the JSON routing table format or memory-mapped
+ * directly from the binary format written by bin/tools/routing_table_convert.py.
+ */
+class CompactRoutingTable
+{
+ public:
+  static constexpr uint16_t per_node = 0xFFFF;
+  static constexpr uint16_t no_route = 0xFFFE;
+
+  /**
+   * @brief CompactRoutingTable Build a table from the JSON "switches" object of a routing file
+   * @param top       The topology giving node names and switch ids
+   * @param switches  The JSON object mapping switch names to their routes
+   */
+  CompactRoutingTable(Topology* top, const nlohmann::json& switches);
+
+  /**
+   * @brief CompactRoutingTable Memory-map a table in the binary format
+   * @param top       The topology the table must be consistent with
+   * @param fname     The binary routing table file
+   */
+  CompactRoutingTable(Topology* top, const std::string& fname);
+
+  ~CompactRoutingTable();
+
+  /**
+   * @brief isBinaryFile
+   * @return Whether the file begins with the binary routing table magic number
+   */
+  static bool isBinaryFile(const std::string& fname);
+
+  int numLocalChannels(SwitchId sid) const {
+    return local_offsets_[sid+1] - local_offsets_[sid];
+  }
+
+  /**
+   * @brief localChannel
+   * @return The index of the port channel, local to switch sid, used to reach node dst
+   */
+  int localChannel(SwitchId sid, NodeId dst) const;
+
+  /**
+   * @brief ports Get the port list of a port channel
+   * @param sid     The switch the local channel index belongs to
+   * @param local   The local channel index returned by localChannel
+   * @param size    Filled in with the number of ports in the channel
+   */
+  const uint32_t* ports(SwitchId sid, int local, int& size) const {
+    uint32_t channel = local_channels_[local_offsets_[sid] + local];
+    size = channel_offsets_[channel+1] - channel_offsets_[channel];
+    return ports_ + channel_offsets_[channel];
+  }
+
+  int numChannels() const {
+    return num_channels_;
+  }
+
+ private:
+  void setPointers(const char* data, bool check);
+
+  uint32_t num_switches_;
+  uint32_t num_nodes_;
+  uint32_t num_channels_;
+
+  const uint32_t* node_switch_;
+  const uint32_t* channel_offsets_;
+  const uint32_t* ports_;
+  const uint32_t* local_offsets_;
+  const uint32_t* local_channels_;
+  const uint32_t* exception_offsets_;
+  const uint32_t* exceptions_;
+  const uint16_t* routes_;
+
+  /** Either the mapped file or a buffer holding the same layout built from JSON */
+  void* mapping_;
+  size_t mapping_size_;
+  std::vector<char> buffer_;
+};
+
+}
+}
+
+#endif
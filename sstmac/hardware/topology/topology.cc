@@ -43,6 +43,7 @@ Questions? Contact sst-macro-help@sandia.gov
 */
 
 #include <sstmac/hardware/topology/topology.h>
+#include <sstmac/hardware/topology/routing_table.h>
 #include <sstmac/backends/common/sim_partition.h>
 #include <sstmac/common/thread_lock.h>
 #include <sstmac/common/event_scheduler.h>
@@ -71,6 +72,7 @@ RegisterKeywords(
 { "network_nodes_per_switch", "DEPRECATED: the number of nodes per switch" },
 { "auto", "whether to auto-generate topology based on app size"},
 { "output_graph", "enable dot format topology graph generation by specifying an output filename"},
+{ "routing_tables", "a JSON or binary routing table file for table-based routing"},
 );
 
 RegisterDebugSlot(topology,
@@ -110,7 +112,8 @@ Topology::nodeToLogpSwitch(NodeId nid) const
 }
 #endif
 
-Topology::Topology(SST::Params& params)
+Topology::Topology(SST::Params& params) :
+  compact_routing_table_(nullptr)
 {
 #if SSTMAC_INTEGRATED_SST_CORE
 #if SSTMAC_HAVE_VALID_MPI
@@ -129,20 +132,45 @@ Topology::Topology(SST::Params& params)
   }
 
   if (params.contains("routing_tables")){
-    std::string router_fname = params.find<std::string>("routing_tables");
-    std::ifstream rin(router_fname);
-    nlohmann::json rtr_jsn;
-    try {
-      rin >> rtr_jsn;
-    } catch (nlohmann::detail::exception& e) {
-      spkt_abort_printf("failed parsing json file %s", router_fname.c_str());
+    routing_tables_file_ = params.find<std::string>("routing_tables");
+    //binary tables are mapped on first use, not parsed here
+    if (!CompactRoutingTable::isBinaryFile(routing_tables_file_)){
+      std::ifstream rin(routing_tables_file_);
+      nlohmann::json rtr_jsn;
+      try {
+        rin >> rtr_jsn;
+      } catch (nlohmann::detail::exception& e) {
+        spkt_abort_printf("failed parsing json file %s", routing_tables_file_.c_str());
+      }
+      routing_tables_ = rtr_jsn.at("switches");
     }
-    routing_tables_ = rtr_jsn.at("switches");
   }
 }
 
 Topology::~Topology()
 {
+  if (compact_routing_table_) delete compact_routing_table_;
+}
+
+static thread_lock routing_table_lock;
+
+const CompactRoutingTable*
+Topology::routingTable()
+{
+  if (routing_tables_file_.empty()) return nullptr;
+
+  routing_table_lock.lock();
+  if (!compact_routing_table_){
+    if (routing_tables_.is_null()){
+      compact_routing_table_ = new CompactRoutingTable(this, routing_tables_file_);
+    } else {
+      compact_routing_table_ = new CompactRoutingTable(this, routing_tables_);
+      //the compact table holds everything we need
+      routing_tables_ = nlohmann::json();
+    }
+  }
+  routing_table_lock.unlock();
+  return compact_routing_table_;
 }
 
 Topology*
@@ -330,6 +330,16 @@ class Topology : public sprockit::printable
     return 1.0;
   }
 
+  /**
+   * @brief portLatencyScaleFactor
+   * @param addr  The switch
+   * @param port  An output port on the switch
+   * @return The multiple of switch.link.latency for the link leaving the port
+   */
+  virtual double portLatencyScaleFactor(uint32_t  /*addr*/, int  /*port*/) const {
+    return 1.0;
+  }
+
   /**
    * @brief connected_outports
    *        Given a 3D torus e.g., the connection vector would contain
@@ -516,10 +526,12 @@ class Topology : public sprockit::printable
 
   static std::string getPortNamespace(int port);
 
-  const nlohmann::json& getRoutingTable(SwitchId sid) const {
-    std::string name = switchIdToName(sid);
-    return routing_tables_.at(name).at("routes");
-  }
+  /**
+   * @brief routingTable The routing table given by the routing_tables parameter,
+   *        built on first use and shared by all switches
+   * @return The table or nullptr if no routing_tables parameter was given
+   */
+  const CompactRoutingTable* routingTable();
 
  protected:
   Topology(SST::Params& params);
@@ -538,7 +550,9 @@ class Topology : public sprockit::printable
   std::string dot_file_;
   std::string xyz_file_;
   std::string dump_file_;
+  std::string routing_tables_file_;
   nlohmann::json routing_tables_;
+  CompactRoutingTable* compact_routing_table_;
 
 };
 
@@ -50,6 +50,7 @@ namespace hw {
 
 class Topology;
 class CartesianTopology;
+class CompactRoutingTable;
 
 }
 }
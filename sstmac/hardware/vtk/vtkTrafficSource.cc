@@ -175,6 +175,24 @@ int vtkTrafficSource::RequestInformation(
 }
 
 //----------------------------------------------------------------------------
+void vtkTrafficSource::PaintEvent(int id, int port_id, double color)
+{
+  // traffic face index = switchId * 6 + getFaceIndex(switchId, port)
+  vtk_port port(id, port_id);
+
+  auto iter = port_to_link_id_.find(port.id32());
+  if (iter != port_to_link_id_.end()){ //port has a link to show
+    int link = iter->second;
+    vtk_link vl = vtk_link::construct(local_to_global_link_id_[port.id32()]);
+    this->Traffics->SetValue(link_index_offset_ + link, color);
+    int cell = cell_offsets_[vl.id2] + vl.port2 + 1;
+    this->Traffics->SetValue(cell, color);
+  }
+
+  int cell = cell_offsets_[id] + port_id + 1;
+  this->Traffics->SetValue(cell, color);
+}
+
 int vtkTrafficSource::RequestData(
   vtkInformation* vtkNotUsed(reqInfo),
   vtkInformationVector** vtkNotUsed(inVector),
@@ -205,26 +223,19 @@ int vtkTrafficSource::RequestData(
   output->GetInformation()->Set(vtkDataObject::DATA_TIME_STEP(), reqTS);
 
   //Updade and Send traffic to output
-  auto currentIntensities =  traffic_progress_map_.equal_range(reqTS);
-
-  for(auto it = currentIntensities.first; it != currentIntensities.second; ++it){
-    // traffic face index = switchId * 6 + getFaceIndex(switchId, port)
-    traffic_event& event = it->second;
-    vtk_port port(event.id_, event.port_);
-
-    auto iter = port_to_link_id_.find(port.id32());
-    if (iter != port_to_link_id_.end()){ //port has a link to show
-      int link = iter->second;
-      vtk_link vl = vtk_link::construct(local_to_global_link_id_[port.id32()]);
-      this->Traffics->SetValue(link_index_offset_ + link, event.color_);
-      int cell = cell_offsets_[vl.id2] + vl.port2 + 1;
-      this->Traffics->SetValue(cell, event.color_);
+  if (traffic_stream_){
+    //the merged stream is time-ordered, so consume everything up to this step
+    while (!traffic_stream_->empty() && traffic_stream_->top().time <= reqTS){
+      const VTKEventSpill::record& rec = traffic_stream_->top();
+      PaintEvent(rec.id, rec.port, rec.color);
+      traffic_stream_->pop();
+    }
+  } else {
+    auto currentIntensities =  traffic_progress_map_.equal_range(reqTS);
+    for(auto it = currentIntensities.first; it != currentIntensities.second; ++it){
+      traffic_event& event = it->second;
+      PaintEvent(event.id_, event.port_, event.color_);
     }
-
-    //std::cout << "Writing color=" << event.color_ << " on " << event.id_ << " port " << event.port_
-   //           << " at t=" << reqTS << " on step=" << timestep << std::endl;
-    int cell = cell_offsets_[event.id_] + event.port_ + 1;
-    this->Traffics->SetValue(cell, event.color_);
   }
   ++timestep;
 
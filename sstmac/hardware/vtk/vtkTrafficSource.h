@@ -131,6 +131,13 @@ public:
     traffic_progress_map_ = std::move(trafficProgressMap);
   }
 
+  /**
+   * Replaces the traffic map with a time-ordered stream of spilled events
+   */
+  void SetTrafficStream(std::unique_ptr<VTKEventMerger>&& trafficStream){
+    traffic_stream_ = std::move(trafficStream);
+  }
+
   void SetTraffics(vtkSmartPointer<vtkIntArray> traffics);
 
   void SetPaintSwitches(uint64_t paintLength);
@@ -147,9 +154,12 @@ protected:
                   vtkInformationVector**,
                   vtkInformationVector*) override;
 
+  void PaintEvent(int id, int port, double color);
+
   int NumSteps;
   double *Steps;
   std::multimap<uint64_t, traffic_event> traffic_progress_map_;
+  std::unique_ptr<VTKEventMerger> traffic_stream_;
   std::unordered_map<uint32_t,int> port_to_link_id_;
   std::unordered_map<uint32_t,uint64_t> local_to_global_link_id_;
   vtkDoubleArray * Traffics;
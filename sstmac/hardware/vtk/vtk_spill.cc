@@ -0,0 +1,173 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+#include <sstmac/hardware/vtk/vtk_spill.h>
+#include <sprockit/errors.h>
+#include <unistd.h>
+
+namespace sstmac {
+namespace hw {
+
+std::mutex VTKEventSpill::open_lock_;
+std::map<std::string, std::weak_ptr<VTKEventSpill>> VTKEventSpill::spills_;
+
+std::shared_ptr<VTKEventSpill>
+VTKEventSpill::open(const std::string& fileroot)
+{
+  std::lock_guard<std::mutex> guard(open_lock_);
+  std::shared_ptr<VTKEventSpill> spill = spills_[fileroot].lock();
+  if (!spill){
+    spill.reset(new VTKEventSpill(fileroot + ".vtkspill"));
+    spills_[fileroot] = spill;
+  }
+  return spill;
+}
+
+VTKEventSpill::VTKEventSpill(const std::string& fname) :
+  fname_(fname),
+  offset_(0),
+  num_events_(0)
+{
+  file_ = fopen(fname.c_str(), "w+b");
+  if (!file_){
+    spkt_abort_printf("could not open VTK spill file %s", fname.c_str());
+  }
+}
+
+VTKEventSpill::~VTKEventSpill()
+{
+  fclose(file_);
+  ::remove(fname_.c_str());
+}
+
+void
+VTKEventSpill::append(const std::vector<record>& events, std::vector<run>& runs)
+{
+  std::lock_guard<std::mutex> guard(lock_);
+  size_t nwritten = fwrite(events.data(), sizeof(record), events.size(), file_);
+  if (nwritten != events.size()){
+    spkt_abort_printf("failed writing %d events to VTK spill file %s",
+                      int(events.size()), fname_.c_str());
+  }
+  runs.push_back({offset_, int(events.size())});
+  offset_ += events.size() * sizeof(record);
+  num_events_ += events.size();
+  for (const record& r : events){
+    steps_.insert(r.time);
+    uint32_t port_id = (uint32_t(uint16_t(r.id)) << 16) | uint16_t(r.port);
+    if (used_ports_.insert(port_id).second){
+      used_port_order_.push_back(port_id);
+    }
+  }
+}
+
+void
+VTKEventSpill::read(const run& r, std::vector<record>& events)
+{
+  events.resize(r.count);
+  ssize_t nbytes = r.count * sizeof(record);
+  if (::pread(fileno(file_), events.data(), nbytes, r.offset) != nbytes){
+    spkt_abort_printf("failed reading %d events from VTK spill file %s",
+                      r.count, fname_.c_str());
+  }
+}
+
+std::vector<double>
+VTKEventSpill::steps() const
+{
+  //match the in-memory steps, which always lead with zero
+  std::vector<double> steps;
+  steps.reserve(steps_.size() + 1);
+  steps.push_back(0.);
+  for (uint64_t t : steps_){
+    steps.push_back(t);
+  }
+  return steps;
+}
+
+void
+VTKEventSpill::flush()
+{
+  fflush(file_);
+}
+
+VTKEventMerger::VTKEventMerger(const std::shared_ptr<VTKEventSpill>& spill,
+                               std::vector<std::vector<VTKEventSpill::run>>&& streams) :
+  spill_(spill),
+  streams_(std::move(streams)),
+  cursors_(streams_.size())
+{
+  for (size_t s=0; s < streams_.size(); ++s){
+    cursors_[s].next_run = 0;
+    cursors_[s].next_event = 0;
+    advance(s);
+  }
+}
+
+void
+VTKEventMerger::advance(size_t stream)
+{
+  cursor& c = cursors_[stream];
+  while (c.next_event == c.events.size()){
+    if (c.next_run == streams_[stream].size()){
+      c.events.clear();
+      return; //stream is exhausted
+    }
+    spill_->read(streams_[stream][c.next_run], c.events);
+    ++c.next_run;
+    c.next_event = 0;
+  }
+  heads_.push({c.events[c.next_event], stream});
+  ++c.next_event;
+}
+
+void
+VTKEventMerger::pop()
+{
+  size_t stream = heads_.top().stream;
+  heads_.pop();
+  advance(stream);
+}
+
+}
+}
@@ -0,0 +1,197 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+#ifndef sstmac_hw_vtk_spill_included_h
+#define sstmac_hw_vtk_spill_included_h
+
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <set>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace sstmac {
+namespace hw {
+
+/**
+ * @brief The VTKEventSpill class
+ * In streaming mode, switches bin color changes into fixed time windows
+ * and append each completed window to the spill file of their output.
+ * A window is written as a run of events sorted by port, and each switch
+ * writes its windows in time order, so the runs of a switch form a
+ * time-sorted stream that can be merged without holding every event.
+ * This does not depend on VTK so that it builds and is tested everywhere.
+ */
+class VTKEventSpill
+{
+ public:
+  struct record {
+    uint64_t time;
+    int32_t id;
+    int32_t port;
+    double color;
+  };
+
+  struct run {
+    long offset;
+    int count;
+  };
+
+  /**
+   * @param fileroot The output the switches write to
+   * @return The spill file shared by every switch writing to fileroot.
+   *         The file is removed once the last reference is dropped.
+   */
+  static std::shared_ptr<VTKEventSpill> open(const std::string& fileroot);
+
+  ~VTKEventSpill();
+
+  /**
+   * @param events The events of one window, all at the same time
+   * @param runs  [inout] The run list of the switch that owns the events
+   */
+  void append(const std::vector<record>& events, std::vector<run>& runs);
+
+  void read(const run& r, std::vector<record>& events);
+
+  /**
+   * @return The distinct window start times with any events, led by zero
+   */
+  std::vector<double> steps() const;
+
+  /**
+   * @return Every (switch,port) pair with any events, in order of first use,
+   *         packed as in vtk_port::id32
+   */
+  const std::vector<uint32_t>& usedPorts() const {
+    return used_port_order_;
+  }
+
+  uint64_t numEvents() const {
+    return num_events_;
+  }
+
+  const std::string& fname() const {
+    return fname_;
+  }
+
+  /**
+   * Flush pending writes so that runs can be read back
+   */
+  void flush();
+
+ private:
+  VTKEventSpill(const std::string& fname);
+
+  static std::mutex open_lock_;
+  static std::map<std::string, std::weak_ptr<VTKEventSpill>> spills_;
+
+  std::string fname_;
+  FILE* file_;
+  long offset_;
+  uint64_t num_events_;
+  std::set<uint64_t> steps_;
+  std::set<uint32_t> used_ports_;
+  std::vector<uint32_t> used_port_order_;
+  std::mutex lock_;
+};
+
+/**
+ * @brief The VTKEventMerger class
+ * K-way merge over the spilled run lists of every switch, yielding events
+ * in the same (time, switch, port) order as the in-memory event map.
+ * Only the current run of each switch is held in memory.
+ */
+class VTKEventMerger
+{
+ public:
+  VTKEventMerger(const std::shared_ptr<VTKEventSpill>& spill,
+                 std::vector<std::vector<VTKEventSpill::run>>&& streams);
+
+  bool empty() const {
+    return heads_.empty();
+  }
+
+  const VTKEventSpill::record& top() const {
+    return heads_.top().rec;
+  }
+
+  void pop();
+
+ private:
+  struct cursor {
+    std::vector<VTKEventSpill::record> events;
+    size_t next_run;
+    size_t next_event;
+  };
+
+  struct head {
+    VTKEventSpill::record rec;
+    size_t stream;
+  };
+
+  struct compare_heads {
+    bool operator()(const head& l, const head& r) const {
+      //priority queue is a max heap - invert the comparison
+      if (l.rec.time != r.rec.time) return l.rec.time > r.rec.time;
+      if (l.rec.id != r.rec.id) return l.rec.id > r.rec.id;
+      return l.rec.port > r.rec.port;
+    }
+  };
+
+  void advance(size_t stream);
+
+  std::shared_ptr<VTKEventSpill> spill_;
+  std::vector<std::vector<VTKEventSpill::run>> streams_;
+  std::vector<cursor> cursors_;
+  std::priority_queue<head, std::vector<head>, compare_heads> heads_;
+};
+
+}
+}
+
+#endif
@@ -49,6 +49,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sprockit/keyword_registration.h>
 
 #include <utility>
+#include <unordered_set>
 
 #include <vtkInformation.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
@@ -92,7 +93,8 @@ RegisterKeywords(
 { "max_face_color_sum", "the max color to allow for summation coloring of faces" },
 { "scale_face_color_sum", "" },
 { "active_face_width", "the width fraction of an active face" },
-{ "field_name", "" }
+{ "field_name", "" },
+{ "stream_window", "if non-zero, bin colors into windows of this length and spill them to disk instead of keeping every event" },
 );
 
 namespace sstmac {
@@ -100,9 +102,17 @@ namespace hw {
 
 static constexpr double link_midpoint_shift = 2.0;
 
-void
-outputExodusWithSharedMap(const std::string& fileroot,
-   std::multimap<uint64_t, traffic_event>&& trafficMap,
+/**
+ * @param used_ports Every (switch,port) with traffic, in the order links are numbered
+ * @param time_steps The time steps to write, which must outlive the write
+ * @param trafficSource A source already fed with the traffic events
+ */
+static void
+outputExodusImpl(const std::string& fileroot,
+   const std::vector<uint32_t>& used_ports,
+   std::vector<double>& time_steps,
+   uint64_t num_events,
+   vtkSmartPointer<vtkTrafficSource> trafficSource,
    StatVTK::display_config display_cfg,
    Topology *topo)
 {
@@ -148,16 +158,7 @@ outputExodusWithSharedMap(const std::string& fileroot,
   int global_link_id = 0;
   std::unordered_map<uint32_t,int> port_to_vtk_cell_mapping;
   std::unordered_map<int,uint32_t> link_to_port_mapping;
-  for (auto& pair : trafficMap){
-    traffic_event& e = pair.second;
-    vtk_port p(e.id_, e.port_);
-    vtk_port test_p = vtk_port::construct(p.id32());
-    if (test_p.id != p.id || test_p.port != p.port){
-      spkt_abort_printf("Bad port bit arithmetic: port(%d,%d) != port(%d,%d)",
-                        int(p.id), int(p.port), int(test_p.id), int(test_p.port));
-    }
-
-    uint32_t port_global_id = p.id32();
+  for (uint32_t port_global_id : used_ports){
     auto iter = outport_to_link.find(port_global_id);
     if (iter != outport_to_link.end()){ //not all ports get links
       auto link_iter = port_to_vtk_cell_mapping.find(port_global_id);
@@ -340,7 +341,7 @@ outputExodusWithSharedMap(const std::string& fileroot,
   }
 
   std::cout << "vtk_stats : num cells=" << cell_array->GetNumberOfCells()<<std::endl;
-  std::cout << "vtk_stats : num events=" << trafficMap.size() << std::endl;
+  std::cout << "vtk_stats : num events=" << num_events << std::endl;
 
 
   vtkSmartPointer<vtkUnstructuredGrid> unstructured_grid =
@@ -350,28 +351,11 @@ outputExodusWithSharedMap(const std::string& fileroot,
   unstructured_grid->SetCells(cell_types.data(), cell_array);
   unstructured_grid->GetCellData()->AddArray(traffic);
 
-  // Init Time Step
-  double current_time = -1;
-  double *time_step_value = new double[trafficMap.size() + 1];
-  time_step_value[0] = 0.;
-  int currend_index = 1;
-  for (auto it = trafficMap.cbegin(); it != trafficMap.cend(); ++it){
-    if (it->first != current_time){
-      current_time = it->first;
-      time_step_value[currend_index] = it->first;
-      ++currend_index;
-    }
-  }
-  // TOCHECK: time_step_value for trafficMap.size() > values >= currend_index isn't intialized (and shouldn't be used)
-  // time_step_value should be resized ?
-
-  vtkSmartPointer<vtkTrafficSource> trafficSource = vtkSmartPointer<vtkTrafficSource>::New();
-
   trafficSource->SetDisplayParameters(display_cfg);
   trafficSource->SetNumObjects(num_switches, num_links_to_paint, std::move(cell_offsets));
 
-  trafficSource->SetSteps(time_step_value);
-  trafficSource->SetNumberOfSteps(currend_index);
+  trafficSource->SetSteps(time_steps.data());
+  trafficSource->SetNumberOfSteps(time_steps.size());
 
   trafficSource->SetPoints(points);
   trafficSource->SetGeometries(std::move(geoms));
@@ -381,7 +365,6 @@ outputExodusWithSharedMap(const std::string& fileroot,
   trafficSource->SetTraffics(traffic);
   trafficSource->SetPortLinkMap(std::move(port_to_vtk_cell_mapping));
   trafficSource->SetLocalToGlobalLinkMap(std::move(outport_to_link));
-  trafficSource->SetTrafficProgressMap(std::move(trafficMap));
 
   vtkSmartPointer<vtkExodusIIWriter> exodusWriter = vtkSmartPointer<vtkExodusIIWriter>::New();
   std::string fileName = fileroot + ".e";
@@ -391,6 +374,45 @@ outputExodusWithSharedMap(const std::string& fileroot,
   exodusWriter->Write();
 }
 
+void
+outputExodusWithSharedMap(const std::string& fileroot,
+   std::multimap<uint64_t, traffic_event>&& trafficMap,
+   StatVTK::display_config display_cfg,
+   Topology *topo)
+{
+  std::vector<uint32_t> used_ports;
+  std::unordered_set<uint32_t> seen_ports;
+  for (auto& pair : trafficMap){
+    traffic_event& e = pair.second;
+    vtk_port p(e.id_, e.port_);
+    vtk_port test_p = vtk_port::construct(p.id32());
+    if (test_p.id != p.id || test_p.port != p.port){
+      spkt_abort_printf("Bad port bit arithmetic: port(%d,%d) != port(%d,%d)",
+                        int(p.id), int(p.port), int(test_p.id), int(test_p.port));
+    }
+    if (seen_ports.insert(p.id32()).second){
+      used_ports.push_back(p.id32());
+    }
+  }
+
+  // Init Time Step
+  std::vector<double> time_steps;
+  time_steps.push_back(0.);
+  double current_time = -1;
+  for (auto it = trafficMap.cbegin(); it != trafficMap.cend(); ++it){
+    if (it->first != current_time){
+      current_time = it->first;
+      time_steps.push_back(it->first);
+    }
+  }
+
+  uint64_t num_events = trafficMap.size();
+  vtkSmartPointer<vtkTrafficSource> trafficSource = vtkSmartPointer<vtkTrafficSource>::New();
+  trafficSource->SetTrafficProgressMap(std::move(trafficMap));
+  outputExodusImpl(fileroot, used_ports, time_steps, num_events,
+                   trafficSource, display_cfg, topo);
+}
+
 void
 StatVTK::outputExodus(const std::string& fileroot,
     std::multimap<uint64_t, traffic_event>&& traffMap,
@@ -401,10 +423,26 @@ StatVTK::outputExodus(const std::string& fileroot,
                             cfg, topo);
 }
 
+void
+StatVTK::outputExodusStream(const std::string& fileroot,
+    const std::shared_ptr<VTKEventSpill>& spill,
+    std::vector<std::vector<VTKEventSpill::run>>&& streams,
+    const display_config& cfg,
+    Topology *topo)
+{
+  spill->flush();
+  std::vector<double> time_steps = spill->steps();
+  std::unique_ptr<VTKEventMerger> merger(new VTKEventMerger(spill, std::move(streams)));
+  vtkSmartPointer<vtkTrafficSource> trafficSource = vtkSmartPointer<vtkTrafficSource>::New();
+  trafficSource->SetTrafficStream(std::move(merger));
+  outputExodusImpl(fileroot, spill->usedPorts(), time_steps, spill->numEvents(),
+                   trafficSource, cfg, topo);
+}
 
 StatVTK::StatVTK(SST::Params& params) :
-  StatCollector(params), active_(true)
+  StatCollector(params), window_start_(0), active_(true)
 {
+  stream_window_ = sstmac::TimeDelta(params.find<SST::UnitAlgebra>("stream_window", "0").getValue().toDouble());
   min_interval_ = sstmac::TimeDelta(params.find<SST::UnitAlgebra>("min_interval", "1us").getValue().toDouble());
   display_cfg_.bidirectional_shift = params.find<double>("bidirectional_shift", 0.02);
   display_cfg_.highlight_link_color = params.find<double>("highlight_link_color", 1.0);
@@ -444,6 +482,16 @@ StatVTK::reduce(StatCollector* element)
 {
   StatVTK* contribution = safe_cast(StatVTK, element);
 
+  if (stream_window_.ticks() != 0){
+    if (contribution->spill_){
+      spill_ = std::move(contribution->spill_);
+    }
+    if (!contribution->runs_.empty()){
+      streams_.push_back(std::move(contribution->runs_));
+    }
+    return;
+  }
+
   for (const traffic_event& e : contribution->sorted_event_list_){
     traffic_event_map_.emplace(e.time_, e);
   }
@@ -472,11 +520,25 @@ StatVTK::finalize(TimeDelta t)
     }
   }
 
+  //the last window plus any final colors carried out of it
+  while (!window_colors_.empty()){
+    spillWindow();
+  }
+
 }
 
 void
 StatVTK::dumpGlobalData()
 {
+  if (stream_window_.ticks() != 0){
+    if (spill_){
+      outputExodusStream(fileroot_, spill_, std::move(streams_),
+                         display_cfg_, Topology::global());
+      //the spill file is removed with the last reference
+      spill_.reset();
+    }
+    return;
+  }
   outputExodusWithSharedMap(fileroot_, std::move(traffic_event_map_),
                             display_cfg_, Topology::global());
 }
@@ -517,6 +579,13 @@ StatVTK::collect_new_color(TimeDelta time, int port, double color)
   if (!active_ || port >= port_states_.size()) return;
 
   port_state& port_int = port_states_[port];
+  if (stream_window_.ticks() != 0){
+    //windows replace the min interval aggregation
+    binColor(time, port, color);
+    port_int.active_vtk_color = color;
+    return;
+  }
+
   TimeDelta interval_length = time - port_int.pending_collection_start;
 
   if (min_interval_.ticks() == 0){
@@ -559,6 +628,53 @@ StatVTK::collect_new_color(TimeDelta time, int port, double color)
   }
 }
 
+void
+StatVTK::binColor(TimeDelta time, int port, double color)
+{
+  uint64_t window = stream_window_.ticks();
+  uint64_t start = time.ticks() - time.ticks() % window;
+  while (start > window_start_ && !window_colors_.empty()){
+    spillWindow();
+  }
+  //events are binned in time order - a late event joins the open window
+  if (start > window_start_){
+    window_start_ = start;
+  }
+
+  auto iter = window_colors_.find(port);
+  if (iter == window_colors_.end()){
+    window_colors_[port] = {color, color};
+  } else {
+    window_color& wc = iter->second;
+    wc.peak = std::max(wc.peak, color);
+    wc.last = color;
+  }
+}
+
+void
+StatVTK::spillWindow()
+{
+  if (!spill_){
+    spill_ = VTKEventSpill::open(fileroot_);
+  }
+
+  //paint each port with its peak color for the window, and carry any
+  //different final color into the next window so ports return to idle
+  std::vector<VTKEventSpill::record> events;
+  events.reserve(window_colors_.size());
+  std::map<int, window_color> carry;
+  for (auto& pair : window_colors_){
+    const window_color& wc = pair.second;
+    events.push_back({window_start_, int32_t(id_), int32_t(pair.first), wc.peak});
+    if (wc.last != wc.peak){
+      carry[pair.first] = {wc.last, wc.last};
+    }
+  }
+  spill_->append(events, runs_);
+  window_start_ += stream_window_.ticks();
+  window_colors_ = std::move(carry);
+}
+
 void
 StatVTK::collect_new_intensity(TimeDelta time, int port, double intensity)
 {
@@ -49,7 +49,10 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <queue>
 #include <memory>
 #include <tuple>
+#include <map>
+#include <set>
 #include <sstmac/hardware/topology/topology.h>
+#include <sstmac/hardware/vtk/vtk_spill.h>
 
 #if SSTMAC_INTEGRATED_SST_CORE
 #include <sst/core/statapi/statfieldinfo.h>
@@ -177,6 +180,12 @@ class StatVTK : public StatCollector
       const display_config& cfg,
       Topology *topo =nullptr);
 
+  static void outputExodusStream(const std::string& fileroot,
+      const std::shared_ptr<VTKEventSpill>& spill,
+      std::vector<std::vector<VTKEventSpill::run>>&& streams,
+      const display_config& cfg,
+      Topology *topo =nullptr);
+
   void dumpLocalData() override;
 
   void dumpGlobalData() override;
@@ -232,6 +241,18 @@ class StatVTK : public StatCollector
     }
   };
 
+  /**
+   * The peak and final color of a port within the current window
+   */
+  struct window_color {
+    double peak;
+    double last;
+  };
+
+  void binColor(TimeDelta time, int port, double color);
+
+  void spillWindow();
+
   struct compare_events {
     bool operator()(const traffic_event& l, const traffic_event& r){
       if (l.time_ != r.time_) return l.time_ < r.time_;
@@ -254,6 +275,13 @@ class StatVTK : public StatCollector
   std::multimap<uint64_t, traffic_event> traffic_event_map_;
   hw::Topology* top_;
 
+  TimeDelta stream_window_;
+  uint64_t window_start_;
+  std::map<int, window_color> window_colors_;
+  std::shared_ptr<VTKEventSpill> spill_;
+  std::vector<VTKEventSpill::run> runs_;
+  std::vector<std::vector<VTKEventSpill::run>> streams_;
+
   bool active_;
   bool flicker_;
 
@@ -260,6 +260,7 @@ extern "C" int
 SSTMAC_pthread_mutex_lock(sstmac_pthread_mutex_t* mutex)
 {
   pthread_debug("pthread_mutex_lock");
+  currentThread()->os()->flushCompute();
   int rc;
   if ((rc = check_mutex(mutex)) != 0){
     return rc;
@@ -290,7 +291,8 @@ SSTMAC_pthread_spin_trylock(sstmac_pthread_spinlock_t * lock)
 extern "C" int
 SSTMAC_pthread_mutex_trylock(sstmac_pthread_mutex_t * mutex)
 {
-  pthread_debug("pthread_mutex_trylock");  
+  pthread_debug("pthread_mutex_trylock");
+  currentThread()->os()->flushCompute();
   int rc;
   if ((rc = check_mutex(mutex)) != 0){
     return rc;
@@ -317,6 +319,7 @@ extern "C" int
 SSTMAC_pthread_mutex_unlock(sstmac_pthread_mutex_t * mutex)
 {
   pthread_debug("pthread_mutex_unlock %d", int(*mutex));
+  currentThread()->os()->flushCompute();
   int rc;
   if ((rc = check_mutex(mutex)) != 0){
     return rc;
@@ -417,7 +420,8 @@ extern "C" int
 SSTMAC_pthread_cond_timedwait(sstmac_pthread_cond_t * cond,
                               sstmac_pthread_mutex_t * mutex, const timespec * abstime)
 {
-  pthread_debug("pthread_cond_timedwait");  
+  pthread_debug("pthread_cond_timedwait");
+  currentThread()->os()->flushCompute();
   int rc;
   if ((rc=check_cond(cond)) != 0){
     return rc;
@@ -474,6 +478,7 @@ extern "C" int
 SSTMAC_pthread_cond_signal(sstmac_pthread_cond_t * cond)
 {
   pthread_debug("pthread_cond_signal");
+  currentThread()->os()->flushCompute();
   int rc;
   if ((rc=check_cond(cond)) != 0){
     return rc;
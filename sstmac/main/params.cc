@@ -186,16 +186,6 @@ remapParams(sprockit::SimParameters::ptr params, bool verbose)
   for (int i=0; i < debug_flags.size(); ++i){
     sprockit::Debug::turnOn(debug_flags[i]);
   }
-
-  /** If more than one thread, make sure event manager is multithreaded */
-  if (params->hasParam("sst_nthread")){
-    int nthr = params->getIntParam("sst_nthread");
-    if (nthr > 1)
-      spkt_abort_printf("sst_nthread > 1 is not currently supported");
-    //if (nthr > 1 && !params->hasParam("event_manager")){
-    //  params->addParamOverride("event_manager", "multithread");
-    //}
-  }
 }
 
 }
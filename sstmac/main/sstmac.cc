@@ -62,6 +62,8 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/software/process/app.h>
 #include <sstmac/software/process/operating_system.h>
 #include <sstmac/software/process/time.h>
+#include <sstmac/software/process/global.h>
+#include <sstmac/software/threading/stack_alloc.h>
 #include <sstmac/software/launch/task_mapping.h>
 #include <sstmac/hardware/interconnect/interconnect.h>
 #include <sstmac/hardware/topology/topology.h>
@@ -71,6 +73,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sprockit/output.h>
 #include <sprockit/basic_string_tokenizer.h>
 #include <sprockit/keyword_registration.h>
+#include <sprockit/thread_safe_new.h>
 #include <sstmac/common/event_manager.h>
 #include <sstmac/backends/native/serial_runtime.h>
 #include <sstmac/software/process/app.h>
@@ -83,6 +86,7 @@ Questions? Contact sst-macro-help@sandia.gov
 
 RegisterKeywords(
  { "external_libs", "a list of external .so files to load" },
+ { "print_allocation_stats", "whether to print object pool usage at the end of the run" },
 );
 
 namespace sstmac {
@@ -307,7 +311,10 @@ tryMain(sprockit::SimParameters::ptr params,
   sstmac::initParams(rt, oo, params, parallel);
 
   //do some cleanup and processing of params
-  sstmac::remapParams(params);
+  //benchmarks run without a machine, so there is nothing to remap
+  if (oo.benchmark.empty()){
+    sstmac::remapParams(params);
+  }
 
   if (params->hasParam("external_libs")){
     std::string pathStr = loadExternPathStr();
@@ -325,9 +332,13 @@ tryMain(sprockit::SimParameters::ptr params,
 #else
   SST::Params mainParams(params);
   if (!oo.benchmark.empty()){
-    Benchmark* bm = Benchmark::getBuilderLibrary("macro")
-        ->getBuilder(oo.benchmark)->create();
+    auto* builder = Benchmark::getBuilderLibrary("macro")->getBuilder(oo.benchmark);
+    if (!builder){
+      spkt_abort_printf("unknown benchmark %s", oo.benchmark.c_str());
+    }
+    Benchmark* bm = builder->create(mainParams);
     bm->run();
+    delete bm;
     return 0;
   }
 
@@ -343,6 +354,17 @@ tryMain(sprockit::SimParameters::ptr params,
     cout0 << sprockit::sprintf("Estimated total runtime of %20.8f seconds\n", stats.simulatedTime);
   }
 
+  GlobalVariableContext::printSegmentStats(cout0);
+  sw::StackAlloc::printStats(cout0);
+
+  if (mainParams.find<bool>("print_allocation_stats", false)){
+#if SSTMAC_CUSTOM_NEW
+    sprockit::ThreadAllocatorSet::printStats(cout0);
+#else
+    cout0 << "Object pools are disabled - configure with --enable-custom-new\n";
+#endif
+  }
+
   if (oo.print_params) {
     params->printParams();
   }
@@ -51,7 +51,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/sst_core/integrated_component.h>
 #include <string>
 #include <sprockit/factory.h>
-#include <sys/time.h>
+#include <sstmac/software/process/time.h>
 
 #define PARSE_OPT_SUCCESS 0
 #define PARSE_OPT_EXIT_SUCCESS 1
@@ -114,15 +114,15 @@ namespace sstmac {
 struct Benchmark {
   SST_ELI_DECLARE_BASE(Benchmark)
   SST_ELI_DECLARE_DEFAULT_INFO()
-  SST_ELI_DECLARE_DEFAULT_CTOR()
+  SST_ELI_DECLARE_CTOR(SST::Params&)
+
+  virtual ~Benchmark(){}
 
   virtual void run() = 0;
 
+  /** Host wall time - benchmarks built with sst++ see a simulated gettimeofday */
   static double now() {
-    timeval t_st;
-    gettimeofday(&t_st, 0);
-    double t = t_st.tv_sec + 1e-6 * t_st.tv_usec;
-    return t;
+    return sstmacWallTime();
   }
 };
 
@@ -53,6 +53,7 @@ typedef int (*empty_main_fxn)();
 
 extern "C" double
 sstmac_now(){
+  sstmac::sw::OperatingSystem::currentOs()->flushCompute();
   return sstmac::sw::OperatingSystem::currentOs()->now().sec();
 }
 
@@ -88,7 +89,7 @@ void getAppUnitParam(const std::string& name, const std::string& def, int& val){
 }
 
 void getAppUnitParam(const std::string& name, const std::string& def, double& val){
-  val = appParams().find<SST::UnitAlgebra>(name, def).getRoundedValue();
+  val = appParams().find<SST::UnitAlgebra>(name, def).getValue().toDouble();
 }
 
 void getAppArrayParam(const std::string& name, std::vector<int>& vec){
@@ -0,0 +1,299 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#include <sstmac/skeletons/compact_replay/compact_replay.h>
+#include <sstmac/common/timestamp.h>
+#include <sumi-mpi/mpi_api.h>
+#include <sumi-mpi/mpi_types/mpi_type.h>
+#include <sprockit/errors.h>
+#include <sprockit/sim_parameters.h>
+#include <sprockit/keyword_registration.h>
+
+RegisterKeywords(
+{ "compact_trace", "the compact trace file written by sstmac_trace_convert" },
+{ "compact_timescale", "the scale factor for time between MPI calls, < 1 means speedup" },
+);
+
+namespace sumi {
+
+CompactReplay::CompactReplay(SST::Params& params, sstmac::sw::SoftwareId sid,
+                             sstmac::sw::OperatingSystem* os) :
+  App(params, sid, os),
+  mpi_(nullptr),
+  trace_(nullptr)
+{
+  trace_file_ = params.find<std::string>("compact_trace");
+  timescaling_ = params.find<double>("compact_timescale", 1.0);
+}
+
+CompactReplay::~CompactReplay() throw()
+{
+}
+
+void
+CompactReplay::computeGap(uint64_t nsec)
+{
+  if (timescaling_ == 1.0){
+    compute(sstmac::TimeDelta(nsec, sstmac::TimeDelta::one_nanosecond));
+  } else {
+    compute(sstmac::TimeDelta(timescaling_ * nsec * 1e-9));
+  }
+}
+
+const int*
+CompactReplay::counts(const int32_t* arrays, int32_t offset, int32_t n,
+                      int32_t id, std::vector<int>& scratch) const
+{
+  if (n == 0) return nullptr;
+  const int32_t* src = arrays + offset;
+  int scale = types_[id].scale;
+  if (scale == 1) return src;
+  scratch.resize(n);
+  for (int i=0; i < n; ++i){
+    scratch[i] = src[i] * scale;
+  }
+  return scratch.data();
+}
+
+int
+CompactReplay::skeletonMain()
+{
+  mpi_ = getApi<MpiApi>("mpi");
+  //every handle in the trace is already a unique dense id
+  mpi_->setGenerateIds(false);
+
+  trace_ = CompactTraceFile::get(trace_file_);
+
+  CompactTraceFile::RankTrace tr = trace_->rank(tid());
+  const int32_t* args = tr.args;
+  uint64_t i = 0;
+  while (i < tr.ncalls){
+    if (tr.gaps[i]) computeGap(tr.gaps[i]);
+    CompactOp op = CompactOp(tr.ops[i]);
+    if (op >= CompactOp::NumOps){
+      spkt_abort_printf("invalid op %d in compact trace %s",
+                        int(tr.ops[i]), trace_file_.c_str());
+    }
+    const int32_t* next_args = args + compact_op_nargs[tr.ops[i]];
+    ++i;
+    if (op == CompactOp::Loop){
+      if (args[0] <= 0 || args[1] <= 0 || i + args[1] > tr.ncalls){
+        spkt_abort_printf("invalid loop of %d x %d records in compact trace %s",
+                          args[0], args[1], trace_file_.c_str());
+      }
+      loops_.push_back({i, i + args[1], next_args, args[0]});
+    } else {
+      replay(op, args, tr.arrays);
+    }
+    args = next_args;
+    //a record can close several nested loops at once
+    while (!loops_.empty() && loops_.back().end == i){
+      Loop& loop = loops_.back();
+      if (--loop.remaining > 0){
+        i = loop.begin;
+        args = loop.args;
+        break;
+      }
+      loops_.pop_back();
+    }
+  }
+
+  if (tid() == 0){
+    std::cout << "Compact replay finalized on rank 0 - trace "
+              << trace_file_ << " successful!" << std::endl;
+  }
+  return 0;
+}
+
+void
+CompactReplay::replay(CompactOp op, const int32_t* a, const int32_t* arrays)
+{
+  switch(op){
+  case CompactOp::Init: {
+    mpi_->init(nullptr, nullptr);
+    if (trace_->nranks() != int(mpi_->commWorld()->size())){
+      spkt_abort_printf("compact trace %s has %d ranks, but the job has %d",
+                        trace_file_.c_str(), trace_->nranks(),
+                        int(mpi_->commWorld()->size()));
+    }
+    types_.resize(trace_->ntypes());
+    for (int i=0; i < trace_->ntypes(); ++i){
+      int size = trace_->typeSize(i);
+      if (size <= 0){
+        spkt_abort_printf("compact trace %s has invalid size %d for type %d",
+                          trace_file_.c_str(), size, i);
+      }
+      //builtins are keyed by size - walk down to the largest divisor
+      auto iter = MpiType::builtins.upper_bound(size);
+      while (iter != MpiType::builtins.begin()){
+        --iter;
+        if (size % iter->first == 0) break;
+      }
+      types_[i].id = iter->second.id;
+      types_[i].scale = size / iter->first;
+    }
+    break;
+  }
+  case CompactOp::Finalize:
+    mpi_->finalize();
+    break;
+  case CompactOp::Compute:
+    computeGap(uint64_t(uint32_t(a[0])) | (uint64_t(uint32_t(a[1])) << 32));
+    break;
+  case CompactOp::Send:
+    mpi_->send(nullptr, count(a[0],a[1]), type(a[1]), peer(a[2]), tag(a[3]), comm(a[4]));
+    break;
+  case CompactOp::Recv:
+    mpi_->recv(nullptr, count(a[0],a[1]), type(a[1]), peer(a[2]), tag(a[3]), comm(a[4]),
+               MPI_STATUS_IGNORE);
+    break;
+  case CompactOp::Isend: {
+    MPI_Request req = a[5];
+    mpi_->isend(nullptr, count(a[0],a[1]), type(a[1]), peer(a[2]), tag(a[3]), comm(a[4]), &req);
+    break;
+  }
+  case CompactOp::Irecv: {
+    MPI_Request req = a[5];
+    mpi_->irecv(nullptr, count(a[0],a[1]), type(a[1]), peer(a[2]), tag(a[3]), comm(a[4]), &req);
+    break;
+  }
+  case CompactOp::Wait: {
+    MPI_Request req = a[0];
+    mpi_->wait(&req, MPI_STATUS_IGNORE);
+    break;
+  }
+  case CompactOp::Waitall:
+    reqs_.assign(arrays + a[0], arrays + a[0] + a[1]);
+    mpi_->waitall(a[1], reqs_.data(), MPI_STATUSES_IGNORE);
+    break;
+  case CompactOp::Sendrecv:
+    mpi_->sendrecv(nullptr, count(a[0],a[1]), type(a[1]), peer(a[2]), tag(a[3]),
+                   nullptr, count(a[4],a[5]), type(a[5]), peer(a[6]), tag(a[7]),
+                   comm(a[8]), MPI_STATUS_IGNORE);
+    break;
+  case CompactOp::Barrier:
+    mpi_->barrier(comm(a[0]));
+    break;
+  case CompactOp::Bcast:
+    mpi_->bcast(count(a[0],a[1]), type(a[1]), peer(a[2]), comm(a[3]));
+    break;
+  case CompactOp::Reduce:
+    mpi_->reduce(count(a[0],a[1]), type(a[1]), MPI_SUM, peer(a[2]), comm(a[3]));
+    break;
+  case CompactOp::Allreduce:
+    mpi_->allreduce(count(a[0],a[1]), type(a[1]), MPI_SUM, comm(a[2]));
+    break;
+  case CompactOp::Scan:
+    mpi_->scan(count(a[0],a[1]), type(a[1]), MPI_SUM, comm(a[2]));
+    break;
+  case CompactOp::ReduceScatter:
+    mpi_->reduceScatter(const_cast<int*>(counts(arrays, a[0], a[1], a[2], recv_counts_)),
+                        type(a[2]), MPI_SUM, comm(a[3]));
+    break;
+  case CompactOp::Allgather:
+    mpi_->allgather(count(a[0],a[1]), type(a[1]), count(a[2],a[3]), type(a[3]), comm(a[4]));
+    break;
+  case CompactOp::Allgatherv:
+    mpi_->allgatherv(count(a[0],a[1]), type(a[1]),
+                     counts(arrays, a[2], a[3], a[4], recv_counts_), type(a[4]), comm(a[5]));
+    break;
+  case CompactOp::Alltoall:
+    mpi_->alltoall(count(a[0],a[1]), type(a[1]), count(a[2],a[3]), type(a[3]), comm(a[4]));
+    break;
+  case CompactOp::Alltoallv:
+    mpi_->alltoallv(counts(arrays, a[0], a[2], a[3], send_counts_), type(a[3]),
+                    counts(arrays, a[1], a[2], a[4], recv_counts_), type(a[4]), comm(a[5]));
+    break;
+  case CompactOp::Gather:
+    mpi_->gather(count(a[0],a[1]), type(a[1]), count(a[2],a[3]), type(a[3]), peer(a[4]), comm(a[5]));
+    break;
+  case CompactOp::Gatherv:
+    mpi_->gatherv(count(a[0],a[1]), type(a[1]), counts(arrays, a[2], a[3], a[4], recv_counts_),
+                  type(a[4]), peer(a[5]), comm(a[6]));
+    break;
+  case CompactOp::Scatter:
+    mpi_->scatter(count(a[0],a[1]), type(a[1]), count(a[2],a[3]), type(a[3]), peer(a[4]), comm(a[5]));
+    break;
+  case CompactOp::Scatterv:
+    mpi_->scatterv(counts(arrays, a[0], a[1], a[2], send_counts_), type(a[2]),
+                   count(a[3],a[4]), type(a[4]), peer(a[5]), comm(a[6]));
+    break;
+  case CompactOp::CommDup: {
+    MPI_Comm newcomm = comm(a[1]);
+    mpi_->commDup(comm(a[0]), &newcomm);
+    break;
+  }
+  case CompactOp::CommSplit: {
+    MPI_Comm newcomm = comm(a[3]);
+    mpi_->commSplit(comm(a[0]), a[1] == compact_undefined ? MPI_UNDEFINED : a[1],
+                    a[2], &newcomm);
+    break;
+  }
+  case CompactOp::CommCreate: {
+    MPI_Comm newcomm = comm(a[2]);
+    mpi_->commCreate(comm(a[0]), a[1], &newcomm);
+    break;
+  }
+  case CompactOp::CommGroup: {
+    MPI_Group grp = a[1];
+    mpi_->commGroup(comm(a[0]), &grp);
+    break;
+  }
+  case CompactOp::CommFree: {
+    MPI_Comm c = comm(a[0]);
+    mpi_->commFree(&c);
+    break;
+  }
+  case CompactOp::GroupIncl: {
+    MPI_Group grp = a[3];
+    mpi_->groupIncl(a[0], a[2], arrays + a[1], &grp);
+    break;
+  }
+  case CompactOp::Loop:
+  case CompactOp::NumOps:
+    break;
+  }
+}
+
+}
@@ -0,0 +1,170 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#ifndef SSTMAC_SKELETONS_COMPACT_REPLAY_COMPACT_REPLAY_H_INCLUDED
+#define SSTMAC_SKELETONS_COMPACT_REPLAY_COMPACT_REPLAY_H_INCLUDED
+
+#include <sstmac/software/process/app.h>
+#include <sstmac/skeletons/compact_replay/compact_trace.h>
+#include <sumi-mpi/mpi_api_fwd.h>
+#include <sumi-mpi/mpi_types.h>
+
+namespace sumi {
+
+/**
+ * Replays a compact trace written by sstmac_trace_convert.
+ * Calls are read in place from the shared memory mapping of the trace,
+ * and loops are replayed by rewinding into their records, never unrolled.
+ */
+class CompactReplay : public sstmac::sw::App
+{
+ public:
+  SST_ELI_REGISTER_DERIVED(
+    sstmac::sw::App,
+    CompactReplay,
+    "macro",
+    "compact_replay",
+    SST_ELI_ELEMENT_VERSION(1,0,0),
+    "application for replaying compact binary MPI traces")
+
+  CompactReplay(SST::Params& params, sstmac::sw::SoftwareId sid,
+                sstmac::sw::OperatingSystem* os);
+
+  ~CompactReplay() throw () override;
+
+  int skeletonMain() override;
+
+ private:
+  /**
+   * @param op
+   * @param args The arguments of the call
+   * @param arrays The array column of the rank
+   */
+  void replay(CompactOp op, const int32_t* args, const int32_t* arrays);
+
+  void computeGap(uint64_t nsec);
+
+  MPI_Datatype type(int32_t id) const {
+    return types_[id].id;
+  }
+
+  int count(int32_t n, int32_t id) const {
+    return n * types_[id].scale;
+  }
+
+  /**
+   * @param offset The offset of the counts in the array column
+   * @param n The number of counts
+   * @param id The trace type id the counts refer to
+   * @param scratch Storage for the rescaled counts, if the type needs scaling
+   * @return The counts in units of the MPI datatype for the trace type
+   */
+  const int* counts(const int32_t* arrays, int32_t offset, int32_t n,
+                    int32_t id, std::vector<int>& scratch) const;
+
+  static MPI_Comm comm(int32_t id){
+    switch(id){
+    case compact_comm_world: return MPI_COMM_WORLD;
+    case compact_comm_self: return MPI_COMM_SELF;
+    case compact_comm_null: return MPI_COMM_NULL;
+    default: return id;
+    }
+  }
+
+  static int peer(int32_t id){
+    switch(id){
+    case compact_any_source: return MPI_ANY_SOURCE;
+    case compact_root: return MPI_ROOT;
+    case compact_proc_null: return MPI_PROC_NULL;
+    default: return id;
+    }
+  }
+
+  static int tag(int32_t id){
+    return id == compact_any_tag ? MPI_ANY_TAG : id;
+  }
+
+  std::string trace_file_;
+
+  double timescaling_;
+
+  MpiApi* mpi_;
+
+  CompactTraceFile* trace_;
+
+  /**
+   * Trace types are mapped onto the largest builtin whose size divides them,
+   * with counts scaled up to match. Derived types would get a different id
+   * on each rank, which breaks the ids carried in collective headers.
+   */
+  struct TraceType {
+    MPI_Datatype id;
+    int scale;
+  };
+
+  /// The MPI datatype for each dense type id in the trace
+  std::vector<TraceType> types_;
+
+  /// Scratch space for request arrays, which MPI overwrites on completion
+  std::vector<MPI_Request> reqs_;
+
+  struct Loop {
+    uint64_t begin;
+    uint64_t end;
+    const int32_t* args;
+    int32_t remaining;
+  };
+
+  /// The loops being expanded, innermost last
+  std::vector<Loop> loops_;
+
+  /// Scratch space for rescaled send and recv count arrays
+  std::vector<int> send_counts_;
+  std::vector<int> recv_counts_;
+
+};
+
+}
+
+#endif
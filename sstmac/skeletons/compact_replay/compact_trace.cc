@@ -0,0 +1,581 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#include <sstmac/skeletons/compact_replay/compact_trace.h>
+#include <sprockit/errors.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace sumi {
+
+static const char compact_trace_magic[8] = {'S','S','T','M','C','T','R','C'};
+static const uint32_t compact_trace_version = 2;
+//version 1 traces are read unchanged - they only lack Loop records
+static const uint32_t compact_trace_min_version = 1;
+
+/**
+ * @param op
+ * @param offsets The argument indices of the array offsets
+ * @return The argument index of the array length, -1 if the op has no arrays
+ */
+static int
+arrayArgs(CompactOp op, int offsets[2])
+{
+  offsets[0] = offsets[1] = -1;
+  switch(op){
+  case CompactOp::Waitall:
+  case CompactOp::ReduceScatter:
+  case CompactOp::Scatterv:
+    offsets[0] = 0;
+    return 1;
+  case CompactOp::Allgatherv:
+  case CompactOp::Gatherv:
+    offsets[0] = 2;
+    return 3;
+  case CompactOp::GroupIncl:
+    offsets[0] = 1;
+    return 2;
+  case CompactOp::Alltoallv:
+    offsets[0] = 0;
+    offsets[1] = 1;
+    return 2;
+  default:
+    return -1;
+  }
+}
+
+/**
+ * Folds repeated record sequences of a rank into Loop records. Each call is
+ * reduced to a symbol covering its op, arguments, and array contents, so
+ * iterations match regardless of their compute gaps or array offsets.
+ * A greedy pass picks the repetition at each position that removes the most
+ * records, then compresses the loop body recursively to find inner loops.
+ */
+class LoopCompressor
+{
+ public:
+  LoopCompressor(std::vector<uint8_t>& ops, std::vector<uint32_t>& gaps,
+                 std::vector<int32_t>& args, std::vector<int32_t>& arrays,
+                 int max_body) :
+    ops_(ops), gaps_(gaps), args_(args), arrays_(arrays),
+    max_body_(max_body), nloops_(0)
+  {
+  }
+
+  /**
+   * Rewrite the columns in place
+   * @return The number of loops
+   */
+  uint64_t compress();
+
+ private:
+  struct Token {
+    int32_t sym;
+    uint64_t call;
+    uint64_t niter; //0 for a call
+    uint64_t min_nsec;
+    uint64_t max_nsec;
+    std::vector<Token> body;
+    /** The gaps of every record this token expands to, in order */
+    std::vector<uint64_t> gaps;
+  };
+
+  int32_t symbol(const std::vector<int32_t>& key){
+    auto iter = symbols_.find(key);
+    if (iter == symbols_.end()){
+      int32_t sym = symbols_.size();
+      symbols_[key] = sym;
+      return sym;
+    }
+    return iter->second;
+  }
+
+  static bool same(const std::vector<Token>& seq, size_t a, size_t b, size_t len){
+    for (size_t i=0; i < len; ++i){
+      if (seq[a+i].sym != seq[b+i].sym) return false;
+    }
+    return true;
+  }
+
+  void compressSeq(std::vector<Token>& seq);
+
+  Token makeLoop(std::vector<Token>& seq, size_t start, size_t len, size_t niter);
+
+  void emit(const Token& t, std::vector<uint64_t>::const_iterator& gap);
+
+  std::vector<uint8_t>& ops_;
+  std::vector<uint32_t>& gaps_;
+  std::vector<int32_t>& args_;
+  std::vector<int32_t>& arrays_;
+  size_t max_body_;
+  uint64_t nloops_;
+  std::map<std::vector<int32_t>, int32_t> symbols_;
+  std::vector<uint64_t> arg_offsets_;
+  std::vector<uint8_t> new_ops_;
+  std::vector<uint32_t> new_gaps_;
+  std::vector<int32_t> new_args_;
+  std::vector<int32_t> new_arrays_;
+};
+
+uint64_t
+LoopCompressor::compress()
+{
+  std::vector<Token> seq(ops_.size());
+  std::vector<int32_t> key;
+  uint64_t offset = 0;
+  arg_offsets_.resize(ops_.size());
+  for (size_t i=0; i < ops_.size(); ++i){
+    CompactOp op = CompactOp(ops_[i]);
+    const int32_t* args = args_.data() + offset;
+    int nargs = compact_op_nargs[ops_[i]];
+    key.assign(1, int32_t(op));
+    key.insert(key.end(), args, args + nargs);
+    int offsets[2];
+    int len_idx = arrayArgs(op, offsets);
+    for (int a=0; a < 2 && len_idx >= 0; ++a){
+      if (offsets[a] < 0) continue;
+      //match array contents, not where the converter happened to put them
+      key[1 + offsets[a]] = -1;
+      const int32_t* vals = arrays_.data() + args[offsets[a]];
+      key.insert(key.end(), vals, vals + args[len_idx]);
+    }
+    Token& t = seq[i];
+    t.sym = symbol(key);
+    t.call = i;
+    t.niter = 0;
+    t.gaps.assign(1, gaps_[i]);
+    arg_offsets_[i] = offset;
+    offset += nargs;
+  }
+
+  compressSeq(seq);
+
+  new_ops_.reserve(seq.size());
+  new_gaps_.reserve(seq.size());
+  for (const Token& t : seq){
+    auto gap = t.gaps.cbegin();
+    emit(t, gap);
+  }
+  ops_.swap(new_ops_);
+  gaps_.swap(new_gaps_);
+  args_.swap(new_args_);
+  arrays_.swap(new_arrays_);
+  return nloops_;
+}
+
+void
+LoopCompressor::compressSeq(std::vector<Token>& seq)
+{
+  size_t n = seq.size();
+  //the next position holding the same symbol - the only candidate loop lengths
+  std::vector<size_t> next(n, n);
+  std::unordered_map<int32_t,size_t> last;
+  for (size_t i=n; i > 0; --i){
+    auto iter = last.find(seq[i-1].sym);
+    if (iter != last.end()){
+      next[i-1] = iter->second;
+      iter->second = i-1;
+    } else {
+      last[seq[i-1].sym] = i-1;
+    }
+  }
+
+  std::vector<Token> out;
+  size_t i = 0;
+  while (i < n){
+    size_t best_len = 0;
+    size_t best_iter = 0;
+    size_t best_saved = 0;
+    for (size_t j=next[i]; j < n && j - i <= max_body_; j = next[j]){
+      size_t len = j - i;
+      size_t niter = 1;
+      while (i + (niter+1)*len <= n && niter < INT32_MAX
+             && same(seq, i, i + niter*len, len)){
+        ++niter;
+      }
+      size_t saved = (niter - 1) * len;
+      if (saved > best_saved){
+        best_len = len;
+        best_iter = niter;
+        best_saved = saved;
+      }
+    }
+    if (best_saved){
+      out.push_back(makeLoop(seq, i, best_len, best_iter));
+      i += best_len * best_iter;
+    } else {
+      out.push_back(std::move(seq[i]));
+      ++i;
+    }
+  }
+  seq.swap(out);
+}
+
+LoopCompressor::Token
+LoopCompressor::makeLoop(std::vector<Token>& seq, size_t start, size_t len, size_t niter)
+{
+  ++nloops_;
+  Token loop;
+  loop.call = 0;
+  loop.niter = niter;
+  loop.min_nsec = UINT64_MAX;
+  loop.max_nsec = 0;
+
+  //replay the mean gap at each position and record the spread of iteration times
+  std::vector<uint64_t> sums;
+  for (size_t it=0; it < niter; ++it){
+    uint64_t total = 0;
+    size_t k = 0;
+    for (size_t t=0; t < len; ++t){
+      for (uint64_t g : seq[start + it*len + t].gaps){
+        if (k == sums.size()) sums.push_back(0);
+        sums[k++] += g;
+        total += g;
+      }
+    }
+    loop.min_nsec = std::min(loop.min_nsec, total);
+    loop.max_nsec = std::max(loop.max_nsec, total);
+  }
+
+  loop.body.reserve(len);
+  size_t k = 0;
+  for (size_t t=0; t < len; ++t){
+    Token& tok = seq[start + t];
+    for (uint64_t& g : tok.gaps){
+      g = (sums[k++] + niter/2) / niter;
+    }
+    loop.body.push_back(std::move(tok));
+  }
+  compressSeq(loop.body);
+
+  std::vector<int32_t> key = {-1, int32_t(niter)};
+  loop.gaps.assign(1, 0);
+  for (const Token& t : loop.body){
+    key.push_back(t.sym);
+    loop.gaps.insert(loop.gaps.end(), t.gaps.begin(), t.gaps.end());
+  }
+  loop.sym = symbol(key);
+  return loop;
+}
+
+void
+LoopCompressor::emit(const Token& t, std::vector<uint64_t>::const_iterator& gap)
+{
+  new_gaps_.push_back(*gap++);
+  if (t.niter){
+    new_ops_.push_back(uint8_t(CompactOp::Loop));
+    size_t loop_args = new_args_.size();
+    size_t first = new_ops_.size();
+    new_args_.insert(new_args_.end(), {int32_t(t.niter), 0,
+                     int32_t(std::min<uint64_t>(t.min_nsec, INT32_MAX)),
+                     int32_t(std::min<uint64_t>(t.max_nsec, INT32_MAX))});
+    for (const Token& b : t.body){
+      emit(b, gap);
+    }
+    new_args_[loop_args + 1] = new_ops_.size() - first;
+  } else {
+    uint8_t op = ops_[t.call];
+    const int32_t* args = args_.data() + arg_offsets_[t.call];
+    size_t first = new_args_.size();
+    new_ops_.push_back(op);
+    new_args_.insert(new_args_.end(), args, args + compact_op_nargs[op]);
+    int offsets[2];
+    int len_idx = arrayArgs(CompactOp(op), offsets);
+    for (int a=0; a < 2 && len_idx >= 0; ++a){
+      if (offsets[a] < 0) continue;
+      new_args_[first + offsets[a]] = new_arrays_.size();
+      const int32_t* vals = arrays_.data() + args[offsets[a]];
+      new_arrays_.insert(new_arrays_.end(), vals, vals + args[len_idx]);
+    }
+  }
+}
+
+CompactTraceWriter::CompactTraceWriter(const std::string& fname, int nranks,
+                                       const CompactTraceOptions& opts) :
+  fname_(fname),
+  opts_(opts),
+  ncalls_(0),
+  pos_(0),
+  rank_(-1),
+  pending_gap_(0),
+  ranks_(nranks)
+{
+  file_ = ::fopen(fname.c_str(), "wb");
+  if (!file_){
+    spkt_abort_printf("failed opening compact trace %s for writing", fname.c_str());
+  }
+  //the header is rewritten by finish once the table offsets are known
+  CompactTraceHeader hdr;
+  ::memset(&hdr, 0, sizeof(hdr));
+  ::fwrite(&hdr, sizeof(hdr), 1, file_);
+  pos_ = sizeof(hdr);
+}
+
+CompactTraceWriter::~CompactTraceWriter()
+{
+  if (file_) ::fclose(file_);
+}
+
+int32_t
+CompactTraceWriter::typeId(int64_t size)
+{
+  auto iter = type_ids_.find(size);
+  if (iter == type_ids_.end()){
+    int32_t id = type_sizes_.size();
+    type_sizes_.push_back(size);
+    type_ids_[size] = id;
+    return id;
+  }
+  return iter->second;
+}
+
+void
+CompactTraceWriter::beginRank(int rank)
+{
+  if (rank < 0 || rank >= int(ranks_.size())){
+    spkt_abort_printf("compact trace rank %d out of range for %d ranks",
+                      rank, int(ranks_.size()));
+  }
+  rank_ = rank;
+  pending_gap_ = 0;
+  ncalls_ = 0;
+  ops_.clear();
+  gaps_.clear();
+  args_.clear();
+  arrays_.clear();
+}
+
+void
+CompactTraceWriter::call(CompactOp op, std::initializer_list<int32_t> args)
+{
+  if (args.size() != compact_op_nargs[int(op)]){
+    spkt_abort_printf("compact trace op %d takes %d arguments, got %d",
+                      int(op), int(compact_op_nargs[int(op)]), int(args.size()));
+  }
+  if (pending_gap_ > UINT32_MAX){
+    uint64_t nsec = pending_gap_;
+    pending_gap_ = 0;
+    call(CompactOp::Compute, {int32_t(nsec & 0xFFFFFFFF), int32_t(nsec >> 32)});
+  }
+  ops_.push_back(uint8_t(op));
+  if (pending_gap_ >= opts_.min_gap_nsec){
+    gaps_.push_back(pending_gap_);
+    pending_gap_ = 0;
+  } else {
+    //carry a short gap forward so the total compute time is kept
+    gaps_.push_back(0);
+  }
+  args_.insert(args_.end(), args.begin(), args.end());
+  ++ncalls_;
+}
+
+int32_t
+CompactTraceWriter::array(const int32_t* vals, int n)
+{
+  int32_t offset = arrays_.size();
+  arrays_.insert(arrays_.end(), vals, vals + n);
+  return offset;
+}
+
+void
+CompactTraceWriter::pad()
+{
+  static const char zeros[8] = {0};
+  size_t rem = pos_ % 8;
+  if (rem){
+    ::fwrite(zeros, 1, 8 - rem, file_);
+    pos_ += 8 - rem;
+  }
+}
+
+template <class T>
+void
+CompactTraceWriter::writeColumn(const std::vector<T>& col, uint64_t& offset)
+{
+  pad();
+  offset = pos_;
+  if (!col.empty()){
+    ::fwrite(col.data(), sizeof(T), col.size(), file_);
+  }
+  pos_ += col.size() * sizeof(T);
+}
+
+CompactRankStats
+CompactTraceWriter::endRank()
+{
+  if (rank_ < 0){
+    spkt_abort_printf("CompactTraceWriter::endRank: no rank has begun");
+  }
+  CompactRankStats stats;
+  stats.ncalls = ncalls_;
+  stats.nloops = 0;
+  if (opts_.max_loop_body > 0){
+    LoopCompressor compressor(ops_, gaps_, args_, arrays_, opts_.max_loop_body);
+    stats.nloops = compressor.compress();
+  }
+  stats.nrecords = ops_.size();
+
+  CompactRankIndex& idx = ranks_[rank_];
+  idx.ncalls = ops_.size();
+  idx.nargs = args_.size();
+  idx.narray = arrays_.size();
+  writeColumn(ops_, idx.ops_offset);
+  writeColumn(gaps_, idx.gaps_offset);
+  writeColumn(args_, idx.args_offset);
+  writeColumn(arrays_, idx.array_offset);
+  rank_ = -1;
+  return stats;
+}
+
+void
+CompactTraceWriter::finish()
+{
+  CompactTraceHeader hdr;
+  ::memset(&hdr, 0, sizeof(hdr));
+  ::memcpy(hdr.magic, compact_trace_magic, sizeof(hdr.magic));
+  hdr.version = compact_trace_version;
+  hdr.nranks = ranks_.size();
+  hdr.ntypes = type_sizes_.size();
+  writeColumn(type_sizes_, hdr.type_offset);
+  writeColumn(ranks_, hdr.rank_offset);
+  ::fseek(file_, 0, SEEK_SET);
+  ::fwrite(&hdr, sizeof(hdr), 1, file_);
+  if (::fclose(file_) != 0){
+    spkt_abort_printf("failed writing compact trace %s", fname_.c_str());
+  }
+  file_ = nullptr;
+}
+
+bool
+CompactTraceFile::isCompactTrace(const std::string& fname)
+{
+  std::ifstream in(fname, std::ios::binary);
+  char magic[sizeof(compact_trace_magic)];
+  if (!in.read(magic, sizeof(magic))) return false;
+  return ::memcmp(magic, compact_trace_magic, sizeof(magic)) == 0;
+}
+
+CompactTraceFile*
+CompactTraceFile::get(const std::string& fname)
+{
+  static std::mutex lock;
+  static std::map<std::string, CompactTraceFile*> files;
+  std::lock_guard<std::mutex> guard(lock);
+  CompactTraceFile*& file = files[fname];
+  if (!file){
+    file = new CompactTraceFile(fname);
+  }
+  return file;
+}
+
+CompactTraceFile::CompactTraceFile(const std::string& fname)
+{
+  int fd = ::open(fname.c_str(), O_RDONLY);
+  if (fd < 0){
+    spkt_abort_printf("failed opening compact trace %s", fname.c_str());
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(CompactTraceHeader)){
+    spkt_abort_printf("compact trace %s is truncated", fname.c_str());
+  }
+  size_ = st.st_size;
+  void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED){
+    spkt_abort_printf("failed mapping compact trace %s", fname.c_str());
+  }
+  data_ = (const char*) mapping;
+
+  ::memcpy(&hdr_, data_, sizeof(hdr_));
+  if (::memcmp(hdr_.magic, compact_trace_magic, sizeof(hdr_.magic)) != 0){
+    spkt_abort_printf("%s is not a compact trace", fname.c_str());
+  }
+  if (hdr_.version < compact_trace_min_version || hdr_.version > compact_trace_version){
+    spkt_abort_printf("compact trace %s has version %u, expected %u to %u",
+                      fname.c_str(), hdr_.version, compact_trace_min_version,
+                      compact_trace_version);
+  }
+  if (hdr_.type_offset + hdr_.ntypes*sizeof(int64_t) > size_
+      || hdr_.rank_offset + hdr_.nranks*sizeof(CompactRankIndex) > size_){
+    spkt_abort_printf("compact trace %s is truncated", fname.c_str());
+  }
+  type_sizes_ = (const int64_t*) (data_ + hdr_.type_offset);
+  ranks_ = (const CompactRankIndex*) (data_ + hdr_.rank_offset);
+  for (uint32_t r=0; r < hdr_.nranks; ++r){
+    const CompactRankIndex& idx = ranks_[r];
+    if (idx.array_offset + idx.narray*sizeof(int32_t) > size_){
+      spkt_abort_printf("compact trace %s is truncated in rank %u", fname.c_str(), r);
+    }
+  }
+}
+
+CompactTraceFile::~CompactTraceFile()
+{
+  ::munmap(const_cast<char*>(data_), size_);
+}
+
+CompactTraceFile::RankTrace
+CompactTraceFile::rank(int r) const
+{
+  if (r < 0 || r >= int(hdr_.nranks)){
+    spkt_abort_printf("rank %d is not in a compact trace of %u ranks", r, hdr_.nranks);
+  }
+  const CompactRankIndex& idx = ranks_[r];
+  RankTrace tr;
+  tr.ncalls = idx.ncalls;
+  tr.ops = (const uint8_t*) (data_ + idx.ops_offset);
+  tr.gaps = (const uint32_t*) (data_ + idx.gaps_offset);
+  tr.args = (const int32_t*) (data_ + idx.args_offset);
+  tr.arrays = (const int32_t*) (data_ + idx.array_offset);
+  return tr;
+}
+
+}
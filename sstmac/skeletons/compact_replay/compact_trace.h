@@ -0,0 +1,296 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#ifndef SSTMAC_SKELETONS_COMPACT_REPLAY_COMPACT_TRACE_H_INCLUDED
+#define SSTMAC_SKELETONS_COMPACT_REPLAY_COMPACT_TRACE_H_INCLUDED
+
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace sumi {
+
+/**
+ * Calls recorded in a compact trace. All handles are dense per-rank integers
+ * assigned by the converter, so replay never consults a lookup table:
+ *  - communicators: 0 is world, 1 is self, -1 is null, then creation order
+ *  - groups: 0 is the world group, then creation order
+ *  - requests: small slots that are recycled once a request completes
+ *  - datatypes: an index into the size table in the file header
+ * Array arguments (e.g. v-collective counts) are an (offset,length) pair
+ * into the rank's array column. Nonblocking completions are canonicalized
+ * by the converter: tests that failed are dropped and waitany/waitsome/
+ * successful tests become a Wait or Waitall on the requests that completed.
+ * A Loop repeats the records that follow it, so repeated call sequences
+ * are stored once. Loops nest, and a loop's records hold the compute gaps
+ * averaged over every iteration it replaces. Loops were added in version 2
+ * of the format. Version 1 traces have none and are otherwise the same.
+ */
+enum class CompactOp : uint8_t {
+  Init,          //
+  Finalize,      //
+  Compute,       // nsec_lo, nsec_hi - a gap too long for the gap column
+  Send,          // count, type, dest, tag, comm
+  Recv,          // count, type, src, tag, comm
+  Isend,         // count, type, dest, tag, comm, req
+  Irecv,         // count, type, src, tag, comm, req
+  Wait,          // req
+  Waitall,       // reqs, nreqs
+  Sendrecv,      // scount, stype, dest, stag, rcount, rtype, src, rtag, comm
+  Barrier,       // comm
+  Bcast,         // count, type, root, comm
+  Reduce,        // count, type, root, comm
+  Allreduce,     // count, type, comm
+  Scan,          // count, type, comm
+  ReduceScatter, // rcounts, nranks, type, comm
+  Allgather,     // scount, stype, rcount, rtype, comm
+  Allgatherv,    // scount, stype, rcounts, nranks, rtype, comm
+  Alltoall,      // scount, stype, rcount, rtype, comm
+  Alltoallv,     // scounts, rcounts, nranks, stype, rtype, comm
+  Gather,        // scount, stype, rcount, rtype, root, comm
+  Gatherv,       // scount, stype, rcounts, nranks, rtype, root, comm
+  Scatter,       // scount, stype, rcount, rtype, root, comm
+  Scatterv,      // scounts, nranks, stype, rcount, rtype, root, comm
+  CommDup,       // comm, newcomm
+  CommSplit,     // comm, color, key, newcomm
+  CommCreate,    // comm, group, newcomm
+  CommGroup,     // comm, newgroup
+  CommFree,      // comm
+  GroupIncl,     // group, ranks, nranks, newgroup
+  Loop,          // niter, nrecords, min_nsec, max_nsec - per-iteration compute
+  NumOps
+};
+
+/** The number of int32 arguments each op consumes from the argument column */
+static constexpr uint8_t compact_op_nargs[] = {
+  0, 0, 2, 5, 5, 6, 6, 1, 2, 9, 1, 4, 4, 3, 3, 4, 5, 6,
+  5, 6, 6, 7, 6, 7, 2, 4, 3, 2, 1, 4, 4
+};
+static_assert(sizeof(compact_op_nargs) == size_t(CompactOp::NumOps),
+              "every compact op needs an argument count");
+
+/** Special values for ranks, tags, and colors */
+static constexpr int32_t compact_any_source = -1;
+static constexpr int32_t compact_root = -2;
+static constexpr int32_t compact_proc_null = -3;
+static constexpr int32_t compact_any_tag = -1;
+static constexpr int32_t compact_undefined = -1;
+static constexpr int32_t compact_comm_world = 0;
+static constexpr int32_t compact_comm_self = 1;
+static constexpr int32_t compact_comm_null = -1;
+
+/**
+ * On-disk layout, native byte order with every section 8-byte aligned:
+ *   CompactTraceHeader
+ *   per rank, each a contiguous column:
+ *     uint8_t  ops[ncalls]    one per record, so a Loop counts once
+ *     uint32_t gaps[ncalls]   nanoseconds of compute before the record
+ *     int32_t  args[nargs]    compact_op_nargs[op] values per call
+ *     int32_t  arrays[narray] array arguments referenced from args
+ *   int64_t type_sizes[ntypes]
+ *   CompactRankIndex ranks[nranks]
+ */
+struct CompactTraceHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t nranks;
+  uint32_t ntypes;
+  uint32_t reserved;
+  uint64_t type_offset;
+  uint64_t rank_offset;
+};
+
+/**
+ * Preprocessing applied to each rank before its columns are written
+ */
+struct CompactTraceOptions {
+  /** The longest loop body in records to search for, 0 disables loop detection */
+  int max_loop_body = 256;
+  /** Compute gaps shorter than this are folded into the next longer gap */
+  uint64_t min_gap_nsec = 0;
+};
+
+struct CompactRankStats {
+  uint64_t ncalls;
+  uint64_t nrecords;
+  uint64_t nloops;
+};
+
+struct CompactRankIndex {
+  uint64_t ncalls;
+  uint64_t nargs;
+  uint64_t narray;
+  uint64_t ops_offset;
+  uint64_t gaps_offset;
+  uint64_t args_offset;
+  uint64_t array_offset;
+};
+
+/**
+ * @brief The CompactTraceWriter class
+ * Writes a compact trace one rank at a time so that only a single rank's
+ * columns are held in memory during conversion.
+ * Loops are only detected here, when a rank ends, so only traces written
+ * by sstmac_trace_convert have them. The DUMPI and OTF2 replay apps
+ * replay calls as they read them and never compress loops.
+ */
+class CompactTraceWriter
+{
+ public:
+  CompactTraceWriter(const std::string& fname, int nranks,
+                     const CompactTraceOptions& opts = CompactTraceOptions());
+
+  ~CompactTraceWriter();
+
+  /**
+   * @param size The size in bytes of a datatype
+   * @return The dense id of a datatype of that size
+   */
+  int32_t typeId(int64_t size);
+
+  void beginRank(int rank);
+
+  /**
+   * Add compute time to be replayed before the next call
+   * @param nsec
+   */
+  void gap(uint64_t nsec){
+    pending_gap_ += nsec;
+  }
+
+  void call(CompactOp op, std::initializer_list<int32_t> args = {});
+
+  /**
+   * @return The offset of the array to pass as an argument to a later call
+   */
+  int32_t array(const int32_t* vals, int n);
+
+  /**
+   * Compress the rank's calls into loops and write its columns
+   * @return The number of calls and of records written for the rank
+   */
+  CompactRankStats endRank();
+
+  /**
+   * Write the type and rank tables. The trace is unusable until this is called.
+   */
+  void finish();
+
+ private:
+  void pad();
+
+  template <class T> void writeColumn(const std::vector<T>& col, uint64_t& offset);
+
+  FILE* file_;
+  std::string fname_;
+  CompactTraceOptions opts_;
+  uint64_t ncalls_;
+  uint64_t pos_;
+  int rank_;
+  uint64_t pending_gap_;
+  std::vector<uint8_t> ops_;
+  std::vector<uint32_t> gaps_;
+  std::vector<int32_t> args_;
+  std::vector<int32_t> arrays_;
+  std::vector<int64_t> type_sizes_;
+  std::map<int64_t,int32_t> type_ids_;
+  std::vector<CompactRankIndex> ranks_;
+};
+
+/**
+ * @brief The CompactTraceFile class
+ * A read-only memory mapping of a compact trace. Replay reads the columns
+ * in place, and a single mapping is shared by every rank in the process.
+ */
+class CompactTraceFile
+{
+ public:
+  struct RankTrace {
+    uint64_t ncalls;
+    const uint8_t* ops;
+    const uint32_t* gaps;
+    const int32_t* args;
+    const int32_t* arrays;
+  };
+
+  /**
+   * @param fname
+   * @return The shared mapping of the file, opened on first use
+   */
+  static CompactTraceFile* get(const std::string& fname);
+
+  static bool isCompactTrace(const std::string& fname);
+
+  int nranks() const {
+    return hdr_.nranks;
+  }
+
+  int ntypes() const {
+    return hdr_.ntypes;
+  }
+
+  int64_t typeSize(int id) const {
+    return type_sizes_[id];
+  }
+
+  RankTrace rank(int r) const;
+
+ private:
+  CompactTraceFile(const std::string& fname);
+
+  ~CompactTraceFile();
+
+  const char* data_;
+  size_t size_;
+  CompactTraceHeader hdr_;
+  const int64_t* type_sizes_;
+  const CompactRankIndex* ranks_;
+};
+
+}
+
+#endif
@@ -0,0 +1,457 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#include <sstmac/skeletons/compact_replay/dumpi_to_compact.h>
+#include <sstmac/skeletons/compact_replay/compact_trace.h>
+#include <sstmac/dumpi_util/dumpi_meta.h>
+#include <sstmac/dumpi_util/dumpi_util.h>
+#include <sprockit/errors.h>
+#include <dumpi/libundumpi/libundumpi.h>
+#include <iostream>
+#include <map>
+#include <vector>
+
+namespace sumi {
+
+static_assert(sizeof(int) == sizeof(int32_t), "compact traces store int arguments as int32");
+
+/**
+ * Records the calls of one DUMPI rank into a compact trace, resolving
+ * every handle to its dense id as the call is read.
+ */
+class DumpiToCompact
+{
+ public:
+  DumpiToCompact(CompactTraceWriter* writer) :
+    writer_(writer)
+  {
+  }
+
+  CompactRankStats convert(const std::string& fname, int rank);
+
+ private:
+  template <class Prm, void (DumpiToCompact::*Fxn)(const Prm*)>
+  static int record(const Prm* prm, uint16_t /*thread*/,
+                    const dumpi_time* /*cpu*/, const dumpi_time* wall,
+                    const dumpi_perfinfo* /*perf*/, void* uarg)
+  {
+    DumpiToCompact* cv = static_cast<DumpiToCompact*>(uarg);
+    if (cv->started_){
+      int64_t nsec = int64_t(wall->start.sec - cv->last_stop_.sec) * 1000000000
+                     + (wall->start.nsec - cv->last_stop_.nsec);
+      if (nsec > 0) cv->writer_->gap(nsec);
+    }
+    (cv->*Fxn)(prm);
+    cv->last_stop_ = wall->stop;
+    cv->started_ = true;
+    return 1;
+  }
+
+  static libundumpi_callbacks* callbacks();
+
+  int32_t type(dumpi_datatype id){
+    int64_t size = id < sizes_.count ? sizes_.size[id] : sizeof(double);
+    return writer_->typeId(size);
+  }
+
+  static int32_t peer(int id){
+    if (id == DUMPI_ANY_SOURCE) return compact_any_source;
+    else if (id == DUMPI_ROOT) return compact_root;
+    else return id;
+  }
+
+  static int32_t tag(int t){
+    return t == DUMPI_ANY_TAG ? compact_any_tag : t;
+  }
+
+  int32_t comm(dumpi_comm id) const {
+    if (id == DUMPI_COMM_WORLD) return compact_comm_world;
+    else if (id == DUMPI_COMM_SELF) return compact_comm_self;
+    auto iter = comms_.find(id);
+    return iter == comms_.end() ? compact_comm_null : iter->second;
+  }
+
+  int32_t group(dumpi_group id){
+    auto iter = groups_.find(id);
+    return iter == groups_.end() ? 0 : iter->second;
+  }
+
+  /**
+   * Every comm creation consumes an id, even on ranks that get a null comm,
+   * so that ranks creating communicators collectively agree on the id.
+   */
+  int32_t newComm(dumpi_comm id){
+    int32_t dense = next_comm_++;
+    if (id == DUMPI_COMM_NULL) return compact_comm_null;
+    comms_[id] = dense;
+    return dense;
+  }
+
+  int32_t newRequest(dumpi_request id);
+
+  /**
+   * Emit a completion for whichever of the given requests are active
+   */
+  void complete(int count, const dumpi_request* reqs, const int* indices = nullptr);
+
+  int32_t array(int n, const int* vals){
+    return writer_->array(vals, n);
+  }
+
+  void init(const dumpi_init*){ writer_->call(CompactOp::Init); }
+  void initThread(const dumpi_init_thread*){ writer_->call(CompactOp::Init); }
+  void finalize(const dumpi_finalize*){ writer_->call(CompactOp::Finalize); }
+
+  template <class Prm> void skip(const Prm*){}
+
+  void send(const dumpi_send* p){
+    writer_->call(CompactOp::Send,
+      {p->count, type(p->datatype), peer(p->dest), tag(p->tag), comm(p->comm)});
+  }
+  void bsend(const dumpi_bsend* p){ send((const dumpi_send*) p); }
+  void ssend(const dumpi_ssend* p){ send((const dumpi_send*) p); }
+  void rsend(const dumpi_rsend* p){ send((const dumpi_send*) p); }
+
+  void recv(const dumpi_recv* p){
+    writer_->call(CompactOp::Recv,
+      {p->count, type(p->datatype), peer(p->source), tag(p->tag), comm(p->comm)});
+  }
+
+  void isend(const dumpi_isend* p){
+    writer_->call(CompactOp::Isend,
+      {p->count, type(p->datatype), peer(p->dest), tag(p->tag), comm(p->comm),
+       newRequest(p->request)});
+  }
+  void ibsend(const dumpi_ibsend* p){ isend((const dumpi_isend*) p); }
+  void issend(const dumpi_issend* p){ isend((const dumpi_isend*) p); }
+  void irsend(const dumpi_irsend* p){ isend((const dumpi_isend*) p); }
+
+  void irecv(const dumpi_irecv* p){
+    writer_->call(CompactOp::Irecv,
+      {p->count, type(p->datatype), peer(p->source), tag(p->tag), comm(p->comm),
+       newRequest(p->request)});
+  }
+
+  void wait(const dumpi_wait* p){ complete(1, &p->request); }
+  void test(const dumpi_test* p){ if (p->flag) complete(1, &p->request); }
+  void waitany(const dumpi_waitany* p){
+    if (p->index >= 0 && p->index < p->count) complete(1, &p->requests[p->index]);
+  }
+  void testany(const dumpi_testany* p){
+    if (p->flag && p->index >= 0 && p->index < p->count) complete(1, &p->requests[p->index]);
+  }
+  void waitall(const dumpi_waitall* p){ complete(p->count, p->requests); }
+  void testall(const dumpi_testall* p){ if (p->flag) complete(p->count, p->requests); }
+  void waitsome(const dumpi_waitsome* p){ complete(p->outcount, p->requests, p->indices); }
+  void testsome(const dumpi_testsome* p){ complete(p->outcount, p->requests, p->indices); }
+
+  void sendrecv(const dumpi_sendrecv* p){
+    writer_->call(CompactOp::Sendrecv,
+      {p->sendcount, type(p->sendtype), peer(p->dest), tag(p->sendtag),
+       p->recvcount, type(p->recvtype), peer(p->source), tag(p->recvtag),
+       comm(p->comm)});
+  }
+
+  void barrier(const dumpi_barrier* p){
+    writer_->call(CompactOp::Barrier, {comm(p->comm)});
+  }
+  void bcast(const dumpi_bcast* p){
+    writer_->call(CompactOp::Bcast, {p->count, type(p->datatype), peer(p->root), comm(p->comm)});
+  }
+  void reduce(const dumpi_reduce* p){
+    writer_->call(CompactOp::Reduce, {p->count, type(p->datatype), peer(p->root), comm(p->comm)});
+  }
+  void allreduce(const dumpi_allreduce* p){
+    writer_->call(CompactOp::Allreduce, {p->count, type(p->datatype), comm(p->comm)});
+  }
+  void scan(const dumpi_scan* p){
+    writer_->call(CompactOp::Scan, {p->count, type(p->datatype), comm(p->comm)});
+  }
+  void reduceScatter(const dumpi_reduce_scatter* p){
+    writer_->call(CompactOp::ReduceScatter,
+      {array(p->commsize, p->recvcounts), p->commsize, type(p->datatype), comm(p->comm)});
+  }
+  void allgather(const dumpi_allgather* p){
+    writer_->call(CompactOp::Allgather,
+      {p->sendcount, type(p->sendtype), p->recvcount, type(p->recvtype), comm(p->comm)});
+  }
+  void allgatherv(const dumpi_allgatherv* p){
+    writer_->call(CompactOp::Allgatherv,
+      {p->sendcount, type(p->sendtype), array(p->commsize, p->recvcounts), p->commsize,
+       type(p->recvtype), comm(p->comm)});
+  }
+  void alltoall(const dumpi_alltoall* p){
+    writer_->call(CompactOp::Alltoall,
+      {p->sendcount, type(p->sendtype), p->recvcount, type(p->recvtype), comm(p->comm)});
+  }
+  void alltoallv(const dumpi_alltoallv* p){
+    writer_->call(CompactOp::Alltoallv,
+      {array(p->commsize, p->sendcounts), array(p->commsize, p->recvcounts), p->commsize,
+       type(p->sendtype), type(p->recvtype), comm(p->comm)});
+  }
+  void gather(const dumpi_gather* p){
+    writer_->call(CompactOp::Gather,
+      {p->sendcount, type(p->sendtype), p->recvcount, type(p->recvtype),
+       peer(p->root), comm(p->comm)});
+  }
+  void gatherv(const dumpi_gatherv* p){
+    //the receive counts are only recorded at the root
+    int n = p->commrank == p->root ? p->commsize : 0;
+    writer_->call(CompactOp::Gatherv,
+      {p->sendcount, type(p->sendtype), array(n, p->recvcounts), n,
+       type(p->recvtype), peer(p->root), comm(p->comm)});
+  }
+  void scatter(const dumpi_scatter* p){
+    writer_->call(CompactOp::Scatter,
+      {p->sendcount, type(p->sendtype), p->recvcount, type(p->recvtype),
+       peer(p->root), comm(p->comm)});
+  }
+  void scatterv(const dumpi_scatterv* p){
+    int n = p->commrank == p->root ? p->commsize : 0;
+    writer_->call(CompactOp::Scatterv,
+      {array(n, p->sendcounts), n, type(p->sendtype), p->recvcount,
+       type(p->recvtype), peer(p->root), comm(p->comm)});
+  }
+
+  void commDup(const dumpi_comm_dup* p){
+    int32_t old = comm(p->oldcomm);
+    writer_->call(CompactOp::CommDup, {old, newComm(p->newcomm)});
+  }
+  void commSplit(const dumpi_comm_split* p){
+    int32_t old = comm(p->oldcomm);
+    writer_->call(CompactOp::CommSplit,
+      {old, p->color < 0 ? compact_undefined : p->color, p->key, newComm(p->newcomm)});
+  }
+  void commCreate(const dumpi_comm_create* p){
+    int32_t old = comm(p->oldcomm);
+    writer_->call(CompactOp::CommCreate, {old, group(p->group), newComm(p->newcomm)});
+  }
+  void commGroup(const dumpi_comm_group* p){
+    //the first user group is the world group, which always exists
+    if (p->group == DUMPI_FIRST_USER_GROUP) return;
+    int32_t dense = next_group_++;
+    groups_[p->group] = dense;
+    writer_->call(CompactOp::CommGroup, {comm(p->comm), dense});
+  }
+  void commFree(const dumpi_comm_free* p){
+    int32_t id = comm(p->comm);
+    if (id == compact_comm_null) return;
+    comms_.erase(p->comm);
+    writer_->call(CompactOp::CommFree, {id});
+  }
+  void groupIncl(const dumpi_group_incl* p){
+    int32_t old = group(p->group);
+    int32_t dense = next_group_++;
+    groups_[p->newgroup] = dense;
+    writer_->call(CompactOp::GroupIncl, {old, array(p->count, p->ranks), p->count, dense});
+  }
+
+  CompactTraceWriter* writer_;
+  dumpi_sizeof sizes_;
+  bool started_;
+  dumpi_clock last_stop_;
+  int32_t next_comm_;
+  int32_t next_group_;
+  std::map<dumpi_comm,int32_t> comms_;
+  std::map<dumpi_group,int32_t> groups_;
+  std::map<dumpi_request,int32_t> reqs_;
+  std::vector<int32_t> free_slots_;
+  int32_t next_slot_;
+  std::vector<int32_t> completed_;
+};
+
+int32_t
+DumpiToCompact::newRequest(dumpi_request id)
+{
+  int32_t slot;
+  if (free_slots_.empty()){
+    slot = next_slot_++;
+  } else {
+    slot = free_slots_.back();
+    free_slots_.pop_back();
+  }
+  auto iter = reqs_.find(id);
+  if (iter != reqs_.end()){
+    //the trace reused the id of a request that never completed
+    free_slots_.push_back(iter->second);
+  }
+  reqs_[id] = slot;
+  return slot;
+}
+
+void
+DumpiToCompact::complete(int count, const dumpi_request* reqs, const int* indices)
+{
+  completed_.clear();
+  for (int i=0; i < count; ++i){
+    dumpi_request id = indices ? reqs[indices[i]] : reqs[i];
+    auto iter = reqs_.find(id);
+    //null, persistent, and already completed requests have no slot
+    if (iter == reqs_.end()) continue;
+    completed_.push_back(iter->second);
+    reqs_.erase(iter);
+  }
+
+  if (completed_.size() == 1){
+    writer_->call(CompactOp::Wait, {completed_[0]});
+  } else if (!completed_.empty()){
+    writer_->call(CompactOp::Waitall,
+      {writer_->array(completed_.data(), completed_.size()), int32_t(completed_.size())});
+  }
+  //slots are only recycled after the completion is recorded
+  free_slots_.insert(free_slots_.end(), completed_.begin(), completed_.end());
+}
+
+libundumpi_callbacks*
+DumpiToCompact::callbacks()
+{
+  static libundumpi_callbacks* cbacks = nullptr;
+  if (cbacks) return cbacks;
+
+  cbacks = new libundumpi_callbacks;
+  libundumpi_clear_callbacks(cbacks);
+#define set_callback(field, prm, fxn) \
+  cbacks->field = &DumpiToCompact::record<prm, &DumpiToCompact::fxn>
+  set_callback(on_init, dumpi_init, init);
+  set_callback(on_init_thread, dumpi_init_thread, initThread);
+  set_callback(on_finalize, dumpi_finalize, finalize);
+  set_callback(on_send, dumpi_send, send);
+  set_callback(on_bsend, dumpi_bsend, bsend);
+  set_callback(on_ssend, dumpi_ssend, ssend);
+  set_callback(on_rsend, dumpi_rsend, rsend);
+  set_callback(on_recv, dumpi_recv, recv);
+  set_callback(on_isend, dumpi_isend, isend);
+  set_callback(on_ibsend, dumpi_ibsend, ibsend);
+  set_callback(on_issend, dumpi_issend, issend);
+  set_callback(on_irsend, dumpi_irsend, irsend);
+  set_callback(on_irecv, dumpi_irecv, irecv);
+  set_callback(on_wait, dumpi_wait, wait);
+  set_callback(on_test, dumpi_test, test);
+  set_callback(on_waitany, dumpi_waitany, waitany);
+  set_callback(on_testany, dumpi_testany, testany);
+  set_callback(on_waitall, dumpi_waitall, waitall);
+  set_callback(on_testall, dumpi_testall, testall);
+  set_callback(on_waitsome, dumpi_waitsome, waitsome);
+  set_callback(on_testsome, dumpi_testsome, testsome);
+  set_callback(on_sendrecv, dumpi_sendrecv, sendrecv);
+  set_callback(on_barrier, dumpi_barrier, barrier);
+  set_callback(on_bcast, dumpi_bcast, bcast);
+  set_callback(on_reduce, dumpi_reduce, reduce);
+  set_callback(on_allreduce, dumpi_allreduce, allreduce);
+  set_callback(on_scan, dumpi_scan, scan);
+  set_callback(on_reduce_scatter, dumpi_reduce_scatter, reduceScatter);
+  set_callback(on_allgather, dumpi_allgather, allgather);
+  set_callback(on_allgatherv, dumpi_allgatherv, allgatherv);
+  set_callback(on_alltoall, dumpi_alltoall, alltoall);
+  set_callback(on_alltoallv, dumpi_alltoallv, alltoallv);
+  set_callback(on_gather, dumpi_gather, gather);
+  set_callback(on_gatherv, dumpi_gatherv, gatherv);
+  set_callback(on_scatter, dumpi_scatter, scatter);
+  set_callback(on_scatterv, dumpi_scatterv, scatterv);
+  set_callback(on_comm_dup, dumpi_comm_dup, commDup);
+  set_callback(on_comm_split, dumpi_comm_split, commSplit);
+  set_callback(on_comm_create, dumpi_comm_create, commCreate);
+  set_callback(on_comm_group, dumpi_comm_group, commGroup);
+  set_callback(on_comm_free, dumpi_comm_free, commFree);
+  set_callback(on_group_incl, dumpi_group_incl, groupIncl);
+  //calls that are not replayed still end the preceding compute gap
+  set_callback(on_comm_rank, dumpi_comm_rank, skip<dumpi_comm_rank>);
+  set_callback(on_comm_size, dumpi_comm_size, skip<dumpi_comm_size>);
+  set_callback(on_request_free, dumpi_request_free, skip<dumpi_request_free>);
+  set_callback(on_group_free, dumpi_group_free, skip<dumpi_group_free>);
+#undef set_callback
+  return cbacks;
+}
+
+CompactRankStats
+DumpiToCompact::convert(const std::string& fname, int rank)
+{
+  started_ = false;
+  next_comm_ = compact_comm_self + 1;
+  next_group_ = 1;
+  next_slot_ = 0;
+  comms_.clear();
+  groups_.clear();
+  reqs_.clear();
+  free_slots_.clear();
+
+  dumpi_profile* profile = undumpi_open(fname.c_str());
+  if (profile == NULL){
+    spkt_abort_printf("failed opening DUMPI trace %s", fname.c_str());
+  }
+  sizes_ = undumpi_read_datatype_sizes(profile);
+  writer_->beginRank(rank);
+  int retval = undumpi_read_stream_full(fname.c_str(), profile, callbacks(), this, false);
+  undumpi_close(profile);
+  if (retval != 1){
+    spkt_abort_printf("failed reading DUMPI trace %s", fname.c_str());
+  }
+  return writer_->endRank();
+}
+
+void
+convertDumpiToCompact(const std::string& metafile, const std::string& outfile,
+                      bool print_progress, const CompactTraceOptions& opts)
+{
+  sstmac::sw::DumpiMeta meta(metafile);
+  int nranks = meta.numProcs();
+  CompactTraceWriter writer(outfile, nranks, opts);
+  DumpiToCompact converter(&writer);
+  for (int rank=0; rank < nranks; ++rank){
+    std::string fname = sstmac::sw::dumpiFileName(rank, meta.dirplusfileprefix_);
+    if (print_progress){
+      std::cout << "Converting rank " << rank << " of " << nranks
+                << ": " << fname << std::endl;
+    }
+    CompactRankStats stats = converter.convert(fname, rank);
+    if (print_progress){
+      std::cout << "  " << stats.ncalls << " calls written as "
+                << stats.nrecords << " records in "
+                << stats.nloops << " loops" << std::endl;
+    }
+  }
+  writer.finish();
+}
+
+}
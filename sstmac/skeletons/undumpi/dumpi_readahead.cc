@@ -0,0 +1,344 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#include <sstmac/skeletons/undumpi/dumpi_readahead.h>
+#include <sprockit/errors.h>
+#include <algorithm>
+#include <cstring>
+
+namespace sumi {
+
+DumpiReaderPool* DumpiReaderPool::pool_ = nullptr;
+
+void
+ownDumpiArrays(dumpi_init& prm, DeferredDumpiCall& /*call*/)
+{
+  //the trace arguments are meaningless to the simulated rank
+  prm.argc = 0;
+  prm.argv = nullptr;
+}
+
+void
+ownDumpiArrays(dumpi_init_thread& prm, DeferredDumpiCall& /*call*/)
+{
+  prm.argc = 0;
+  prm.argv = nullptr;
+}
+
+void
+ownDumpiArrays(dumpi_waitany& prm, DeferredDumpiCall& call)
+{
+  call.ownArray(prm.requests, prm.count);
+}
+
+void
+ownDumpiArrays(dumpi_testany& prm, DeferredDumpiCall& call)
+{
+  call.ownArray(prm.requests, prm.count);
+}
+
+void
+ownDumpiArrays(dumpi_waitall& prm, DeferredDumpiCall& call)
+{
+  call.ownArray(prm.requests, prm.count);
+}
+
+void
+ownDumpiArrays(dumpi_testall& prm, DeferredDumpiCall& call)
+{
+  call.ownArray(prm.requests, prm.count);
+}
+
+void
+ownDumpiArrays(dumpi_waitsome& prm, DeferredDumpiCall& call)
+{
+  call.ownArray(prm.requests, prm.count);
+  call.ownArray(prm.indices, prm.outcount);
+}
+
+void
+ownDumpiArrays(dumpi_testsome& prm, DeferredDumpiCall& call)
+{
+  call.ownArray(prm.requests, prm.count);
+  call.ownArray(prm.indices, prm.outcount);
+}
+
+void
+ownDumpiArrays(dumpi_startall& prm, DeferredDumpiCall& call)
+{
+  call.ownArray(prm.requests, prm.count);
+}
+
+void
+ownDumpiArrays(dumpi_type_indexed& prm, DeferredDumpiCall& call)
+{
+  call.ownArray(prm.lengths, prm.count);
+  call.ownArray(prm.indices, prm.count);
+}
+
+void
+ownDumpiArrays(dumpi_type_struct& prm, DeferredDumpiCall& call)
+{
+  call.ownArray(prm.lengths, prm.count);
+  call.ownArray(prm.indices, prm.count);
+  call.ownArray(prm.oldtypes, prm.count);
+}
+
+void
+ownDumpiArrays(dumpi_gatherv& prm, DeferredDumpiCall& call)
+{
+  //only recorded on the root
+  call.ownArray(prm.recvcounts, prm.commsize);
+}
+
+void
+ownDumpiArrays(dumpi_scatterv& prm, DeferredDumpiCall& call)
+{
+  //only recorded on the root
+  call.ownArray(prm.sendcounts, prm.commsize);
+}
+
+void
+ownDumpiArrays(dumpi_allgatherv& prm, DeferredDumpiCall& call)
+{
+  call.ownArray(prm.recvcounts, prm.commsize);
+}
+
+void
+ownDumpiArrays(dumpi_alltoallv& prm, DeferredDumpiCall& call)
+{
+  call.ownArray(prm.sendcounts, prm.commsize);
+  call.ownArray(prm.recvcounts, prm.commsize);
+}
+
+void
+ownDumpiArrays(dumpi_reduce_scatter& prm, DeferredDumpiCall& call)
+{
+  call.ownArray(prm.recvcounts, prm.commsize);
+}
+
+void
+ownDumpiArrays(dumpi_group_incl& prm, DeferredDumpiCall& call)
+{
+  call.ownArray(prm.ranks, prm.count);
+}
+
+DumpiCallStream::DumpiCallStream(const std::string& fname, size_t readahead,
+                                 bool print_progress) :
+  fname_(fname),
+  readahead_(readahead),
+  print_progress_(print_progress),
+  state_(pending),
+  cancelled_(false),
+  failed_(false),
+  queued_bytes_(0),
+  filling_bytes_(0)
+{
+  //several batches in flight let the reader and the rank overlap
+  batch_bytes_ = std::max(readahead_ / 8, size_t(4096));
+}
+
+void
+DumpiCallStream::push(DeferredDumpiCall* call)
+{
+  filling_bytes_ += call->bytes();
+  filling_.emplace_back(call);
+  if (filling_bytes_ >= batch_bytes_){
+    std::unique_lock<std::mutex> lock(DumpiReaderPool::pool_->lock_);
+    flush(lock);
+  }
+}
+
+void
+DumpiCallStream::flush(std::unique_lock<std::mutex>& lock)
+{
+  while (!cancelled_ && !batches_.empty() && queued_bytes_ + filling_bytes_ > readahead_){
+    space_.wait(lock);
+  }
+  if (!cancelled_){
+    batches_.emplace_back(std::move(filling_), filling_bytes_);
+    queued_bytes_ += filling_bytes_;
+    DumpiReaderPool::pool_->progress_.notify_all();
+  }
+  filling_ = Batch();
+  filling_bytes_ = 0;
+}
+
+void
+DumpiCallStream::decode(libundumpi_callbacks* cbacks)
+{
+  dumpi_profile* profile = undumpi_open(fname_.c_str());
+  if (profile == nullptr){
+    failed_ = true;
+  } else {
+    int retval = undumpi_read_stream_full(fname_.c_str(), profile, cbacks, this, print_progress_);
+    failed_ = retval != 1;
+    undumpi_close(profile);
+  }
+
+  DumpiReaderPool* pool = DumpiReaderPool::pool_;
+  std::unique_lock<std::mutex> lock(pool->lock_);
+  if (!filling_.empty()){
+    flush(lock);
+  }
+  state_ = done;
+  pool->progress_.notify_all();
+}
+
+DumpiReaderPool::DumpiReaderPool(int nthreads, libundumpi_callbacks* cbacks) :
+  cbacks_(cbacks),
+  nidle_(0)
+{
+  for (int i=0; i < nthreads; ++i){
+    readers_.emplace_back(&DumpiReaderPool::run, this);
+  }
+}
+
+DumpiReaderPool*
+DumpiReaderPool::get(int nthreads, libundumpi_callbacks* cbacks)
+{
+  static std::mutex init_lock;
+  std::lock_guard<std::mutex> guard(init_lock);
+  if (!pool_){
+    if (nthreads <= 0){
+      spkt_abort_printf("DUMPI reader pool needs at least one thread, got %d", nthreads);
+    }
+    //the pool lives until exit - reader threads may still be skipping cancelled traces
+    pool_ = new DumpiReaderPool(nthreads, cbacks);
+  }
+  return pool_;
+}
+
+std::shared_ptr<DumpiCallStream>
+DumpiReaderPool::start(const std::string& fname, size_t readahead, bool print_progress)
+{
+  auto stream = std::make_shared<DumpiCallStream>(fname, readahead, print_progress);
+  std::lock_guard<std::mutex> guard(lock_);
+  pending_.push_back(stream);
+  queued_.notify_one();
+  return stream;
+}
+
+void
+DumpiReaderPool::run()
+{
+  std::unique_lock<std::mutex> lock(lock_);
+  while (true){
+    while (pending_.empty()){
+      ++nidle_;
+      queued_.wait(lock);
+      --nidle_;
+    }
+    std::shared_ptr<DumpiCallStream> stream = pending_.front();
+    pending_.pop_front();
+    stream->state_ = DumpiCallStream::decoding;
+    progress_.notify_all();
+    lock.unlock();
+    stream->decode(cbacks_);
+    lock.lock();
+  }
+}
+
+bool
+DumpiReaderPool::next(DumpiCallStream* stream, DumpiCallStream::Batch& batch)
+{
+  std::unique_lock<std::mutex> lock(lock_);
+  while (true){
+    if (!stream->batches_.empty()){
+      auto& front = stream->batches_.front();
+      batch = std::move(front.first);
+      stream->queued_bytes_ -= front.second;
+      stream->batches_.pop_front();
+      stream->space_.notify_one();
+      return true;
+    }
+
+    switch (stream->state_){
+      case DumpiCallStream::pending: {
+        if (nidle_ > 0){
+          //a reader is about to pick up a trace
+          progress_.wait(lock);
+          break;
+        }
+        //every reader is tied up with other traces, which may be waiting
+        //on ranks that cannot run while this one waits
+        auto iter = std::find_if(pending_.begin(), pending_.end(),
+                     [stream](const std::shared_ptr<DumpiCallStream>& s){ return s.get() == stream; });
+        pending_.erase(iter);
+        stream->state_ = DumpiCallStream::decode_inline;
+        return false;
+      }
+      case DumpiCallStream::decode_inline:
+        return false;
+      case DumpiCallStream::done:
+        if (stream->failed_){
+          spkt_abort_printf("DUMPI reader failed on trace file %s", stream->fname_.c_str());
+        }
+        return false;
+      case DumpiCallStream::decoding:
+        //the reader only waits when this rank has records queued,
+        //so it is busy decoding the next batch
+        progress_.wait(lock);
+        break;
+    }
+  }
+}
+
+void
+DumpiReaderPool::cancel(DumpiCallStream* stream)
+{
+  std::lock_guard<std::mutex> guard(lock_);
+  stream->cancelled_ = true;
+  stream->batches_.clear();
+  stream->queued_bytes_ = 0;
+  if (stream->state_ == DumpiCallStream::pending){
+    auto iter = std::find_if(pending_.begin(), pending_.end(),
+                 [stream](const std::shared_ptr<DumpiCallStream>& s){ return s.get() == stream; });
+    pending_.erase(iter);
+    stream->state_ = DumpiCallStream::done;
+  }
+  stream->space_.notify_one();
+}
+
+}
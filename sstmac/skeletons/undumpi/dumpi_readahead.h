@@ -0,0 +1,286 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#ifndef SSTMAC_SOFTWARE_SKELETONS_UNDUMPI_DUMPI_READAHEAD_H_INCLUDED
+#define SSTMAC_SOFTWARE_SKELETONS_UNDUMPI_DUMPI_READAHEAD_H_INCLUDED
+
+#include <dumpi/libundumpi/libundumpi.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdint.h>
+
+namespace sumi {
+
+/**
+ * A single trace record decoded off the event thread. The record keeps
+ * private copies of every array the replay callbacks read, since libundumpi
+ * frees its own buffers as soon as the decode callback returns.
+ */
+class DeferredDumpiCall
+{
+ public:
+  virtual ~DeferredDumpiCall(){}
+
+  /**
+   * @brief Run the original parsedumpi callback on the saved record
+   * @param uarg The ParsedumpiCallbacks object of the replaying rank
+   */
+  virtual int replay(void* uarg) = 0;
+
+  size_t bytes() const {
+    return bytes_;
+  }
+
+  template <class T, class Count>
+  void ownArray(T*& array, Count count){
+    if (array == nullptr || count <= 0){
+      return;
+    }
+    size_t size = sizeof(T) * count;
+    char* copy = new char[size];
+    ::memcpy(copy, array, size);
+    arrays_.emplace_back(copy);
+    array = reinterpret_cast<T*>(copy);
+    bytes_ += size;
+  }
+
+ protected:
+  explicit DeferredDumpiCall(size_t bytes) : bytes_(bytes) {}
+
+ private:
+  std::vector<std::unique_ptr<char[]>> arrays_;
+  size_t bytes_;
+};
+
+/**
+ * Deep copies for records whose replay reads array arguments.
+ * Records without an overload here are copied by value.
+ */
+template <class Prm>
+void ownDumpiArrays(Prm& /*prm*/, DeferredDumpiCall& /*call*/){}
+
+void ownDumpiArrays(dumpi_init& prm, DeferredDumpiCall& call);
+void ownDumpiArrays(dumpi_init_thread& prm, DeferredDumpiCall& call);
+void ownDumpiArrays(dumpi_waitany& prm, DeferredDumpiCall& call);
+void ownDumpiArrays(dumpi_testany& prm, DeferredDumpiCall& call);
+void ownDumpiArrays(dumpi_waitall& prm, DeferredDumpiCall& call);
+void ownDumpiArrays(dumpi_testall& prm, DeferredDumpiCall& call);
+void ownDumpiArrays(dumpi_waitsome& prm, DeferredDumpiCall& call);
+void ownDumpiArrays(dumpi_testsome& prm, DeferredDumpiCall& call);
+void ownDumpiArrays(dumpi_startall& prm, DeferredDumpiCall& call);
+void ownDumpiArrays(dumpi_type_indexed& prm, DeferredDumpiCall& call);
+void ownDumpiArrays(dumpi_type_struct& prm, DeferredDumpiCall& call);
+void ownDumpiArrays(dumpi_gatherv& prm, DeferredDumpiCall& call);
+void ownDumpiArrays(dumpi_scatterv& prm, DeferredDumpiCall& call);
+void ownDumpiArrays(dumpi_allgatherv& prm, DeferredDumpiCall& call);
+void ownDumpiArrays(dumpi_alltoallv& prm, DeferredDumpiCall& call);
+void ownDumpiArrays(dumpi_reduce_scatter& prm, DeferredDumpiCall& call);
+void ownDumpiArrays(dumpi_group_incl& prm, DeferredDumpiCall& call);
+
+template <class Prm>
+using DumpiHandler = int (*)(const Prm*, uint16_t, const dumpi_time*,
+                             const dumpi_time*, const dumpi_perfinfo*, void*);
+
+template <class Prm, DumpiHandler<Prm> Handler>
+class DeferredDumpiCallImpl : public DeferredDumpiCall
+{
+ public:
+  DeferredDumpiCallImpl(const Prm* prm, uint16_t thread, const dumpi_time* cpu,
+                        const dumpi_time* wall, const dumpi_perfinfo* perf) :
+    DeferredDumpiCall(sizeof(DeferredDumpiCallImpl)),
+    prm_(*prm), thread_(thread), has_cpu_(cpu), has_wall_(wall)
+  {
+    if (cpu) cpu_ = *cpu;
+    if (wall) wall_ = *wall;
+    //perf counters are large and almost never recorded
+    if (perf && perf->count > 0){
+      perf_.reset(new dumpi_perfinfo(*perf));
+    }
+    ownDumpiArrays(prm_, *this);
+  }
+
+  int replay(void* uarg) override {
+    return Handler(&prm_, thread_, has_cpu_ ? &cpu_ : nullptr,
+                   has_wall_ ? &wall_ : nullptr, perf_.get(), uarg);
+  }
+
+ private:
+  Prm prm_;
+  uint16_t thread_;
+  bool has_cpu_;
+  bool has_wall_;
+  dumpi_time cpu_;
+  dumpi_time wall_;
+  std::unique_ptr<dumpi_perfinfo> perf_;
+};
+
+/**
+ * The decoded records of one rank's trace file. A reader thread fills
+ * batches of records while the simulated rank drains them. At most
+ * readahead bytes are held in memory, except that a single batch is
+ * always allowed so the reader cannot stall on an empty queue.
+ */
+class DumpiCallStream
+{
+ public:
+  typedef std::vector<std::unique_ptr<DeferredDumpiCall>> Batch;
+
+  DumpiCallStream(const std::string& fname, size_t readahead, bool print_progress);
+
+  const std::string& fname() const {
+    return fname_;
+  }
+
+  bool cancelled() const {
+    return cancelled_;
+  }
+
+  /**
+   * @brief Whether no reader thread picked up the trace before the rank
+   *        needed it. The rank then parses the file itself.
+   */
+  bool decodeInline() const {
+    return state_ == decode_inline;
+  }
+
+  /**
+   * @brief Called by libundumpi on the reader thread for every record
+   */
+  void push(DeferredDumpiCall* call);
+
+ private:
+  friend class DumpiReaderPool;
+
+  typedef enum {
+    pending,       //queued, no reader thread has started on it
+    decoding,      //a reader thread owns the file
+    decode_inline, //the rank parses the file itself
+    done
+  } state_t;
+
+  void decode(libundumpi_callbacks* cbacks);
+
+  void flush(std::unique_lock<std::mutex>& lock);
+
+  std::string fname_;
+  size_t readahead_;
+  size_t batch_bytes_;
+  bool print_progress_;
+  state_t state_;
+  std::atomic<bool> cancelled_;
+  bool failed_;
+
+  std::deque<std::pair<Batch,size_t>> batches_;
+  size_t queued_bytes_;
+  std::condition_variable space_;
+
+  Batch filling_;
+  size_t filling_bytes_;
+};
+
+/**
+ * A fixed set of reader threads shared by every parsedumpi rank in this
+ * process. libundumpi parses a whole file per call, so a reader owns its
+ * trace until the end of the file and waits while the rank's read-ahead
+ * budget is full. Traces are picked up in the order ranks start. A rank
+ * whose trace no reader has picked up by the time it needs records parses
+ * the file itself, so a rank never waits on readers tied up with other ranks.
+ */
+class DumpiReaderPool
+{
+ public:
+  /**
+   * @brief The process-wide pool, created on first use
+   * @param nthreads The number of reader threads
+   * @param cbacks The recording callbacks to run on each trace file
+   */
+  static DumpiReaderPool* get(int nthreads, libundumpi_callbacks* cbacks);
+
+  std::shared_ptr<DumpiCallStream> start(const std::string& fname,
+                                         size_t readahead, bool print_progress);
+
+  /**
+   * @brief Get the next batch of records. If a reader thread owns the trace,
+   *        this waits for at most the batch that reader is decoding.
+   * @param stream
+   * @param batch Filled with the next batch of records
+   * @return False if the stream has no more records or
+   *         if the rank must parse the trace itself (see decodeInline)
+   */
+  bool next(DumpiCallStream* stream, DumpiCallStream::Batch& batch);
+
+  /**
+   * @brief Drop all records not yet replayed. The reader thread
+   *        skips the remainder of the file.
+   */
+  void cancel(DumpiCallStream* stream);
+
+ private:
+  friend class DumpiCallStream;
+
+  DumpiReaderPool(int nthreads, libundumpi_callbacks* cbacks);
+
+  void run();
+
+  std::mutex lock_;
+  std::condition_variable queued_;
+  std::condition_variable progress_;
+  std::deque<std::shared_ptr<DumpiCallStream>> pending_;
+  std::vector<std::thread> readers_;
+  libundumpi_callbacks* cbacks_;
+  int nidle_;
+
+  static DumpiReaderPool* pool_;
+};
+
+}
+
+#endif
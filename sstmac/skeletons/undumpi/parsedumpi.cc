@@ -65,6 +65,8 @@ RegisterKeywords(
 { "parsedumpi_terminate_count", "the number of global collectives to run, then terminate" },
 { "launch_dumpi_metaname", "DEPRECATED: the meta file for the DUMPI trace" },
 { "dumpi_metaname", "the meta file for the DUMPI trace" },
+{ "parsedumpi_reader_threads", "the number of threads decoding DUMPI traces ahead of the simulation, one trace at a time, 0 to decode inline" },
+{ "parsedumpi_readahead_size", "the maximum decoded trace size held in memory per rank" },
 );
 
 namespace sumi{
@@ -84,6 +86,10 @@ ParseDumpi::ParseDumpi(SST::Params& params, SoftwareId sid,
   print_progress_ = params.find<bool>("parsedumpi_print_progress", true);
 
   early_terminate_count_ = params.find<int>("parsedumpi_terminate_count", -1);
+
+  reader_threads_ = params.find<int>("parsedumpi_reader_threads", 0);
+
+  readahead_size_ = params.find<SST::UnitAlgebra>("parsedumpi_readahead_size", "16MB").getRoundedValue();
 }
 
 ParseDumpi::~ParseDumpi() throw()
@@ -103,7 +109,16 @@ int ParseDumpi::skeletonMain()
   bool print_my_progress = rank == 0 && print_progress_;
 
   try {
-    cbacks.parseStream(fname.c_str(), print_my_progress);
+    if (reader_threads_ > 0){
+      auto* pool = DumpiReaderPool::get(reader_threads_, ParsedumpiCallbacks::deferredCallbacks());
+      auto stream = pool->start(fname, readahead_size_, print_my_progress);
+      cbacks.replayStream(pool, stream.get());
+      if (stream->decodeInline()){
+        cbacks.parseStream(fname.c_str(), print_my_progress);
+      }
+    } else {
+      cbacks.parseStream(fname.c_str(), print_my_progress);
+    }
   } catch (ParseDumpi::early_termination& e) {
     //do nothing - happily move on and finalize
     mpi_->finalize();
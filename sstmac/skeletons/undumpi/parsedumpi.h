@@ -106,6 +106,13 @@ class ParseDumpi : public sstmac::sw::App
 
   std::string metafilename_;
 
+  /// Threads in the process-wide pool decoding traces ahead of replay.
+  /// Ranks whose trace no thread has picked up parse it inline.
+  int reader_threads_;
+
+  /// The maximum bytes of decoded records buffered per rank.
+  uint64_t readahead_size_;
+
 };
 
 }
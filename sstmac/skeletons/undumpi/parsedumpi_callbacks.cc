@@ -48,6 +48,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sprockit/errors.h>
 #include <sprockit/output.h>
 #include <cstring>
+#include <type_traits>
 #include <sumi-mpi/mpi_api.h>
 #include <sumi-mpi/mpi_types.h>
 
@@ -99,6 +100,9 @@ namespace sumi {
 /// The shared callback pointer array.
 libundumpi_callbacks *ParsedumpiCallbacks::cbacks_ = nullptr;
 
+/// The shared callbacks that record for read-ahead instead of replaying.
+libundumpi_callbacks *ParsedumpiCallbacks::deferred_cbacks_ = nullptr;
+
 
 int pass(void* uarg,
   const dumpi_time *cpu,
@@ -167,6 +171,33 @@ ParsedumpiCallbacks::parseStream(
   undumpi_close(profile);
 }
 
+/// Replay records decoded ahead by a reader thread.
+void
+ParsedumpiCallbacks::replayStream(DumpiReaderPool* pool, DumpiCallStream* stream)
+{
+  static const std::string here("ParsedumpiCallbacks::replay_stream");
+  // The datatype sizes are in the file header - cheap to read here
+  dumpi_profile *profile = undumpi_open(stream->fname().c_str());
+  if(profile == NULL) {
+    throw sprockit::IOError(here + ":  Unable to open \"" + stream->fname() + "\" for reading.");
+  }
+  datatype_sizes_ = undumpi_read_datatype_sizes(profile);
+  undumpi_close(profile);
+
+  DumpiCallStream::Batch batch;
+  try {
+    while (pool->next(stream, batch)){
+      for (auto& call : batch){
+        call->replay(this);
+      }
+      batch.clear();
+    }
+  } catch (ParseDumpi::early_termination& e) {
+    pool->cancel(stream);
+    throw;
+  }
+}
+
 /// Initialize maps.
 void ParsedumpiCallbacks::initMaps()
 {
@@ -348,6 +379,11 @@ ParsedumpiCallbacks::getMpitypes(int count, const dumpi_datatype *dumpitypes)
   return mpitypes;
 }
 
+/// Set each callback and its read-ahead recording twin.
+#define set_callback(field, fxn) \
+  cbacks_->field = fxn; \
+  deferred_cbacks_->field = deferCall<std::remove_pointer<decltype(handlerParam(fxn))>::type, fxn>
+
 /// Set all callbacks.
 void ParsedumpiCallbacks::setCallbacks()
 {
@@ -356,295 +392,299 @@ void ParsedumpiCallbacks::setCallbacks()
     cbacks_ = new libundumpi_callbacks;
     libundumpi_clear_callbacks(cbacks_);
   }
-  cbacks_->on_send                      = on_MPI_Send                     ;
-  cbacks_->on_bsend                     = on_MPI_Bsend                    ;
-  cbacks_->on_ssend                     = on_MPI_Ssend                    ;
-  cbacks_->on_rsend                     = on_MPI_Rsend                    ;
-  cbacks_->on_recv                      = on_MPI_Recv                     ;
-  cbacks_->on_get_count                 = on_MPI_Get_count                ;
-  cbacks_->on_buffer_attach             = on_MPI_Buffer_attach            ;
-  cbacks_->on_buffer_detach             = on_MPI_Buffer_detach            ;
-  cbacks_->on_isend                     = on_MPI_Isend                    ;
-  cbacks_->on_ibsend                    = on_MPI_Ibsend                   ;
-  cbacks_->on_issend                    = on_MPI_Issend                   ;
-  cbacks_->on_irsend                    = on_MPI_Irsend                   ;
-  cbacks_->on_irecv                     = on_MPI_Irecv                    ;
-  cbacks_->on_wait                      = on_MPI_Wait                     ;
-  cbacks_->on_test                      = on_MPI_Test                     ;
-  cbacks_->on_request_free              = on_MPI_Request_free             ;
-  cbacks_->on_waitany                   = on_MPI_Waitany                  ;
-  cbacks_->on_testany                   = on_MPI_Testany                  ;
-  cbacks_->on_waitall                   = on_MPI_Waitall                  ;
-  cbacks_->on_testall                   = on_MPI_Testall                  ;
-  cbacks_->on_waitsome                  = on_MPI_Waitsome                 ;
-  cbacks_->on_testsome                  = on_MPI_Testsome                 ;
-  cbacks_->on_iprobe                    = on_MPI_Iprobe                   ;
-  cbacks_->on_probe                     = on_MPI_Probe                    ;
-  cbacks_->on_cancel                    = on_MPI_Cancel                   ;
-  cbacks_->on_test_cancelled            = on_MPI_Test_cancelled           ;
-  cbacks_->on_send_init                 = on_MPI_Send_init                ;
-  cbacks_->on_bsend_init                = on_MPI_Bsend_init               ;
-  cbacks_->on_ssend_init                = on_MPI_Ssend_init               ;
-  cbacks_->on_rsend_init                = on_MPI_Rsend_init               ;
-  cbacks_->on_recv_init                 = on_MPI_Recv_init                ;
-  cbacks_->on_start                     = on_MPI_Start                    ;
-  cbacks_->on_startall                  = on_MPI_Startall                 ;
-  cbacks_->on_sendrecv                  = on_MPI_Sendrecv                 ;
-  cbacks_->on_sendrecv_replace          = on_MPI_Sendrecv_replace         ;
-  cbacks_->on_type_contiguous           = on_MPI_Type_contiguous          ;
-  cbacks_->on_type_vector               = on_MPI_Type_vector              ;
-  cbacks_->on_type_hvector              = on_MPI_Type_hvector             ;
-  cbacks_->on_type_indexed              = on_MPI_Type_indexed             ;
-  cbacks_->on_type_hindexed             = on_MPI_Type_hindexed            ;
-  cbacks_->on_type_struct               = on_MPI_Type_struct              ;
-  cbacks_->on_address                   = on_MPI_Address                  ;
-  cbacks_->on_type_extent               = on_MPI_Type_extent              ;
-  cbacks_->on_type_size                 = on_MPI_Type_size                ;
-  cbacks_->on_type_lb                   = on_MPI_Type_lb                  ;
-  cbacks_->on_type_ub                   = on_MPI_Type_ub                  ;
-  cbacks_->on_type_commit               = on_MPI_Type_commit              ;
-  cbacks_->on_type_free                 = on_MPI_Type_free                ;
-  cbacks_->on_get_elements              = on_MPI_Get_elements             ;
-  cbacks_->on_pack                      = on_MPI_Pack                     ;
-  cbacks_->on_unpack                    = on_MPI_Unpack                   ;
-  cbacks_->on_pack_size                 = on_MPI_Pack_size                ;
-  cbacks_->on_barrier                   = on_MPI_Barrier                  ;
-  cbacks_->on_bcast                     = on_MPI_Bcast                    ;
-  cbacks_->on_gather                    = on_MPI_Gather                   ;
-  cbacks_->on_gatherv                   = on_MPI_Gatherv                  ;
-  cbacks_->on_scatter                   = on_MPI_Scatter                  ;
-  cbacks_->on_scatterv                  = on_MPI_Scatterv                 ;
-  cbacks_->on_allgather                 = on_MPI_Allgather                ;
-  cbacks_->on_allgatherv                = on_MPI_Allgatherv               ;
-  cbacks_->on_alltoall                  = on_MPI_Alltoall                 ;
-  cbacks_->on_alltoallv                 = on_MPI_Alltoallv                ;
-  cbacks_->on_reduce                    = on_MPI_Reduce                   ;
-  cbacks_->on_op_create                 = on_MPI_Op_create                ;
-  cbacks_->on_op_free                   = on_MPI_Op_free                  ;
-  cbacks_->on_allreduce                 = on_MPI_Allreduce                ;
-  cbacks_->on_reduce_scatter            = on_MPI_Reduce_scatter           ;
-  cbacks_->on_scan                      = on_MPI_Scan                     ;
-  cbacks_->on_group_size                = on_MPI_Group_size               ;
-  cbacks_->on_group_rank                = on_MPI_Group_rank               ;
-  cbacks_->on_group_translate_ranks     = on_MPI_Group_translate_ranks    ;
-  cbacks_->on_group_compare             = on_MPI_Group_compare            ;
-  cbacks_->on_comm_group                = on_MPI_Comm_group               ;
-  cbacks_->on_group_union               = on_MPI_Group_union              ;
-  cbacks_->on_group_intersection        = on_MPI_Group_intersection       ;
-  cbacks_->on_group_difference          = on_MPI_Group_difference         ;
-  cbacks_->on_group_incl                = on_MPI_Group_incl               ;
-  cbacks_->on_group_excl                = on_MPI_Group_excl               ;
-  cbacks_->on_group_range_incl          = on_MPI_Group_range_incl         ;
-  cbacks_->on_group_range_excl          = on_MPI_Group_range_excl         ;
-  cbacks_->on_group_free                = on_MPI_Group_free               ;
-  cbacks_->on_comm_size                 = on_MPI_Comm_size                ;
-  cbacks_->on_comm_rank                 = on_MPI_Comm_rank                ;
-  cbacks_->on_comm_compare              = on_MPI_Comm_compare             ;
-  cbacks_->on_comm_dup                  = on_MPI_Comm_dup                 ;
-  cbacks_->on_comm_create               = on_MPI_Comm_create              ;
-  cbacks_->on_comm_split                = on_MPI_Comm_split               ;
-  cbacks_->on_comm_free                 = on_MPI_Comm_free                ;
-  cbacks_->on_comm_test_inter           = on_MPI_Comm_test_inter          ;
-  cbacks_->on_comm_remote_size          = on_MPI_Comm_remote_size         ;
-  cbacks_->on_comm_remote_group         = on_MPI_Comm_remote_group        ;
-  cbacks_->on_intercomm_create          = on_MPI_Intercomm_create         ;
-  cbacks_->on_intercomm_merge           = on_MPI_Intercomm_merge          ;
-  cbacks_->on_keyval_create             = on_MPI_Keyval_create            ;
-  cbacks_->on_keyval_free               = on_MPI_Keyval_free              ;
-  cbacks_->on_attr_put                  = on_MPI_Attr_put                 ;
-  cbacks_->on_attr_get                  = on_MPI_Attr_get                 ;
-  cbacks_->on_attr_delete               = on_MPI_Attr_delete              ;
-  cbacks_->on_topo_test                 = on_MPI_Topo_test                ;
-  cbacks_->on_cart_create               = on_MPI_Cart_create              ;
-  cbacks_->on_dims_create               = on_MPI_Dims_create              ;
-  cbacks_->on_graph_create              = on_MPI_Graph_create             ;
-  cbacks_->on_graphdims_get             = on_MPI_Graphdims_get            ;
-  cbacks_->on_graph_get                 = on_MPI_Graph_get                ;
-  cbacks_->on_cartdim_get               = on_MPI_Cartdim_get              ;
-  cbacks_->on_cart_get                  = on_MPI_Cart_get                 ;
-  cbacks_->on_cart_rank                 = on_MPI_Cart_rank                ;
-  cbacks_->on_cart_coords               = on_MPI_Cart_coords              ;
-  cbacks_->on_graph_neighbors_count     = on_MPI_Graph_neighbors_count    ;
-  cbacks_->on_graph_neighbors           = on_MPI_Graph_neighbors          ;
-  cbacks_->on_cart_shift                = on_MPI_Cart_shift               ;
-  cbacks_->on_cart_sub                  = on_MPI_Cart_sub                 ;
-  cbacks_->on_cart_map                  = on_MPI_Cart_map                 ;
-  cbacks_->on_graph_map                 = on_MPI_Graph_map                ;
-  cbacks_->on_get_processor_name        = on_MPI_Get_processor_name       ;
-  cbacks_->on_get_version               = on_MPI_Get_version              ;
-  cbacks_->on_errhandler_create         = on_MPI_Errhandler_create        ;
-  cbacks_->on_errhandler_set            = on_MPI_Errhandler_set           ;
-  cbacks_->on_errhandler_get            = on_MPI_Errhandler_get           ;
-  cbacks_->on_errhandler_free           = on_MPI_Errhandler_free          ;
-  cbacks_->on_error_string              = on_MPI_Error_string             ;
-  cbacks_->on_error_class               = on_MPI_Error_class              ;
-  cbacks_->on_wtime                     = on_MPI_Wtime                    ;
-  cbacks_->on_wtick                     = on_MPI_Wtick                    ;
-  cbacks_->on_init                      = on_MPI_Init                     ;
-  cbacks_->on_finalize                  = on_MPI_Finalize                 ;
-  cbacks_->on_initialized               = on_MPI_Initialized              ;
-  cbacks_->on_abort                     = on_MPI_Abort                    ;
-  cbacks_->on_close_port                = on_MPI_Close_port               ;
-  cbacks_->on_comm_accept               = on_MPI_Comm_accept              ;
-  cbacks_->on_comm_connect              = on_MPI_Comm_connect             ;
-  cbacks_->on_comm_disconnect           = on_MPI_Comm_disconnect          ;
-  cbacks_->on_comm_get_parent           = on_MPI_Comm_get_parent          ;
-  cbacks_->on_comm_join                 = on_MPI_Comm_join                ;
-  cbacks_->on_comm_spawn                = on_MPI_Comm_spawn               ;
-  cbacks_->on_comm_spawn_multiple       = on_MPI_Comm_spawn_multiple      ;
-  cbacks_->on_lookup_name               = on_MPI_Lookup_name              ;
-  cbacks_->on_open_port                 = on_MPI_Open_port                ;
-  cbacks_->on_publish_name              = on_MPI_Publish_name             ;
-  cbacks_->on_unpublish_name            = on_MPI_Unpublish_name           ;
-  cbacks_->on_accumulate                = on_MPI_Accumulate               ;
-  cbacks_->on_get                       = on_MPI_Get                      ;
-  cbacks_->on_put                       = on_MPI_Put                      ;
-  cbacks_->on_win_complete              = on_MPI_Win_complete             ;
-  cbacks_->on_win_create                = on_MPI_Win_create               ;
-  cbacks_->on_win_fence                 = on_MPI_Win_fence                ;
-  cbacks_->on_win_free                  = on_MPI_Win_free                 ;
-  cbacks_->on_win_get_group             = on_MPI_Win_get_group            ;
-  cbacks_->on_win_lock                  = on_MPI_Win_lock                 ;
-  cbacks_->on_win_post                  = on_MPI_Win_post                 ;
-  cbacks_->on_win_start                 = on_MPI_Win_start                ;
-  cbacks_->on_win_test                  = on_MPI_Win_test                 ;
-  cbacks_->on_win_unlock                = on_MPI_Win_unlock               ;
-  cbacks_->on_win_wait                  = on_MPI_Win_wait                 ;
-  cbacks_->on_alltoallw                 = on_MPI_Alltoallw                ;
-  cbacks_->on_exscan                    = on_MPI_Exscan                   ;
-  cbacks_->on_add_error_class           = on_MPI_Add_error_class          ;
-  cbacks_->on_add_error_code            = on_MPI_Add_error_code           ;
-  cbacks_->on_add_error_string          = on_MPI_Add_error_string         ;
-  cbacks_->on_comm_call_errhandler      = on_MPI_Comm_call_errhandler     ;
-  cbacks_->on_comm_create_keyval        = on_MPI_Comm_create_keyval       ;
-  cbacks_->on_comm_delete_attr          = on_MPI_Comm_delete_attr         ;
-  cbacks_->on_comm_free_keyval          = on_MPI_Comm_free_keyval         ;
-  cbacks_->on_comm_get_attr             = on_MPI_Comm_get_attr            ;
-  cbacks_->on_comm_get_name             = on_MPI_Comm_get_name            ;
-  cbacks_->on_comm_set_attr             = on_MPI_Comm_set_attr            ;
-  cbacks_->on_comm_set_name             = on_MPI_Comm_set_name            ;
-  cbacks_->on_file_call_errhandler      = on_MPI_File_call_errhandler     ;
-  cbacks_->on_grequest_complete         = on_MPI_Grequest_complete        ;
-  cbacks_->on_grequest_start            = on_MPI_Grequest_start           ;
-  cbacks_->on_init_thread               = on_MPI_Init_thread              ;
-  cbacks_->on_is_thread_main            = on_MPI_Is_thread_main           ;
-  cbacks_->on_query_thread              = on_MPI_Query_thread             ;
-  cbacks_->on_status_set_cancelled      = on_MPI_Status_set_cancelled     ;
-  cbacks_->on_status_set_elements       = on_MPI_Status_set_elements      ;
-  cbacks_->on_type_create_keyval        = on_MPI_Type_create_keyval       ;
-  cbacks_->on_type_delete_attr          = on_MPI_Type_delete_attr         ;
-  cbacks_->on_type_dup                  = on_MPI_Type_dup                 ;
-  cbacks_->on_type_free_keyval          = on_MPI_Type_free_keyval         ;
-  cbacks_->on_type_get_attr             = on_MPI_Type_get_attr            ;
-  cbacks_->on_type_get_contents         = on_MPI_Type_get_contents        ;
-  cbacks_->on_type_get_envelope         = on_MPI_Type_get_envelope        ;
-  cbacks_->on_type_get_name             = on_MPI_Type_get_name            ;
-  cbacks_->on_type_set_attr             = on_MPI_Type_set_attr            ;
-  cbacks_->on_type_set_name             = on_MPI_Type_set_name            ;
-  cbacks_->on_type_match_size           = on_MPI_Type_match_size          ;
-  cbacks_->on_win_call_errhandler       = on_MPI_Win_call_errhandler      ;
-  cbacks_->on_win_create_keyval         = on_MPI_Win_create_keyval        ;
-  cbacks_->on_win_delete_attr           = on_MPI_Win_delete_attr          ;
-  cbacks_->on_win_free_keyval           = on_MPI_Win_free_keyval          ;
-  cbacks_->on_win_get_attr              = on_MPI_Win_get_attr             ;
-  cbacks_->on_win_get_name              = on_MPI_Win_get_name             ;
-  cbacks_->on_win_set_attr              = on_MPI_Win_set_attr             ;
-  cbacks_->on_win_set_name              = on_MPI_Win_set_name             ;
-  cbacks_->on_alloc_mem                 = on_MPI_Alloc_mem                ;
-  cbacks_->on_comm_create_errhandler    = on_MPI_Comm_create_errhandler   ;
-  cbacks_->on_comm_get_errhandler       = on_MPI_Comm_get_errhandler      ;
-  cbacks_->on_comm_set_errhandler       = on_MPI_Comm_set_errhandler      ;
-  cbacks_->on_file_create_errhandler    = on_MPI_File_create_errhandler   ;
-  cbacks_->on_file_get_errhandler       = on_MPI_File_get_errhandler      ;
-  cbacks_->on_file_set_errhandler       = on_MPI_File_set_errhandler      ;
-  cbacks_->on_finalized                 = on_MPI_Finalized                ;
-  cbacks_->on_free_mem                  = on_MPI_Free_mem                 ;
-  cbacks_->on_get_address               = on_MPI_Get_address              ;
-  cbacks_->on_info_create               = on_MPI_Info_create              ;
-  cbacks_->on_info_delete               = on_MPI_Info_delete              ;
-  cbacks_->on_info_dup                  = on_MPI_Info_dup                 ;
-  cbacks_->on_info_free                 = on_MPI_Info_free                ;
-  cbacks_->on_info_get                  = on_MPI_Info_get                 ;
-  cbacks_->on_info_get_nkeys            = on_MPI_Info_get_nkeys           ;
-  cbacks_->on_info_get_nthkey           = on_MPI_Info_get_nthkey          ;
-  cbacks_->on_info_get_valuelen         = on_MPI_Info_get_valuelen        ;
-  cbacks_->on_info_set                  = on_MPI_Info_set                 ;
-  cbacks_->on_pack_external             = on_MPI_Pack_external            ;
-  cbacks_->on_pack_external_size        = on_MPI_Pack_external_size       ;
-  cbacks_->on_request_get_status        = on_MPI_Request_get_status       ;
-  cbacks_->on_type_create_darray        = on_MPI_Type_create_darray       ;
-  cbacks_->on_type_create_hindexed      = on_MPI_Type_create_hindexed     ;
-  cbacks_->on_type_create_hvector       = on_MPI_Type_create_hvector      ;
-  cbacks_->on_type_create_indexed_block = on_MPI_Type_create_indexed_block;
-  cbacks_->on_type_create_resized       = on_MPI_Type_create_resized      ;
-  cbacks_->on_type_create_struct        = on_MPI_Type_create_struct       ;
-  cbacks_->on_type_create_subarray      = on_MPI_Type_create_subarray     ;
-  cbacks_->on_type_get_extent           = on_MPI_Type_get_extent          ;
-  cbacks_->on_type_get_true_extent      = on_MPI_Type_get_true_extent     ;
-  cbacks_->on_unpack_external           = on_MPI_Unpack_external          ;
-  cbacks_->on_win_create_errhandler     = on_MPI_Win_create_errhandler    ;
-  cbacks_->on_win_get_errhandler        = on_MPI_Win_get_errhandler       ;
-  cbacks_->on_win_set_errhandler        = on_MPI_Win_set_errhandler       ;
-  cbacks_->on_file_open                 = on_MPI_File_open                ;
-  cbacks_->on_file_close                = on_MPI_File_close               ;
-  cbacks_->on_file_delete               = on_MPI_File_delete              ;
-  cbacks_->on_file_set_size             = on_MPI_File_set_size            ;
-  cbacks_->on_file_preallocate          = on_MPI_File_preallocate         ;
-  cbacks_->on_file_get_size             = on_MPI_File_get_size            ;
-  cbacks_->on_file_get_group            = on_MPI_File_get_group           ;
-  cbacks_->on_file_get_amode            = on_MPI_File_get_amode           ;
-  cbacks_->on_file_set_info             = on_MPI_File_set_info            ;
-  cbacks_->on_file_get_info             = on_MPI_File_get_info            ;
-  cbacks_->on_file_set_view             = on_MPI_File_set_view            ;
-  cbacks_->on_file_get_view             = on_MPI_File_get_view            ;
-  cbacks_->on_file_read_at              = on_MPI_File_read_at             ;
-  cbacks_->on_file_read_at_all          = on_MPI_File_read_at_all         ;
-  cbacks_->on_file_write_at             = on_MPI_File_write_at            ;
-  cbacks_->on_file_write_at_all         = on_MPI_File_write_at_all        ;
-  cbacks_->on_file_iread_at             = on_MPI_File_iread_at            ;
-  cbacks_->on_file_iwrite_at            = on_MPI_File_iwrite_at           ;
-  cbacks_->on_file_read                 = on_MPI_File_read                ;
-  cbacks_->on_file_read_all             = on_MPI_File_read_all            ;
-  cbacks_->on_file_write                = on_MPI_File_write               ;
-  cbacks_->on_file_write_all            = on_MPI_File_write_all           ;
-  cbacks_->on_file_iread                = on_MPI_File_iread               ;
-  cbacks_->on_file_iwrite               = on_MPI_File_iwrite              ;
-  cbacks_->on_file_seek                 = on_MPI_File_seek                ;
-  cbacks_->on_file_get_position         = on_MPI_File_get_position        ;
-  cbacks_->on_file_get_byte_offset      = on_MPI_File_get_byte_offset     ;
-  cbacks_->on_file_read_shared          = on_MPI_File_read_shared         ;
-  cbacks_->on_file_write_shared         = on_MPI_File_write_shared        ;
-  cbacks_->on_file_iread_shared         = on_MPI_File_iread_shared        ;
-  cbacks_->on_file_iwrite_shared        = on_MPI_File_iwrite_shared       ;
-  cbacks_->on_file_read_ordered         = on_MPI_File_read_ordered        ;
-  cbacks_->on_file_write_ordered        = on_MPI_File_write_ordered       ;
-  cbacks_->on_file_seek_shared          = on_MPI_File_seek_shared         ;
-  cbacks_->on_file_get_position_shared  = on_MPI_File_get_position_shared ;
-  cbacks_->on_file_read_at_all_begin    = on_MPI_File_read_at_all_begin   ;
-  cbacks_->on_file_read_at_all_end      = on_MPI_File_read_at_all_end     ;
-  cbacks_->on_file_write_at_all_begin   = on_MPI_File_write_at_all_begin  ;
-  cbacks_->on_file_write_at_all_end     = on_MPI_File_write_at_all_end    ;
-  cbacks_->on_file_read_all_begin       = on_MPI_File_read_all_begin      ;
-  cbacks_->on_file_read_all_end         = on_MPI_File_read_all_end        ;
-  cbacks_->on_file_write_all_begin      = on_MPI_File_write_all_begin     ;
-  cbacks_->on_file_write_all_end        = on_MPI_File_write_all_end       ;
-  cbacks_->on_file_read_ordered_begin   = on_MPI_File_read_ordered_begin  ;
-  cbacks_->on_file_read_ordered_end     = on_MPI_File_read_ordered_end    ;
-  cbacks_->on_file_write_ordered_begin  = on_MPI_File_write_ordered_begin ;
-  cbacks_->on_file_write_ordered_end    = on_MPI_File_write_ordered_end   ;
-  cbacks_->on_file_get_type_extent      = on_MPI_File_get_type_extent     ;
-  cbacks_->on_register_datarep          = on_MPI_Register_datarep         ;
-  cbacks_->on_file_set_atomicity        = on_MPI_File_set_atomicity       ;
-  cbacks_->on_file_get_atomicity        = on_MPI_File_get_atomicity       ;
-  cbacks_->on_file_sync                 = on_MPI_File_sync                ;
-  cbacks_->on_iotest                    = on_MPIO_Test                    ;
-  cbacks_->on_iowait                    = on_MPIO_Wait                    ;
-  cbacks_->on_iotestall                 = on_MPIO_Testall                 ;
-  cbacks_->on_iowaitall                 = on_MPIO_Waitall                 ;
-  cbacks_->on_iotestany                 = on_MPIO_Testany                 ;
-  cbacks_->on_iowaitany                 = on_MPIO_Waitany                 ;
-  cbacks_->on_iowaitsome                = on_MPIO_Waitsome                ;
-  cbacks_->on_iotestsome                = on_MPIO_Testsome                ;
+  if(deferred_cbacks_ == NULL) {
+    deferred_cbacks_ = new libundumpi_callbacks;
+    libundumpi_clear_callbacks(deferred_cbacks_);
+  }
+  set_callback(on_send, on_MPI_Send);
+  set_callback(on_bsend, on_MPI_Bsend);
+  set_callback(on_ssend, on_MPI_Ssend);
+  set_callback(on_rsend, on_MPI_Rsend);
+  set_callback(on_recv, on_MPI_Recv);
+  set_callback(on_get_count, on_MPI_Get_count);
+  set_callback(on_buffer_attach, on_MPI_Buffer_attach);
+  set_callback(on_buffer_detach, on_MPI_Buffer_detach);
+  set_callback(on_isend, on_MPI_Isend);
+  set_callback(on_ibsend, on_MPI_Ibsend);
+  set_callback(on_issend, on_MPI_Issend);
+  set_callback(on_irsend, on_MPI_Irsend);
+  set_callback(on_irecv, on_MPI_Irecv);
+  set_callback(on_wait, on_MPI_Wait);
+  set_callback(on_test, on_MPI_Test);
+  set_callback(on_request_free, on_MPI_Request_free);
+  set_callback(on_waitany, on_MPI_Waitany);
+  set_callback(on_testany, on_MPI_Testany);
+  set_callback(on_waitall, on_MPI_Waitall);
+  set_callback(on_testall, on_MPI_Testall);
+  set_callback(on_waitsome, on_MPI_Waitsome);
+  set_callback(on_testsome, on_MPI_Testsome);
+  set_callback(on_iprobe, on_MPI_Iprobe);
+  set_callback(on_probe, on_MPI_Probe);
+  set_callback(on_cancel, on_MPI_Cancel);
+  set_callback(on_test_cancelled, on_MPI_Test_cancelled);
+  set_callback(on_send_init, on_MPI_Send_init);
+  set_callback(on_bsend_init, on_MPI_Bsend_init);
+  set_callback(on_ssend_init, on_MPI_Ssend_init);
+  set_callback(on_rsend_init, on_MPI_Rsend_init);
+  set_callback(on_recv_init, on_MPI_Recv_init);
+  set_callback(on_start, on_MPI_Start);
+  set_callback(on_startall, on_MPI_Startall);
+  set_callback(on_sendrecv, on_MPI_Sendrecv);
+  set_callback(on_sendrecv_replace, on_MPI_Sendrecv_replace);
+  set_callback(on_type_contiguous, on_MPI_Type_contiguous);
+  set_callback(on_type_vector, on_MPI_Type_vector);
+  set_callback(on_type_hvector, on_MPI_Type_hvector);
+  set_callback(on_type_indexed, on_MPI_Type_indexed);
+  set_callback(on_type_hindexed, on_MPI_Type_hindexed);
+  set_callback(on_type_struct, on_MPI_Type_struct);
+  set_callback(on_address, on_MPI_Address);
+  set_callback(on_type_extent, on_MPI_Type_extent);
+  set_callback(on_type_size, on_MPI_Type_size);
+  set_callback(on_type_lb, on_MPI_Type_lb);
+  set_callback(on_type_ub, on_MPI_Type_ub);
+  set_callback(on_type_commit, on_MPI_Type_commit);
+  set_callback(on_type_free, on_MPI_Type_free);
+  set_callback(on_get_elements, on_MPI_Get_elements);
+  set_callback(on_pack, on_MPI_Pack);
+  set_callback(on_unpack, on_MPI_Unpack);
+  set_callback(on_pack_size, on_MPI_Pack_size);
+  set_callback(on_barrier, on_MPI_Barrier);
+  set_callback(on_bcast, on_MPI_Bcast);
+  set_callback(on_gather, on_MPI_Gather);
+  set_callback(on_gatherv, on_MPI_Gatherv);
+  set_callback(on_scatter, on_MPI_Scatter);
+  set_callback(on_scatterv, on_MPI_Scatterv);
+  set_callback(on_allgather, on_MPI_Allgather);
+  set_callback(on_allgatherv, on_MPI_Allgatherv);
+  set_callback(on_alltoall, on_MPI_Alltoall);
+  set_callback(on_alltoallv, on_MPI_Alltoallv);
+  set_callback(on_reduce, on_MPI_Reduce);
+  set_callback(on_op_create, on_MPI_Op_create);
+  set_callback(on_op_free, on_MPI_Op_free);
+  set_callback(on_allreduce, on_MPI_Allreduce);
+  set_callback(on_reduce_scatter, on_MPI_Reduce_scatter);
+  set_callback(on_scan, on_MPI_Scan);
+  set_callback(on_group_size, on_MPI_Group_size);
+  set_callback(on_group_rank, on_MPI_Group_rank);
+  set_callback(on_group_translate_ranks, on_MPI_Group_translate_ranks);
+  set_callback(on_group_compare, on_MPI_Group_compare);
+  set_callback(on_comm_group, on_MPI_Comm_group);
+  set_callback(on_group_union, on_MPI_Group_union);
+  set_callback(on_group_intersection, on_MPI_Group_intersection);
+  set_callback(on_group_difference, on_MPI_Group_difference);
+  set_callback(on_group_incl, on_MPI_Group_incl);
+  set_callback(on_group_excl, on_MPI_Group_excl);
+  set_callback(on_group_range_incl, on_MPI_Group_range_incl);
+  set_callback(on_group_range_excl, on_MPI_Group_range_excl);
+  set_callback(on_group_free, on_MPI_Group_free);
+  set_callback(on_comm_size, on_MPI_Comm_size);
+  set_callback(on_comm_rank, on_MPI_Comm_rank);
+  set_callback(on_comm_compare, on_MPI_Comm_compare);
+  set_callback(on_comm_dup, on_MPI_Comm_dup);
+  set_callback(on_comm_create, on_MPI_Comm_create);
+  set_callback(on_comm_split, on_MPI_Comm_split);
+  set_callback(on_comm_free, on_MPI_Comm_free);
+  set_callback(on_comm_test_inter, on_MPI_Comm_test_inter);
+  set_callback(on_comm_remote_size, on_MPI_Comm_remote_size);
+  set_callback(on_comm_remote_group, on_MPI_Comm_remote_group);
+  set_callback(on_intercomm_create, on_MPI_Intercomm_create);
+  set_callback(on_intercomm_merge, on_MPI_Intercomm_merge);
+  set_callback(on_keyval_create, on_MPI_Keyval_create);
+  set_callback(on_keyval_free, on_MPI_Keyval_free);
+  set_callback(on_attr_put, on_MPI_Attr_put);
+  set_callback(on_attr_get, on_MPI_Attr_get);
+  set_callback(on_attr_delete, on_MPI_Attr_delete);
+  set_callback(on_topo_test, on_MPI_Topo_test);
+  set_callback(on_cart_create, on_MPI_Cart_create);
+  set_callback(on_dims_create, on_MPI_Dims_create);
+  set_callback(on_graph_create, on_MPI_Graph_create);
+  set_callback(on_graphdims_get, on_MPI_Graphdims_get);
+  set_callback(on_graph_get, on_MPI_Graph_get);
+  set_callback(on_cartdim_get, on_MPI_Cartdim_get);
+  set_callback(on_cart_get, on_MPI_Cart_get);
+  set_callback(on_cart_rank, on_MPI_Cart_rank);
+  set_callback(on_cart_coords, on_MPI_Cart_coords);
+  set_callback(on_graph_neighbors_count, on_MPI_Graph_neighbors_count);
+  set_callback(on_graph_neighbors, on_MPI_Graph_neighbors);
+  set_callback(on_cart_shift, on_MPI_Cart_shift);
+  set_callback(on_cart_sub, on_MPI_Cart_sub);
+  set_callback(on_cart_map, on_MPI_Cart_map);
+  set_callback(on_graph_map, on_MPI_Graph_map);
+  set_callback(on_get_processor_name, on_MPI_Get_processor_name);
+  set_callback(on_get_version, on_MPI_Get_version);
+  set_callback(on_errhandler_create, on_MPI_Errhandler_create);
+  set_callback(on_errhandler_set, on_MPI_Errhandler_set);
+  set_callback(on_errhandler_get, on_MPI_Errhandler_get);
+  set_callback(on_errhandler_free, on_MPI_Errhandler_free);
+  set_callback(on_error_string, on_MPI_Error_string);
+  set_callback(on_error_class, on_MPI_Error_class);
+  set_callback(on_wtime, on_MPI_Wtime);
+  set_callback(on_wtick, on_MPI_Wtick);
+  set_callback(on_init, on_MPI_Init);
+  set_callback(on_finalize, on_MPI_Finalize);
+  set_callback(on_initialized, on_MPI_Initialized);
+  set_callback(on_abort, on_MPI_Abort);
+  set_callback(on_close_port, on_MPI_Close_port);
+  set_callback(on_comm_accept, on_MPI_Comm_accept);
+  set_callback(on_comm_connect, on_MPI_Comm_connect);
+  set_callback(on_comm_disconnect, on_MPI_Comm_disconnect);
+  set_callback(on_comm_get_parent, on_MPI_Comm_get_parent);
+  set_callback(on_comm_join, on_MPI_Comm_join);
+  set_callback(on_comm_spawn, on_MPI_Comm_spawn);
+  set_callback(on_comm_spawn_multiple, on_MPI_Comm_spawn_multiple);
+  set_callback(on_lookup_name, on_MPI_Lookup_name);
+  set_callback(on_open_port, on_MPI_Open_port);
+  set_callback(on_publish_name, on_MPI_Publish_name);
+  set_callback(on_unpublish_name, on_MPI_Unpublish_name);
+  set_callback(on_accumulate, on_MPI_Accumulate);
+  set_callback(on_get, on_MPI_Get);
+  set_callback(on_put, on_MPI_Put);
+  set_callback(on_win_complete, on_MPI_Win_complete);
+  set_callback(on_win_create, on_MPI_Win_create);
+  set_callback(on_win_fence, on_MPI_Win_fence);
+  set_callback(on_win_free, on_MPI_Win_free);
+  set_callback(on_win_get_group, on_MPI_Win_get_group);
+  set_callback(on_win_lock, on_MPI_Win_lock);
+  set_callback(on_win_post, on_MPI_Win_post);
+  set_callback(on_win_start, on_MPI_Win_start);
+  set_callback(on_win_test, on_MPI_Win_test);
+  set_callback(on_win_unlock, on_MPI_Win_unlock);
+  set_callback(on_win_wait, on_MPI_Win_wait);
+  set_callback(on_alltoallw, on_MPI_Alltoallw);
+  set_callback(on_exscan, on_MPI_Exscan);
+  set_callback(on_add_error_class, on_MPI_Add_error_class);
+  set_callback(on_add_error_code, on_MPI_Add_error_code);
+  set_callback(on_add_error_string, on_MPI_Add_error_string);
+  set_callback(on_comm_call_errhandler, on_MPI_Comm_call_errhandler);
+  set_callback(on_comm_create_keyval, on_MPI_Comm_create_keyval);
+  set_callback(on_comm_delete_attr, on_MPI_Comm_delete_attr);
+  set_callback(on_comm_free_keyval, on_MPI_Comm_free_keyval);
+  set_callback(on_comm_get_attr, on_MPI_Comm_get_attr);
+  set_callback(on_comm_get_name, on_MPI_Comm_get_name);
+  set_callback(on_comm_set_attr, on_MPI_Comm_set_attr);
+  set_callback(on_comm_set_name, on_MPI_Comm_set_name);
+  set_callback(on_file_call_errhandler, on_MPI_File_call_errhandler);
+  set_callback(on_grequest_complete, on_MPI_Grequest_complete);
+  set_callback(on_grequest_start, on_MPI_Grequest_start);
+  set_callback(on_init_thread, on_MPI_Init_thread);
+  set_callback(on_is_thread_main, on_MPI_Is_thread_main);
+  set_callback(on_query_thread, on_MPI_Query_thread);
+  set_callback(on_status_set_cancelled, on_MPI_Status_set_cancelled);
+  set_callback(on_status_set_elements, on_MPI_Status_set_elements);
+  set_callback(on_type_create_keyval, on_MPI_Type_create_keyval);
+  set_callback(on_type_delete_attr, on_MPI_Type_delete_attr);
+  set_callback(on_type_dup, on_MPI_Type_dup);
+  set_callback(on_type_free_keyval, on_MPI_Type_free_keyval);
+  set_callback(on_type_get_attr, on_MPI_Type_get_attr);
+  set_callback(on_type_get_contents, on_MPI_Type_get_contents);
+  set_callback(on_type_get_envelope, on_MPI_Type_get_envelope);
+  set_callback(on_type_get_name, on_MPI_Type_get_name);
+  set_callback(on_type_set_attr, on_MPI_Type_set_attr);
+  set_callback(on_type_set_name, on_MPI_Type_set_name);
+  set_callback(on_type_match_size, on_MPI_Type_match_size);
+  set_callback(on_win_call_errhandler, on_MPI_Win_call_errhandler);
+  set_callback(on_win_create_keyval, on_MPI_Win_create_keyval);
+  set_callback(on_win_delete_attr, on_MPI_Win_delete_attr);
+  set_callback(on_win_free_keyval, on_MPI_Win_free_keyval);
+  set_callback(on_win_get_attr, on_MPI_Win_get_attr);
+  set_callback(on_win_get_name, on_MPI_Win_get_name);
+  set_callback(on_win_set_attr, on_MPI_Win_set_attr);
+  set_callback(on_win_set_name, on_MPI_Win_set_name);
+  set_callback(on_alloc_mem, on_MPI_Alloc_mem);
+  set_callback(on_comm_create_errhandler, on_MPI_Comm_create_errhandler);
+  set_callback(on_comm_get_errhandler, on_MPI_Comm_get_errhandler);
+  set_callback(on_comm_set_errhandler, on_MPI_Comm_set_errhandler);
+  set_callback(on_file_create_errhandler, on_MPI_File_create_errhandler);
+  set_callback(on_file_get_errhandler, on_MPI_File_get_errhandler);
+  set_callback(on_file_set_errhandler, on_MPI_File_set_errhandler);
+  set_callback(on_finalized, on_MPI_Finalized);
+  set_callback(on_free_mem, on_MPI_Free_mem);
+  set_callback(on_get_address, on_MPI_Get_address);
+  set_callback(on_info_create, on_MPI_Info_create);
+  set_callback(on_info_delete, on_MPI_Info_delete);
+  set_callback(on_info_dup, on_MPI_Info_dup);
+  set_callback(on_info_free, on_MPI_Info_free);
+  set_callback(on_info_get, on_MPI_Info_get);
+  set_callback(on_info_get_nkeys, on_MPI_Info_get_nkeys);
+  set_callback(on_info_get_nthkey, on_MPI_Info_get_nthkey);
+  set_callback(on_info_get_valuelen, on_MPI_Info_get_valuelen);
+  set_callback(on_info_set, on_MPI_Info_set);
+  set_callback(on_pack_external, on_MPI_Pack_external);
+  set_callback(on_pack_external_size, on_MPI_Pack_external_size);
+  set_callback(on_request_get_status, on_MPI_Request_get_status);
+  set_callback(on_type_create_darray, on_MPI_Type_create_darray);
+  set_callback(on_type_create_hindexed, on_MPI_Type_create_hindexed);
+  set_callback(on_type_create_hvector, on_MPI_Type_create_hvector);
+  set_callback(on_type_create_indexed_block, on_MPI_Type_create_indexed_block);
+  set_callback(on_type_create_resized, on_MPI_Type_create_resized);
+  set_callback(on_type_create_struct, on_MPI_Type_create_struct);
+  set_callback(on_type_create_subarray, on_MPI_Type_create_subarray);
+  set_callback(on_type_get_extent, on_MPI_Type_get_extent);
+  set_callback(on_type_get_true_extent, on_MPI_Type_get_true_extent);
+  set_callback(on_unpack_external, on_MPI_Unpack_external);
+  set_callback(on_win_create_errhandler, on_MPI_Win_create_errhandler);
+  set_callback(on_win_get_errhandler, on_MPI_Win_get_errhandler);
+  set_callback(on_win_set_errhandler, on_MPI_Win_set_errhandler);
+  set_callback(on_file_open, on_MPI_File_open);
+  set_callback(on_file_close, on_MPI_File_close);
+  set_callback(on_file_delete, on_MPI_File_delete);
+  set_callback(on_file_set_size, on_MPI_File_set_size);
+  set_callback(on_file_preallocate, on_MPI_File_preallocate);
+  set_callback(on_file_get_size, on_MPI_File_get_size);
+  set_callback(on_file_get_group, on_MPI_File_get_group);
+  set_callback(on_file_get_amode, on_MPI_File_get_amode);
+  set_callback(on_file_set_info, on_MPI_File_set_info);
+  set_callback(on_file_get_info, on_MPI_File_get_info);
+  set_callback(on_file_set_view, on_MPI_File_set_view);
+  set_callback(on_file_get_view, on_MPI_File_get_view);
+  set_callback(on_file_read_at, on_MPI_File_read_at);
+  set_callback(on_file_read_at_all, on_MPI_File_read_at_all);
+  set_callback(on_file_write_at, on_MPI_File_write_at);
+  set_callback(on_file_write_at_all, on_MPI_File_write_at_all);
+  set_callback(on_file_iread_at, on_MPI_File_iread_at);
+  set_callback(on_file_iwrite_at, on_MPI_File_iwrite_at);
+  set_callback(on_file_read, on_MPI_File_read);
+  set_callback(on_file_read_all, on_MPI_File_read_all);
+  set_callback(on_file_write, on_MPI_File_write);
+  set_callback(on_file_write_all, on_MPI_File_write_all);
+  set_callback(on_file_iread, on_MPI_File_iread);
+  set_callback(on_file_iwrite, on_MPI_File_iwrite);
+  set_callback(on_file_seek, on_MPI_File_seek);
+  set_callback(on_file_get_position, on_MPI_File_get_position);
+  set_callback(on_file_get_byte_offset, on_MPI_File_get_byte_offset);
+  set_callback(on_file_read_shared, on_MPI_File_read_shared);
+  set_callback(on_file_write_shared, on_MPI_File_write_shared);
+  set_callback(on_file_iread_shared, on_MPI_File_iread_shared);
+  set_callback(on_file_iwrite_shared, on_MPI_File_iwrite_shared);
+  set_callback(on_file_read_ordered, on_MPI_File_read_ordered);
+  set_callback(on_file_write_ordered, on_MPI_File_write_ordered);
+  set_callback(on_file_seek_shared, on_MPI_File_seek_shared);
+  set_callback(on_file_get_position_shared, on_MPI_File_get_position_shared);
+  set_callback(on_file_read_at_all_begin, on_MPI_File_read_at_all_begin);
+  set_callback(on_file_read_at_all_end, on_MPI_File_read_at_all_end);
+  set_callback(on_file_write_at_all_begin, on_MPI_File_write_at_all_begin);
+  set_callback(on_file_write_at_all_end, on_MPI_File_write_at_all_end);
+  set_callback(on_file_read_all_begin, on_MPI_File_read_all_begin);
+  set_callback(on_file_read_all_end, on_MPI_File_read_all_end);
+  set_callback(on_file_write_all_begin, on_MPI_File_write_all_begin);
+  set_callback(on_file_write_all_end, on_MPI_File_write_all_end);
+  set_callback(on_file_read_ordered_begin, on_MPI_File_read_ordered_begin);
+  set_callback(on_file_read_ordered_end, on_MPI_File_read_ordered_end);
+  set_callback(on_file_write_ordered_begin, on_MPI_File_write_ordered_begin);
+  set_callback(on_file_write_ordered_end, on_MPI_File_write_ordered_end);
+  set_callback(on_file_get_type_extent, on_MPI_File_get_type_extent);
+  set_callback(on_register_datarep, on_MPI_Register_datarep);
+  set_callback(on_file_set_atomicity, on_MPI_File_set_atomicity);
+  set_callback(on_file_get_atomicity, on_MPI_File_get_atomicity);
+  set_callback(on_file_sync, on_MPI_File_sync);
+  set_callback(on_iotest, on_MPIO_Test);
+  set_callback(on_iowait, on_MPIO_Wait);
+  set_callback(on_iotestall, on_MPIO_Testall);
+  set_callback(on_iowaitall, on_MPIO_Waitall);
+  set_callback(on_iotestany, on_MPIO_Testany);
+  set_callback(on_iowaitany, on_MPIO_Waitany);
+  set_callback(on_iowaitsome, on_MPIO_Waitsome);
+  set_callback(on_iotestsome, on_MPIO_Testsome);
 }
 
 int ParsedumpiCallbacks::
@@ -51,6 +51,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sumi-mpi/mpi_types.h>
 #include <sumi-mpi/mpi_status.h>
 #include <sumi-mpi/mpi_call.h>
+#include <sstmac/skeletons/undumpi/dumpi_readahead.h>
 #include <dumpi/libundumpi/libundumpi.h>
 #include <stdint.h>
 #include <fstream>
@@ -83,6 +84,10 @@ class ParsedumpiCallbacks
   /// This is pretty big (2.4 K), but at least it can be shared.
   static libundumpi_callbacks *cbacks_;
 
+  /// The same callbacks, but recording each call for later replay.
+  /// Used by reader threads decoding ahead of the simulation.
+  static libundumpi_callbacks *deferred_cbacks_;
+
   /// The dumpi timestamp at which we finished the most recent MPI call.
   dumpi_clock trace_compute_start_;
 
@@ -132,6 +137,17 @@ class ParsedumpiCallbacks
    */
   void parseStream(const std::string &filename, bool print_progress);
 
+  /**
+   * @brief Replay a trace decoded ahead of time by the reader pool
+   * @param pool
+   * @param stream
+   */
+  void replayStream(DumpiReaderPool* pool, DumpiCallStream* stream);
+
+  static libundumpi_callbacks* deferredCallbacks() {
+    return deferred_cbacks_;
+  }
+
  private:
   /// Initialize maps (datatypes etc.).  Called at constrution.
   void initMaps();
@@ -177,6 +193,23 @@ class ParsedumpiCallbacks
   /// Define all callback routines.
   void setCallbacks();
 
+  /// Used to deduce the record type of a callback.
+  template <class Prm>
+  static Prm* handlerParam(DumpiHandler<Prm> handler);
+
+  /// Copy a record on a reader thread for later replay.
+  template <class Prm, DumpiHandler<Prm> Handler>
+  static int deferCall(const Prm *prm, uint16_t thread,
+                       const dumpi_time *cpu, const dumpi_time *wall,
+                       const dumpi_perfinfo *perf, void *uarg)
+  {
+    DumpiCallStream* stream = reinterpret_cast<DumpiCallStream*>(uarg);
+    if (!stream->cancelled()){
+      stream->push(new DeferredDumpiCallImpl<Prm,Handler>(prm, thread, cpu, wall, perf));
+    }
+    return 1;
+  }
+
   static int
   on_MPI_Send(const dumpi_send *prm, uint16_t thread,
               const dumpi_time *cpu, const dumpi_time *wall,
@@ -0,0 +1,438 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#include <sstmac/software/launch/backfill_job_launcher.h>
+#include <sstmac/software/launch/launch_request.h>
+#include <sstmac/software/launch/job_launch_event.h>
+#include <sstmac/software/launch/launch_event.h>
+#include <sstmac/software/process/app.h>
+#include <sstmac/software/process/operating_system.h>
+#include <sprockit/fileio.h>
+#include <sprockit/output.h>
+#include <sprockit/util.h>
+#include <sprockit/sim_parameters.h>
+#include <sprockit/keyword_registration.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+RegisterKeywords(
+{ "backfill", "the queue policy of the backfill launcher: fcfs, easy, or conservative" },
+{ "workload_file", "a Standard Workload Format (SWF) file of jobs, each running the app template given by its executable number" },
+{ "default_walltime", "the walltime estimate for jobs that do not give one" },
+{ "walltime", "the walltime estimate the backfill launcher uses to schedule an app" },
+);
+
+namespace sstmac {
+namespace sw {
+
+/**
+ * Distributed services run alongside the jobs until the simulation ends,
+ * so they are launched immediately rather than scheduled as jobs
+ */
+static bool
+isService(AppLaunchRequest* request)
+{
+  SST::Params params = request->appParams();
+  return params.find<std::string>("name", "") == "distributed_service";
+}
+
+BackfillJoblauncher::BackfillJoblauncher(SST::Params& params, OperatingSystem* os) :
+  JobLauncher(params, os),
+  num_done_(0)
+{
+  std::string policy = params.find<std::string>("backfill", "easy");
+  if (policy == "fcfs"){
+    policy_ = FCFS;
+  } else if (policy == "easy"){
+    policy_ = EASY;
+  } else if (policy == "conservative"){
+    policy_ = CONSERVATIVE;
+  } else {
+    spkt_abort_printf("invalid backfill policy %s - must be fcfs, easy, or conservative",
+                      policy.c_str());
+  }
+
+  if (params.contains("workload_file")){
+    addWorkload(params, params.find<std::string>("workload_file"));
+  } else {
+    TimeDelta default_walltime(params.find<SST::UnitAlgebra>("default_walltime", "3600s").getValue().toDouble());
+    for (AppLaunchRequest* request : initial_requests_){
+      if (isService(request)) continue;
+      SST::Params app_params = request->appParams();
+      TimeDelta estimate = default_walltime;
+      if (app_params.contains("walltime")){
+        estimate = TimeDelta(app_params.find<SST::UnitAlgebra>("walltime").getValue().toDouble());
+      }
+      addJob(request, request->aid(), request->appNamespace(), estimate);
+    }
+  }
+}
+
+BackfillJoblauncher::~BackfillJoblauncher()
+{
+  for (auto& pair : jobs_){
+    if (pair.second.request) delete pair.second.request;
+  }
+}
+
+void
+BackfillJoblauncher::addJob(AppLaunchRequest* request, int id, const std::string& app, TimeDelta estimate)
+{
+  int ppn = request->procsPerNode();
+  int nnodes = (request->nproc() + ppn - 1) / ppn;
+  if (nnodes > topology_->numNodes()){
+    spkt_abort_printf("backfill launcher: job %d needs %d nodes, but the machine only has %d",
+                      id, nnodes, topology_->numNodes());
+  }
+
+  job& j = jobs_[request->aid()];
+  j.request = request;
+  j.id = id;
+  j.app = app;
+  j.nnodes = nnodes;
+  j.submit = request->time();
+  j.estimate = estimate;
+  j.nrunning_at_start = 0;
+}
+
+void
+BackfillJoblauncher::addWorkload(SST::Params& params, const std::string& fname)
+{
+  std::ifstream in;
+  sprockit::SpktFileIO::openFile(in, fname);
+  if (!in.is_open()){
+    spkt_abort_printf("backfill launcher: could not find workload file %s in current folder or configuration include path",
+                      fname.c_str());
+  }
+
+  //the app requests become templates for the jobs in the workload
+  //services still launch as before
+  std::list<AppLaunchRequest*> services;
+  AppId aid = 1;
+  for (AppLaunchRequest* request : initial_requests_){
+    aid = std::max(aid, request->aid() + 1);
+    if (isService(request)){
+      services.push_back(request);
+    } else {
+      App::unlockDlopen(request->aid());
+      delete request;
+    }
+  }
+  initial_requests_ = services;
+
+  SST::Params all_app_params = params.get_scoped_params("app");
+  std::string line;
+  int lineno = 0;
+  while (std::getline(in, line)){
+    ++lineno;
+    size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos || line[first] == ';'){
+      continue; //blank or a header comment
+    }
+
+    std::stringstream sstr(line);
+    std::vector<double> fields;
+    double field;
+    while (sstr >> field){
+      fields.push_back(field);
+    }
+    if (fields.size() < 14){
+      spkt_abort_printf("backfill launcher: line %d of %s has %d fields - SWF jobs need at least 14",
+                        lineno, fname.c_str(), int(fields.size()));
+    }
+
+    //SWF fields, counting from 1: 1 job number, 2 submit time, 4 run time, 5 allocated processors,
+    //8 requested processors, 9 requested time, 14 executable number - -1 is unknown
+    int id = fields[0];
+    double submit = fields[1];
+    int nproc = fields[7] > 0 ? fields[7] : fields[4];
+    double estimate = fields[8] > 0 ? fields[8] : fields[3];
+    int exe = fields[13] > 0 ? fields[13] : 1;
+    if (nproc <= 0 || estimate <= 0){
+      spkt_abort_printf("backfill launcher: job on line %d of %s needs a processor count and a requested or actual run time",
+                        lineno, fname.c_str());
+    }
+
+    std::string app = sprockit::sprintf("app%d", exe);
+    SST::Params app_params = params.get_scoped_params(app);
+    if (app_params.empty()){
+      spkt_abort_printf("backfill launcher: job on line %d of %s runs %s, which is not given",
+                        lineno, fname.c_str(), app.c_str());
+    }
+    app_params.insert(all_app_params);
+
+    int template_nproc, ppn;
+    std::vector<int> ignore;
+    AppLaunchRequest::parseLaunchCmd(app_params, template_nproc, ppn, ignore);
+    ppn = std::min(ppn, nproc);
+    app_params.insert("launch_cmd", sprockit::sprintf("aprun -n %d -N %d", nproc, ppn));
+    app_params.insert("start", sprockit::sprintf("%.9fs", submit));
+
+    AppLaunchRequest* request = new AppLaunchRequest(app_params, aid, sprockit::sprintf("job%d", aid));
+    initial_requests_.push_back(request);
+    App::lockDlopen(aid);
+    addJob(request, id, app, TimeDelta(estimate));
+    ++aid;
+  }
+}
+
+bool
+BackfillJoblauncher::handleLaunchRequest(AppLaunchRequest* request,
+                                         ordered_node_set& allocation)
+{
+  if (jobs_.find(request->aid()) == jobs_.end()){
+    //a service - take its nodes right away
+    if (!request->requestAllocation(available_, allocation)){
+      spkt_abort_printf("backfill launcher: allocation of service %s failed",
+                        request->appNamespace().c_str());
+    }
+    for (const NodeId& nid : allocation){
+      available_.erase(nid);
+    }
+    return true;
+  }
+
+  queue_.push_back(request->aid());
+  schedule();
+  //schedule launches jobs itself, possibly not this one
+  return false;
+}
+
+void
+BackfillJoblauncher::stopEventReceived(JobStopRequest* ev)
+{
+  auto job_iter = jobs_.find(ev->aid());
+  if (job_iter == jobs_.end()){
+    //a service
+    os_->decrementAppRefcount();
+    return;
+  }
+
+  job& j = job_iter->second;
+  j.end = os_->now();
+  running_.erase(ev->aid());
+  for (SwitchId sid : j.switches){
+    auto iter = switch_jobs_.find(sid);
+    iter->second.erase(ev->aid());
+    if (iter->second.empty()) switch_jobs_.erase(iter);
+  }
+  ++num_done_;
+
+  schedule();
+
+  if (num_done_ == jobs_.size()){
+    report();
+  }
+  os_->decrementAppRefcount();
+}
+
+/**
+ * @param changes The change in free nodes at each future time from job ends and reservations
+ * @param nfree_now The number of nodes free now
+ * @param after_now Whether the job cannot start now, whatever the node count
+ * @return The earliest time with enough free nodes for the whole estimate
+ */
+static Timestamp
+earliestStart(const std::map<Timestamp,int>& changes, int nfree_now, Timestamp now,
+              int nnodes, TimeDelta estimate, bool after_now)
+{
+  std::vector<std::pair<Timestamp,int>> steps;
+  steps.emplace_back(now, nfree_now);
+  int nfree = nfree_now;
+  for (auto& pair : changes){
+    nfree += pair.second;
+    steps.emplace_back(pair.first, nfree);
+  }
+
+  for (int i=after_now ? 1 : 0; i < steps.size(); ++i){
+    Timestamp start = steps[i].first;
+    Timestamp stop = start + estimate;
+    bool fits = true;
+    for (int j=i; j < steps.size() && steps[j].first < stop; ++j){
+      if (steps[j].second < nnodes){
+        fits = false;
+        break;
+      }
+    }
+    if (fits) return start;
+  }
+  //every node is free once all jobs and reservations are over
+  return steps.back().first;
+}
+
+void
+BackfillJoblauncher::schedule()
+{
+  Timestamp now = os_->now();
+  //running jobs that overran their estimate are assumed to end any moment
+  TimeDelta tick(1, TimeDelta::exact);
+  std::map<Timestamp,int> changes;
+  for (AppId aid : running_){
+    job& j = jobs_[aid];
+    Timestamp end = j.start + j.estimate;
+    changes[end > now ? end : now + tick] += j.nnodes;
+  }
+
+  int nfree = available_.size();
+  int nreserved = 0;
+  auto iter = queue_.begin();
+  while (iter != queue_.end()){
+    AppId aid = *iter;
+    job& j = jobs_[aid];
+    Timestamp start = earliestStart(changes, nfree, now, j.nnodes, j.estimate, false);
+    if (start == now){
+      ordered_node_set allocation;
+      bool success = j.request->requestAllocation(available_, allocation);
+      for (const NodeId& nid : allocation){
+        if (available_.find(nid) == available_.end()) success = false;
+      }
+      if (success){
+        iter = queue_.erase(iter);
+        nfree -= allocation.size();
+        changes[now + j.estimate] += allocation.size();
+        startJob(aid, allocation);
+        continue;
+      } else if (running_.empty()){
+        spkt_abort_printf("backfill launcher: allocation of job %d failed on an idle machine",
+                          aid);
+      }
+      //enough nodes, but not ones the allocator can use - wait for the next job to end
+      start = earliestStart(changes, nfree, now, j.nnodes, j.estimate, true);
+    }
+
+    if (policy_ == FCFS) break;
+
+    if (policy_ == CONSERVATIVE || nreserved == 0){
+      changes[start] -= j.nnodes;
+      changes[start + j.estimate] += j.nnodes;
+      ++nreserved;
+    }
+    ++iter;
+  }
+}
+
+void
+BackfillJoblauncher::startJob(AppId aid, const ordered_node_set& allocation)
+{
+  job& j = jobs_[aid];
+  j.start = os_->now();
+  j.nrunning_at_start = running_.size();
+  for (const NodeId& nid : allocation){
+    available_.erase(nid);
+    j.switches.insert(topology_->endpointToSwitch(nid));
+  }
+
+  //jobs sharing a switch can interfere through its links
+  for (SwitchId sid : j.switches){
+    std::set<AppId>& owners = switch_jobs_[sid];
+    if (!owners.empty()){
+      j.shared_switches.insert(sid);
+      for (AppId other : owners){
+        jobs_[other].shared_switches.insert(sid);
+      }
+    }
+    owners.insert(aid);
+  }
+  running_.insert(aid);
+
+  AppLaunchRequest* request = j.request;
+  j.request = nullptr;
+  satisfyLaunchRequest(request, allocation);
+}
+
+void
+BackfillJoblauncher::report()
+{
+  struct app_summary {
+    int njobs = 0;
+    double min_runtime = 0;
+    double max_runtime = 0;
+    double total_runtime = 0;
+  };
+  std::map<std::string, app_summary> apps;
+
+  Timestamp first_submit = jobs_.begin()->second.submit;
+  Timestamp last_end;
+  double node_seconds = 0;
+  double total_wait = 0;
+  double max_wait = 0;
+  for (auto& pair : jobs_){
+    job& j = pair.second;
+    double wait = (j.start - j.submit).sec();
+    double runtime = (j.end - j.start).sec();
+    cout0 << sprockit::sprintf("Job %d: app=%s nodes=%d submit=%.6f wait=%.6f runtime=%.6f estimate=%.6f "
+                               "concurrent=%d shared_switches=%d/%d\n",
+                               j.id, j.app.c_str(), j.nnodes, j.submit.sec(), wait, runtime,
+                               j.estimate.sec(), j.nrunning_at_start,
+                               int(j.shared_switches.size()), int(j.switches.size()));
+    first_submit = std::min(first_submit, j.submit);
+    last_end = std::max(last_end, j.end);
+    node_seconds += j.nnodes * runtime;
+    total_wait += wait;
+    max_wait = std::max(max_wait, wait);
+
+    app_summary& app = apps[j.app];
+    if (app.njobs == 0 || runtime < app.min_runtime) app.min_runtime = runtime;
+    app.max_runtime = std::max(app.max_runtime, runtime);
+    app.total_runtime += runtime;
+    ++app.njobs;
+  }
+
+  //identical jobs only differ in runtime by what they shared with other jobs
+  for (auto& pair : apps){
+    app_summary& app = pair.second;
+    cout0 << sprockit::sprintf("App %s: jobs=%d runtime min=%.6f mean=%.6f max=%.6f\n",
+                               pair.first.c_str(), app.njobs, app.min_runtime,
+                               app.total_runtime / app.njobs, app.max_runtime);
+  }
+
+  double makespan = (last_end - first_submit).sec();
+  cout0 << sprockit::sprintf("Workload: jobs=%d makespan=%.6f mean_wait=%.6f max_wait=%.6f utilization=%.4f\n",
+                             int(jobs_.size()), makespan, total_wait / jobs_.size(), max_wait,
+                             node_seconds / (makespan * topology_->numNodes()));
+}
+
+}
+}
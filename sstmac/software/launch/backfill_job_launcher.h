@@ -0,0 +1,135 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#ifndef SSTMAC_SOFTWARE_LAUNCH_BACKFILL_JOB_LAUNCHER_H_INCLUDED
+#define SSTMAC_SOFTWARE_LAUNCH_BACKFILL_JOB_LAUNCHER_H_INCLUDED
+
+#include <sstmac/software/launch/job_launcher.h>
+#include <sstmac/hardware/topology/topology.h>
+#include <list>
+#include <map>
+#include <set>
+
+namespace sstmac {
+namespace sw {
+
+/**
+ * @brief The BackfillJoblauncher class
+ * A batch scheduler that queues jobs in arrival order and launches them as nodes free up.
+ * Jobs either come from the usual app1,app2,... launch requests or from a workload file
+ * in the Standard Workload Format (SWF), where each job is an instance of an app template.
+ * Each job carries a walltime estimate, which the scheduler uses to plan ahead:
+ *   fcfs:         jobs start strictly in arrival order
+ *   easy:         the first blocked job gets a reservation, and later jobs may start
+ *                 early (backfill) if they do not delay it
+ *   conservative: every blocked job gets a reservation, and no job may delay an earlier one
+ * Once every job has finished, the launcher reports queue waits, utilization, and
+ * how many switches each job shared with concurrently running jobs.
+ */
+class BackfillJoblauncher : public JobLauncher
+{
+ public:
+  SST_ELI_REGISTER_DERIVED(
+    JobLauncher,
+    BackfillJoblauncher,
+    "macro",
+    "backfill",
+    SST_ELI_ELEMENT_VERSION(1,0,0),
+    "a batch scheduler that queues jobs and backfills them around reservations")
+
+  BackfillJoblauncher(SST::Params& params, OperatingSystem* os);
+
+  ~BackfillJoblauncher() override;
+
+ private:
+  typedef enum {
+    FCFS,
+    EASY,
+    CONSERVATIVE
+  } policy_t;
+
+  struct job {
+    AppLaunchRequest* request; //null once launched
+    int id; //the workload job number
+    std::string app; //the app template the job runs
+    int nnodes;
+    Timestamp submit;
+    TimeDelta estimate;
+    Timestamp start;
+    Timestamp end;
+    int nrunning_at_start;
+    std::set<SwitchId> switches;
+    std::set<SwitchId> shared_switches;
+  };
+
+  bool handleLaunchRequest(AppLaunchRequest* request, ordered_node_set& allocation) override;
+
+  void stopEventReceived(JobStopRequest* ev) override;
+
+  void addJob(AppLaunchRequest* request, int id, const std::string& app, TimeDelta estimate);
+
+  void addWorkload(SST::Params& params, const std::string& fname);
+
+  /**
+   * Launch every queued job the policy allows to start now
+   */
+  void schedule();
+
+  void startJob(AppId aid, const ordered_node_set& allocation);
+
+  void report();
+
+  policy_t policy_;
+  std::map<AppId, job> jobs_;
+  std::list<AppId> queue_;
+  std::set<AppId> running_;
+  std::map<SwitchId, std::set<AppId>> switch_jobs_;
+  int num_done_;
+
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,351 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#include <sstmac/software/launch/comm_graph_task_mapper.h>
+#include <sstmac/hardware/topology/topology.h>
+#include <sprockit/errors.h>
+#include <sprockit/fileio.h>
+#include <sprockit/sim_parameters.h>
+#include <sprockit/keyword_registration.h>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <queue>
+#include <sstream>
+#include <tuple>
+
+RegisterKeywords(
+{ "comm_graph_file", "a traffic matrix, either spyplot CSV output or one row of bytes per source rank" },
+{ "comm_graph_stat", "the statistic to use from spyplot CSV output - defaults to the first one" },
+{ "comm_graph_refine_passes", "the maximum number of swap passes to refine the greedy mapping" },
+);
+
+namespace sstmac {
+namespace sw {
+
+static void
+removeRank(std::vector<int>& ranks, int rank)
+{
+  ranks.erase(std::find(ranks.begin(), ranks.end(), rank));
+}
+
+CommGraphTaskMapper::CommGraphTaskMapper(SST::Params& params) :
+  TaskMapper(params)
+{
+  file_ = params.find<std::string>("comm_graph_file");
+  stat_name_ = params.find<std::string>("comm_graph_stat", "");
+  refine_passes_ = params.find<int>("comm_graph_refine_passes", 8);
+}
+
+void
+CommGraphTaskMapper::readTrafficMatrix(int nproc)
+{
+  std::ifstream in;
+  sprockit::SpktFileIO::openFile(in, file_);
+  if (!in.is_open()){
+    spkt_throw_printf(sprockit::InputError,
+     "CommGraphTaskMapper: could not find traffic matrix %s in current folder or configuration include path",
+     file_.c_str());
+  }
+
+  //sum both directions, since either way the bytes cross the same hops
+  std::vector<std::map<int,double>> matrix(nproc);
+  auto add = [&](int src, int dst, double bytes){
+    if (src >= nproc || dst >= nproc){
+      spkt_throw_printf(sprockit::ValueError,
+        "CommGraphTaskMapper: traffic matrix %s has traffic %d->%d, but the job only has %d ranks",
+        file_.c_str(), src, dst, nproc);
+    }
+    if (src != dst && bytes > 0){
+      matrix[src][dst] += bytes;
+      matrix[dst][src] += bytes;
+    }
+  };
+
+  std::string line;
+  std::getline(in, line);
+  if (line.compare(0, 15, "name,component,") == 0){
+    //CSV statistics output: one row per rank, columns spy0,spy1,...
+    std::vector<int> dst_cols;
+    std::stringstream header(line);
+    std::string token;
+    while (std::getline(header, token, ',')){
+      dst_cols.push_back(token.compare(0, 3, "spy") == 0 ? std::atoi(token.c_str() + 3) : -1);
+    }
+    while (std::getline(in, line)){
+      std::stringstream sstr(line);
+      std::string name, component;
+      std::getline(sstr, name, ',');
+      std::getline(sstr, component, ',');
+      if (stat_name_.empty()) stat_name_ = name;
+      if (name != stat_name_) continue;
+
+      size_t pos = component.rfind("rank");
+      if (pos == std::string::npos){
+        spkt_throw_printf(sprockit::InputError,
+          "CommGraphTaskMapper: component %s in %s is not a rank",
+          component.c_str(), file_.c_str());
+      }
+      int src = std::atoi(component.c_str() + pos + 4);
+      for (int col=2; std::getline(sstr, token, ',') && col < dst_cols.size(); ++col){
+        if (dst_cols[col] >= 0) add(src, dst_cols[col], std::atof(token.c_str()));
+      }
+    }
+  } else {
+    //a dense matrix, one row of bytes per source rank
+    int src = 0;
+    do {
+      std::replace(line.begin(), line.end(), ',', ' ');
+      std::stringstream sstr(line);
+      double bytes;
+      int dst = 0;
+      while (sstr >> bytes){
+        add(src, dst, bytes);
+        ++dst;
+      }
+      if (dst > 0) ++src;
+    } while (std::getline(in, line));
+  }
+
+  graph_.clear();
+  graph_.resize(nproc);
+  for (int src=0; src < nproc; ++src){
+    for (auto& pair : matrix[src]){
+      graph_[src].push_back({pair.first, pair.second});
+    }
+  }
+}
+
+int
+CommGraphTaskMapper::hops(int src_node, int dst_node) const
+{
+  if (src_node == dst_node) return 0;
+  return topology_->numHopsToNode(nodes_[src_node], nodes_[dst_node]);
+}
+
+double
+CommGraphTaskMapper::rankCost(int rank, int node, int exclude) const
+{
+  double cost = 0;
+  for (const edge& e : graph_[rank]){
+    int partner_node = rank_to_node_[e.rank];
+    //unplaced partners do not count yet
+    if (e.rank != exclude && partner_node >= 0){
+      cost += e.weight * hops(node, partner_node);
+    }
+  }
+  return cost;
+}
+
+double
+CommGraphTaskMapper::totalCost() const
+{
+  double cost = 0;
+  for (int rank=0; rank < graph_.size(); ++rank){
+    cost += rankCost(rank, rank_to_node_[rank]);
+  }
+  //every edge was counted from both ends
+  return cost / 2;
+}
+
+void
+CommGraphTaskMapper::placeGreedy(int ppn, int nproc)
+{
+  rank_to_node_.assign(nproc, -1);
+  node_to_ranks_.clear();
+  node_to_ranks_.resize(nodes_.size());
+
+  std::vector<int> open_nodes(nodes_.size());
+  for (int n=0; n < nodes_.size(); ++n) open_nodes[n] = n;
+
+  std::vector<double> volume(nproc, 0);
+  std::vector<double> connection(nproc, 0);
+  for (int rank=0; rank < nproc; ++rank){
+    for (const edge& e : graph_[rank]) volume[rank] += e.weight;
+  }
+
+  //order by bytes to placed ranks, then total bytes, then lowest rank
+  //entries go stale when a rank's connection grows and are skipped
+  typedef std::tuple<double,double,int> candidate;
+  std::priority_queue<candidate> queue;
+  for (int rank=0; rank < nproc; ++rank){
+    queue.emplace(0., volume[rank], -rank);
+  }
+
+  for (int nplaced=0; nplaced < nproc; ++nplaced){
+    int rank;
+    while (true){
+      candidate next = queue.top();
+      queue.pop();
+      rank = -std::get<2>(next);
+      if (rank_to_node_[rank] < 0 && std::get<0>(next) == connection[rank]) break;
+    }
+
+    int best_node = open_nodes.front();
+    if (connection[rank] > 0){
+      double best_cost = rankCost(rank, best_node);
+      for (int node : open_nodes){
+        double cost = rankCost(rank, node);
+        if (cost < best_cost){
+          best_cost = cost;
+          best_node = node;
+        }
+      }
+    }
+
+    debug_printf(sprockit::dbg::indexing,
+      "comm graph mapper: placing rank %d on node %d with %.0f bytes to placed ranks",
+      rank, int(nodes_[best_node]), connection[rank]);
+
+    rank_to_node_[rank] = best_node;
+    node_to_ranks_[best_node].push_back(rank);
+    if (node_to_ranks_[best_node].size() == ppn){
+      open_nodes.erase(std::find(open_nodes.begin(), open_nodes.end(), best_node));
+    }
+
+    for (const edge& e : graph_[rank]){
+      if (rank_to_node_[e.rank] < 0){
+        connection[e.rank] += e.weight;
+        queue.emplace(connection[e.rank], volume[e.rank], -e.rank);
+      }
+    }
+  }
+}
+
+int
+CommGraphTaskMapper::refine(int ppn)
+{
+  //only try nodes that hold a partner, which is where any gain must come from
+  int nmoves = 0;
+  for (int rank=0; rank < graph_.size(); ++rank){
+    for (const edge& e : graph_[rank]){
+      int src = rank_to_node_[rank];
+      int dst = rank_to_node_[e.rank];
+      if (src == dst) continue;
+
+      if (node_to_ranks_[dst].size() < ppn){
+        if (rankCost(rank, dst) < rankCost(rank, src)){
+          removeRank(node_to_ranks_[src], rank);
+          node_to_ranks_[dst].push_back(rank);
+          rank_to_node_[rank] = dst;
+          ++nmoves;
+        }
+        continue;
+      }
+
+      //the edge between the swapped ranks keeps its length, so leave it out
+      double best_delta = 0;
+      int best_other = -1;
+      for (int other : node_to_ranks_[dst]){
+        double delta = rankCost(rank, dst, other) - rankCost(rank, src, other)
+                     + rankCost(other, src, rank) - rankCost(other, dst, rank);
+        if (delta < best_delta){
+          best_delta = delta;
+          best_other = other;
+        }
+      }
+      if (best_other >= 0){
+        removeRank(node_to_ranks_[src], rank);
+        removeRank(node_to_ranks_[dst], best_other);
+        node_to_ranks_[dst].push_back(rank);
+        node_to_ranks_[src].push_back(best_other);
+        rank_to_node_[rank] = dst;
+        rank_to_node_[best_other] = src;
+        ++nmoves;
+      }
+    }
+  }
+  return nmoves;
+}
+
+void
+CommGraphTaskMapper::mapRanks(
+  const ordered_node_set& nodes,
+  int ppn,
+  std::vector<NodeId>& result,
+  int nproc)
+{
+  nproc = validateNproc(ppn, nodes.size(), nproc, "comm graph mapper");
+  nodes_.assign(nodes.begin(), nodes.end());
+  readTrafficMatrix(nproc);
+
+  //the block mapping is the baseline to beat
+  rank_to_node_.resize(nproc);
+  for (int rank=0; rank < nproc; ++rank){
+    rank_to_node_[rank] = rank / ppn;
+  }
+  double block_cost = totalCost();
+
+  placeGreedy(ppn, nproc);
+  double greedy_cost = totalCost();
+
+  for (int pass=0; pass < refine_passes_; ++pass){
+    int nmoves = refine(ppn);
+    debug_printf(sprockit::dbg::indexing,
+      "comm graph mapper: refinement pass %d moved %d ranks", pass, nmoves);
+    if (nmoves == 0) break;
+  }
+
+  double refined_cost = totalCost();
+  debug_printf(sprockit::dbg::indexing,
+    "comm graph mapper: hop-bytes %.0f for block mapping, %.0f greedy, %.0f refined",
+    block_cost, greedy_cost, refined_cost);
+
+  if (block_cost <= refined_cost){
+    //the greedy placement can lose to block on traffic the allocation already suits
+    debug_printf(sprockit::dbg::indexing,
+      "comm graph mapper: keeping the block mapping");
+    for (int rank=0; rank < nproc; ++rank){
+      rank_to_node_[rank] = rank / ppn;
+    }
+  }
+
+  result.resize(nproc);
+  for (int rank=0; rank < nproc; ++rank){
+    result[rank] = nodes_[rank_to_node_[rank]];
+  }
+}
+
+}
+}
@@ -0,0 +1,123 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#ifndef SSTMAC_SOFTWARE_LAUNCH_COMM_GRAPH_TASK_MAPPER_H_INCLUDED
+#define SSTMAC_SOFTWARE_LAUNCH_COMM_GRAPH_TASK_MAPPER_H_INCLUDED
+
+#include <sstmac/software/launch/task_mapper.h>
+
+namespace sstmac {
+namespace sw {
+
+/**
+ * Maps ranks onto the allocated nodes to minimize hop-bytes, the bytes
+ * each pair of ranks exchange weighted by the hops between their nodes.
+ * The traffic matrix comes from a prior run, either the CSV written by an
+ * mpi spyplot statistic or a dense matrix with one row per source rank.
+ * Traces can be turned into a matrix by replaying them with an mpi spyplot.
+ * Ranks are placed greedily, most connected to already-placed ranks first,
+ * each on the free node closest to its partners. Passes of pairwise swaps
+ * between partner nodes then refine the placement.
+ */
+class CommGraphTaskMapper : public TaskMapper
+{
+ public:
+  SST_ELI_REGISTER_DERIVED(
+    TaskMapper,
+    CommGraphTaskMapper,
+    "macro",
+    "comm_graph",
+    SST_ELI_ELEMENT_VERSION(1,0,0),
+    "assigns tasks to nodes to minimize hop-bytes for a given traffic matrix")
+
+  CommGraphTaskMapper(SST::Params& params);
+
+  std::string toString() const override {
+    return "comm graph task mapper";
+  }
+
+  ~CommGraphTaskMapper() throw() override {}
+
+  void mapRanks(const ordered_node_set& nodes,
+                int ppn,
+                std::vector<NodeId>& result,
+                int nproc) override;
+
+ private:
+  struct edge {
+    int rank;
+    double weight;
+  };
+
+  void readTrafficMatrix(int nproc);
+
+  int hops(int src_node, int dst_node) const;
+
+  /**
+   * @return The hop-bytes of all edges of rank if it sat on node,
+   *         excluding any edge to the rank exclude
+   */
+  double rankCost(int rank, int node, int exclude = -1) const;
+
+  double totalCost() const;
+
+  void placeGreedy(int ppn, int nproc);
+
+  int refine(int ppn);
+
+  std::string file_;
+  std::string stat_name_;
+  int refine_passes_;
+
+  std::vector<std::vector<edge>> graph_;
+  std::vector<NodeId> nodes_;
+  std::vector<int> rank_to_node_;
+  std::vector<std::vector<int>> node_to_ranks_;
+
+};
+
+}
+}
+
+#endif
@@ -117,15 +117,7 @@ class JobLauncher : public Service
   std::list<AppLaunchRequest*> initial_requests_;
   std::set<int> terminators_;
 
- private:
-  void addLaunchRequests(SST::Params& params);
-
-  /**
-   * @brief cleanup_app Perform all operations to free up resources associated with a job
-   * @param ev
-   */
-  void cleanupApp(JobStopRequest* ev);
-
+ protected:
   /**
    * @brief satisfy_launch_request Called by subclasses to cause a job to be launched
    *                This sends out launch messages to all the nodes involved, which will
@@ -136,6 +128,15 @@ class JobLauncher : public Service
    */
   void satisfyLaunchRequest(AppLaunchRequest* request, const ordered_node_set& allocation);
 
+ private:
+  void addLaunchRequests(SST::Params& params);
+
+  /**
+   * @brief cleanup_app Perform all operations to free up resources associated with a job
+   * @param ev
+   */
+  void cleanupApp(JobStopRequest* ev);
+
   /**
    * @brief handle_new_launch_request As if a new job had been submitted with qsub or salloc.
    * The JobLauncher receives a new request to launch an application, at which point
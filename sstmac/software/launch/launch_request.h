@@ -81,6 +81,10 @@ class SoftwareLaunchRequest
     return nproc_;
   }
 
+  int procsPerNode() const {
+    return procs_per_node_;
+  }
+
   Timestamp time() const {
     return time_;
   }
@@ -48,12 +48,23 @@ Questions? Contact sst-macro-help@sandia.gov
 namespace sstmac {
 namespace sw {
 
-std::vector<TaskMapping::ptr> TaskMapping::app_ids_launched_(1024);
+std::vector<TaskMapping::ptr> TaskMapping::app_ids_launched_;
 std::map<std::string, TaskMapping::ptr> TaskMapping::app_names_launched_;
-std::vector<int> TaskMapping::local_refcounts_(1024);
+std::vector<int> TaskMapping::local_refcounts_;
 
 static thread_lock lock;
 
+void
+TaskMapping::reserveApp(AppId aid)
+{
+  //app ids are never reused, e.g. by batch workloads
+  //launching thousands of jobs, so grow as they arrive
+  if (size_t(aid) >= app_ids_launched_.size()){
+    app_ids_launched_.resize(aid + 1);
+    local_refcounts_.resize(aid + 1);
+  }
+}
+
 TaskMapping::ptr
 TaskMapping::serialize_order(AppId aid, serializer &ser)
 {
@@ -70,6 +81,7 @@ TaskMapping::serialize_order(AppId aid, serializer &ser)
       mapping->node_to_rank_indexing_[nid].push_back(i);
     }
     lock.lock();
+    reserveApp(aid);
     auto existing = app_ids_launched_[aid];
     if (!existing){
       app_ids_launched_[aid] = mapping;
@@ -79,8 +91,7 @@ TaskMapping::serialize_order(AppId aid, serializer &ser)
     lock.unlock();
   } else {
     //packing or sizing
-    mapping = app_ids_launched_[aid];
-    if (!mapping) spkt_abort_printf("no task mapping exists for application %d", aid);
+    mapping = globalMapping(aid);
     int num_nodes = mapping->node_to_rank_indexing_.size();
     ser & num_nodes;
     ser & mapping->rank_to_node_indexing_;
@@ -101,10 +112,15 @@ TaskMapping::globalMapping(const std::string& name)
   return ret;
 }
 
-const TaskMapping::ptr&
+TaskMapping::ptr
 TaskMapping::globalMapping(AppId aid)
 {
-  auto& mapping = app_ids_launched_[aid];
+  lock.lock();
+  TaskMapping::ptr mapping;
+  if (size_t(aid) < app_ids_launched_.size()){
+    mapping = app_ids_launched_[aid];
+  }
+  lock.unlock();
   if (!mapping){
     spkt_abort_printf("No task mapping exists for app %d\n", aid);
   }
@@ -115,6 +131,7 @@ void
 TaskMapping::addGlobalMapping(AppId aid, const std::string &unique_name, const TaskMapping::ptr &mapping)
 {
   lock.lock();
+  reserveApp(aid);
   app_ids_launched_[aid] = mapping;
   app_names_launched_[unique_name] = mapping;
   local_refcounts_[aid]++;
@@ -99,7 +99,7 @@ class TaskMapping {
     return node_to_rank_indexing_;
   }
 
-  static const TaskMapping::ptr& globalMapping(AppId aid);
+  static TaskMapping::ptr globalMapping(AppId aid);
 
   static TaskMapping::ptr globalMapping(const std::string& unique_name);
 
@@ -119,6 +119,9 @@ class TaskMapping {
   static std::map<std::string, TaskMapping::ptr> app_names_launched_;
 
   static void deleteStatics();
+
+  /** Grow the per-app tables to hold aid. Must hold the lock */
+  static void reserveApp(AppId aid);
 };
 
 }
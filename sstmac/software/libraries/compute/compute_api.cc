@@ -57,6 +57,7 @@ using os = sstmac::sw::OperatingSystem;
 
 extern "C" double sstmac_block()
 {
+  os::currentOs()->flushCompute();
   os::currentOs()->block();
   return os::currentOs()->now().sec();
 }
@@ -162,7 +162,10 @@ This has to work from C, so we must regrettably use VA_ARGS
  * @brief sstmac_start_memoize
  * @param token
  * @param model
- * @return A thread tag to identify thread-local storage later
+ * @return A thread tag to identify thread-local storage later. The tag is negative
+ *         once enough executions have been recorded (in this run or a loaded memoize_file)
+ *         to predict the region. The region can then be skipped, and the finish call
+ *         advances time by the prediction instead of the measured time.
  */
 int sstmac_start_memoize(const char* token, const char* model);
 
@@ -87,19 +87,26 @@ LibComputeInst::computeDetailed(
   uint64_t bytes,
   int nthread)
 {
-  /** Configure the compute request */
-  auto cmsg = new ComputeEvent_impl<basic_instructions_st>;
-  basic_instructions_st& st = cmsg->data();
+  /** Configure the compute request - the processor only reads it
+   * while the thread is blocked, so it can live on the stack */
+  BasicComputeEvent cmsg;
+  basic_instructions_st& st = cmsg.data();
   st.flops = flops;
   st.intops = nintops;
   st.mem_sequential = bytes;
   st.nthread = nthread;
 
+  // Only the app's own compute can be deferred - a library call in progress
+  // has its own tag and may depend on the time right after this compute
+  Thread* thr = os_->activeThread();
+  if (thr->tag().id() == FTQTag::null.id() && os_->deferCompute(&cmsg, nthread)){
+    return;
+  }
+
   // Do not overwrite an existing tag
-  FTQScope scope(os_->activeThread(), FTQTag::compute);
+  FTQScope scope(thr, FTQTag::compute);
 
-  computeInst(cmsg, nthread);
-  delete cmsg;
+  computeInst(&cmsg, nthread);
 }
 
 void
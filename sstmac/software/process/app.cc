@@ -77,6 +77,7 @@ RegisterKeywords(
  { "min_op_cutoff", "the minimum number of operations in a compute before detailed modeling is perfromed" },
  { "notify", "whether the app should send completion notifications to job root" },
  { "globals_size", "the size of the global variable segment to allocate" },
+ { "copy_on_write_globals", "whether global variable segments should be copy-on-write mappings of one shared image" },
  { "OMP_NUM_THREADS", "environment variable for configuring openmp" },
  { "exe", "an optional exe .so file to load for this app" },
 );
@@ -134,9 +135,8 @@ static char* get_data_segment(SST::Params& params,
     }
   }
   if (allocSize != 0){
-    char* segment = new char[allocSize];
-    ::memcpy(segment, ctx.globalInit(), ctx.globalsSize());
-    return segment;
+    bool cow = params.find<bool>("copy_on_write_globals", false);
+    return ctx.allocateSegment(allocSize, cow);
   } else {
     return nullptr;
   }
@@ -358,7 +358,7 @@ App::~App()
   /** These get deleted by unregister */
   //sprockit::delete_vals(apis_);
   if (compute_lib_) delete compute_lib_;
-  if (globals_storage_) delete[] globals_storage_;
+  if (globals_storage_) GlobalVariable::glblCtx.freeSegment(globals_storage_);
 }
 
 std::ostream&
@@ -46,6 +46,21 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/software/process/operating_system.h>
 #include <sstmac/software/process/thread.h>
 #include <sstmac/software/process/cppglobal.h>
+#include <sstmac/common/thread_lock.h>
+#include <sprockit/errors.h>
+#include <sprockit/output.h>
+#include <sprockit/spkt_printf.h>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
 
 extern "C" {
 
@@ -85,6 +100,10 @@ GlobalVariableContext::init()
   stackOffset = 0;
   allocSize_ = 4096;
   globalInits = nullptr;
+  version_ = 0;
+  imageVersion_ = 0;
+  imageFd_ = -1;
+  imageSize_ = 0;
 }
 
 void
@@ -128,6 +147,7 @@ GlobalVariableContext::append(const int size, const char*  /*name*/)
   //fflush(stdout);
 
   stackOffset += offsetIncrement;
+  ++version_;
 
   return offset;
 }
@@ -182,6 +202,187 @@ GlobalVariableContext::initGlobalSpace(void* ptr, int size, int offset)
   //also do the global init for any new threads spawned
   char* dst = ((char*)globalInits) + offset;
   ::memcpy(dst, ptr, size);
+  ++version_;
+}
+
+namespace {
+
+struct CowStats {
+  uint64_t segments = 0;
+  uint64_t sharedPages = 0;
+  uint64_t privatePages = 0;
+};
+
+CowStats cow_stats;
+
+/** Copy-on-write segments that are still mapped, along with their mapped length.
+    Never destroyed since segments may be freed during static destruction. */
+std::unordered_map<char*, size_t>& cow_segments = *new std::unordered_map<char*, size_t>;
+
+/** Guards the images, cow_segments, and cow_stats against threads creating and
+    destroying ranks concurrently. Never destroyed for the same reason as the map. */
+sstmac::thread_lock& cow_lock = *new sstmac::thread_lock;
+
+size_t pageSize(){
+  static size_t size = ::sysconf(_SC_PAGESIZE);
+  return size;
+}
+
+size_t roundToPage(size_t size){
+  size_t page = pageSize();
+  return (size + page - 1) / page * page;
+}
+
+int createMemfd(){
+#if defined(__linux__) && defined(SYS_memfd_create)
+  return ::syscall(SYS_memfd_create, "sstmac_globals", 0);
+#else
+  return -1;
+#endif
+}
+
+/**
+ * Use /proc/self/pagemap to find which pages of a private file mapping
+ * have been copied. Pages that are still file-backed (or never touched)
+ * are shared with the image. Present pages that are no longer file-backed
+ * were written to and privately copied.
+ */
+void countPages(char* segment, size_t length, uint64_t& shared, uint64_t& priv)
+{
+  static int pagemap_fd = ::open("/proc/self/pagemap", O_RDONLY);
+  size_t page = pageSize();
+  size_t npages = length / page;
+  if (pagemap_fd < 0){
+    shared += npages;
+    return;
+  }
+
+  std::vector<uint64_t> entries(npages);
+  off_t offset = (uintptr_t(segment) / page) * sizeof(uint64_t);
+  ssize_t bytes = ::pread(pagemap_fd, entries.data(), npages*sizeof(uint64_t), offset);
+  if (bytes != ssize_t(npages*sizeof(uint64_t))){
+    shared += npages;
+    return;
+  }
+
+  for (uint64_t entry : entries){
+    bool present = (entry >> 63) & 1;
+    bool file_backed = (entry >> 61) & 1;
+    if (present && !file_backed) ++priv;
+    else ++shared;
+  }
+}
+
+}
+
+void
+GlobalVariableContext::refreshImage(int size)
+{
+  if (imageSize_ == size && imageVersion_ == version_){
+    return;
+  }
+
+  //existing segments keep the old image alive through their mappings,
+  //so rather than rewriting it under them a new image is always created
+  if (imageSize_ != 0){
+    ::close(imageFd_);
+    imageSize_ = 0;
+  }
+
+  int fd = createMemfd();
+  if (fd < 0){
+    return;
+  }
+
+  size_t length = roundToPage(size);
+  if (::ftruncate(fd, length) != 0){
+    ::close(fd);
+    return;
+  }
+
+  size_t initSize = std::min(size, stackOffset);
+  size_t written = 0;
+  while (written < initSize){
+    ssize_t rc = ::pwrite(fd, globalInits + written, initSize - written, written);
+    if (rc <= 0){
+      ::close(fd);
+      return;
+    }
+    written += rc;
+  }
+
+  imageFd_ = fd;
+  imageSize_ = size;
+  imageVersion_ = version_;
+}
+
+char*
+GlobalVariableContext::allocateSegment(int size, bool cow)
+{
+  if (cow){
+    cow_lock.lock();
+    refreshImage(size);
+    if (imageSize_ != 0){
+      size_t length = roundToPage(size);
+      void* ptr = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, imageFd_, 0);
+      if (ptr != MAP_FAILED){
+        char* segment = (char*) ptr;
+        cow_segments[segment] = length;
+        ++cow_stats.segments;
+        cow_lock.unlock();
+        return segment;
+      }
+    }
+    cow_lock.unlock();
+    static bool warned = false;
+    if (!warned){
+      cerr0 << "WARNING: could not map copy-on-write global segment - copying globals instead"
+            << std::endl;
+      warned = true;
+    }
+  }
+
+  char* segment = new char[size];
+  ::memcpy(segment, globalInits, std::min(size, stackOffset));
+  return segment;
+}
+
+void
+GlobalVariableContext::freeSegment(char* segment)
+{
+  //the count only grows, and a copy-on-write segment was counted before it was handed out
+  if (cow_stats.segments){
+    cow_lock.lock();
+    auto iter = cow_segments.find(segment);
+    if (iter != cow_segments.end()){
+      countPages(segment, iter->second, cow_stats.sharedPages, cow_stats.privatePages);
+      ::munmap(segment, iter->second);
+      cow_segments.erase(iter);
+      cow_lock.unlock();
+      return;
+    }
+    cow_lock.unlock();
+  }
+  delete[] segment;
+}
+
+void
+GlobalVariableContext::printSegmentStats(std::ostream& os)
+{
+  if (cow_stats.segments == 0) return;
+
+  cow_lock.lock();
+  uint64_t shared = cow_stats.sharedPages;
+  uint64_t priv = cow_stats.privatePages;
+  for (auto& pair : cow_segments){
+    countPages(pair.first, pair.second, shared, priv);
+  }
+  cow_lock.unlock();
+  //page counts depend on the host, so they go on their own line
+  os << sprockit::sprintf("Copy-on-write global segments: %llu\n",
+                          (unsigned long long) cow_stats.segments);
+  os << sprockit::sprintf("Copy-on-write global pages: %llu shared, %llu private\n",
+                          (unsigned long long) shared, (unsigned long long) priv);
 }
 
 }
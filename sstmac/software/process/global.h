@@ -50,6 +50,8 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <map>
 #include <functional>
 #include <unordered_set>
+#include <iosfwd>
+#include <cstdint>
 
 extern "C" int sstmac_global_stacksize;
 
@@ -73,6 +75,7 @@ class GlobalVariableContext {
 
   void setAllocSize(int sz){
     allocSize_ = sz;
+    ++version_;
   }
 
   void* globalInit() {
@@ -97,10 +100,35 @@ class GlobalVariableContext {
 
   void registerInitFxn(int offset, std::function<void(void*)>&& fxn);
 
+  /**
+   * @brief allocateSegment Allocate a data segment holding the initial values of all globals
+   * @param size The size of the segment in bytes
+   * @param cow Whether to map the segment as a private copy-on-write view of a single
+   *        shared image so that pages are only duplicated when a rank writes to them
+   * @return The new segment, to be released with freeSegment
+   */
+  char* allocateSegment(int size, bool cow);
+
+  void freeSegment(char* segment);
+
+  /**
+   * @brief printSegmentStats Print how many pages of copy-on-write segments
+   *        are still shared with the image and how many have been privately copied.
+   *        Does nothing if no copy-on-write segments were created.
+   */
+  static void printSegmentStats(std::ostream& os);
+
  private:
+  void refreshImage(int size);
+
   int stackOffset;
   char* globalInits;
   int allocSize_;
+  /** Bumped whenever globalInits changes so stale shared images are replaced */
+  uint64_t version_;
+  uint64_t imageVersion_;
+  int imageFd_;
+  int imageSize_;
   //these should be ordered by the offset in the data segment
   //this ensures as much as possible that global variables
   //are initialized in the same order in SST/macro as they would be in the real app
@@ -0,0 +1,548 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#include <sstmac/software/process/memoize.h>
+#include <sstmac/software/process/operating_system.h>
+#include <sstmac/software/process/thread.h>
+#include <sstmac/software/process/app.h>
+#include <sstmac/software/process/host_timer.h>
+#include <sstmac/software/libraries/compute/compute_api.h>
+#include <sstmac/common/thread_lock.h>
+#include <sprockit/keyword_registration.h>
+#include <sprockit/sim_parameters.h>
+#include <sprockit/errors.h>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <map>
+#include <algorithm>
+
+RegisterKeywords(
+{ "memoize_file", "file to load memoization models from at startup and write them to at exit" },
+);
+
+namespace sstmac {
+
+void
+MemoizationModel::addSample(double time, const double* params)
+{
+  Sample s;
+  s.time = time;
+  for (int i=0; i < nparams_; ++i) s.params[i] = params[i];
+  samples_.push_back(s);
+}
+
+double
+MemoizationModel::predict(const double* params)
+{
+  if (samples_.empty()){
+    spkt_abort_printf("cannot predict memoized region with no recorded executions");
+  }
+  if (fitted_samples_ != samples_.size()){
+    fit();
+    fitted_samples_ = samples_.size();
+  }
+  return std::max(0., evaluate(params));
+}
+
+void
+MemoizationModel::write(std::ostream& os) const
+{
+  for (const Sample& s : samples_){
+    os << s.time;
+    for (int i=0; i < nparams_; ++i) os << " " << s.params[i];
+    os << "\n";
+  }
+}
+
+void
+MemoizationModel::read(std::istream& is, int nsamples)
+{
+  for (int n=0; n < nsamples; ++n){
+    Sample s;
+    is >> s.time;
+    for (int i=0; i < nparams_; ++i) is >> s.params[i];
+    samples_.push_back(s);
+  }
+}
+
+template <class Fxn>
+void
+MemoizationModel::leastSquares(int nfeatures, Fxn&& features, std::vector<double>& coeffs) const
+{
+  //build the normal equations A^T A c = A^T t with a tiny ridge
+  //so that features that never varied do not make the system singular
+  int n = nfeatures;
+  std::vector<double> ata(n*(n+1), 0.);
+  std::vector<double> f(n);
+  for (const Sample& s : samples_){
+    features(s.params, f.data());
+    for (int i=0; i < n; ++i){
+      double* row = &ata[i*(n+1)];
+      for (int j=0; j < n; ++j) row[j] += f[i]*f[j];
+      row[n] += f[i]*s.time;
+    }
+  }
+  for (int i=0; i < n; ++i){
+    ata[i*(n+1)+i] += 1e-12 * (1. + ata[i*(n+1)+i]);
+  }
+
+  //gaussian elimination with partial pivoting
+  for (int col=0; col < n; ++col){
+    int pivot = col;
+    for (int r=col+1; r < n; ++r){
+      if (std::fabs(ata[r*(n+1)+col]) > std::fabs(ata[pivot*(n+1)+col])) pivot = r;
+    }
+    if (pivot != col){
+      for (int j=0; j <= n; ++j) std::swap(ata[col*(n+1)+j], ata[pivot*(n+1)+j]);
+    }
+    double diag = ata[col*(n+1)+col];
+    for (int r=col+1; r < n; ++r){
+      double factor = ata[r*(n+1)+col] / diag;
+      for (int j=col; j <= n; ++j) ata[r*(n+1)+j] -= factor * ata[col*(n+1)+j];
+    }
+  }
+  coeffs.resize(n);
+  for (int row=n-1; row >= 0; --row){
+    double sum = ata[row*(n+1)+n];
+    for (int j=row+1; j < n; ++j) sum -= ata[row*(n+1)+j] * coeffs[j];
+    coeffs[row] = sum / ata[row*(n+1)+row];
+  }
+}
+
+void
+LookupMemoization::fit()
+{
+  //average repeated executions with identical inputs
+  std::map<std::vector<double>, std::pair<double,int>> averages;
+  for (const Sample& s : samples_){
+    auto& entry = averages[std::vector<double>(s.params, s.params + nparams_)];
+    entry.first += s.time;
+    entry.second += 1;
+  }
+  table_.clear();
+  for (auto& pair : averages){
+    Sample s;
+    s.time = pair.second.first / pair.second.second;
+    std::copy(pair.first.begin(), pair.first.end(), s.params);
+    table_.push_back(s);
+  }
+}
+
+double
+LookupMemoization::evaluate(const double* params) const
+{
+  const Sample* closest = nullptr;
+  double min_dist = 0;
+  for (const Sample& s : table_){
+    double dist = 0;
+    for (int i=0; i < nparams_; ++i){
+      double delta = s.params[i] - params[i];
+      dist += delta*delta;
+    }
+    if (!closest || dist < min_dist){
+      closest = &s;
+      min_dist = dist;
+    }
+  }
+  return closest->time;
+}
+
+void
+LinearMemoization::fit()
+{
+  int np = nparams_;
+  leastSquares(np + 1, [np](const double* p, double* f){
+    f[0] = 1.;
+    for (int i=0; i < np; ++i) f[i+1] = p[i];
+  }, coeffs_);
+}
+
+double
+LinearMemoization::evaluate(const double* params) const
+{
+  double t = coeffs_[0];
+  for (int i=0; i < nparams_; ++i) t += coeffs_[i+1] * params[i];
+  return t;
+}
+
+static void
+quadraticFeatures(int np, const double* p, double* f)
+{
+  int idx = 0;
+  f[idx++] = 1.;
+  for (int i=0; i < np; ++i) f[idx++] = p[i];
+  for (int i=0; i < np; ++i){
+    for (int j=i; j < np; ++j) f[idx++] = p[i]*p[j];
+  }
+}
+
+void
+PolynomialMemoization::fit()
+{
+  int np = nparams_;
+  leastSquares(numFeatures(), [np](const double* p, double* f){
+    quadraticFeatures(np, p, f);
+  }, coeffs_);
+}
+
+double
+PolynomialMemoization::evaluate(const double* params) const
+{
+  std::vector<double> f(numFeatures());
+  quadraticFeatures(nparams_, params, f.data());
+  double t = 0;
+  for (size_t i=0; i < f.size(); ++i) t += coeffs_[i] * f[i];
+  return t;
+}
+
+/**
+ * All memoized regions in the process, shared by every simulated rank
+ * so that each real execution improves the fit for all of them
+ */
+class MemoizationRegistry : public Lockable
+{
+ public:
+  struct Region {
+    std::string model_name;
+    MemoizationModel* model = nullptr;
+  };
+
+  static MemoizationRegistry& get(){
+    static MemoizationRegistry reg;
+    return reg;
+  }
+
+  ~MemoizationRegistry(){
+    if (!file_.empty()){
+      std::ofstream out(file_);
+      for (auto& pair : regions_){
+        MemoizationModel* model = pair.second.model;
+        if (!model) continue;
+        std::stringstream sstr;
+        model->write(sstr);
+        std::string samples = sstr.str();
+        int nsamples = std::count(samples.begin(), samples.end(), '\n');
+        out << pair.first << " " << pair.second.model_name << " "
+            << model->numParams() << " " << nsamples << "\n" << samples;
+      }
+    }
+    for (auto& pair : regions_){
+      if (pair.second.model) delete pair.second.model;
+    }
+  }
+
+  /**
+   * @brief region Must be called with the lock held
+   * @param token
+   * @return The region for the token in the current thread's implicit state
+   */
+  Region& region(const char* token){
+    if (!initialized_) init();
+    return regions_[key(token)];
+  }
+
+  int startTimer(){
+    int tag;
+    if (free_timers_.empty()){
+      tag = timers_.size();
+      timers_.emplace_back();
+    } else {
+      tag = free_timers_.back();
+      free_timers_.pop_back();
+    }
+    timers_[tag].start();
+    return tag;
+  }
+
+  double stopTimer(int tag){
+    free_timers_.push_back(tag);
+    return timers_[tag].stamp();
+  }
+
+  void setImplicitState(int type, int state){
+    implicit_states_[sw::OperatingSystem::currentThread()][type] = state;
+  }
+
+  void unsetImplicitState(int type){
+    auto iter = implicit_states_.find(sw::OperatingSystem::currentThread());
+    if (iter == implicit_states_.end()) return;
+    iter->second.erase(type);
+    if (iter->second.empty()) implicit_states_.erase(iter);
+  }
+
+ private:
+  MemoizationRegistry() : initialized_(false) {}
+
+  std::string key(const char* token) const {
+    auto iter = implicit_states_.find(sw::OperatingSystem::currentThread());
+    if (iter == implicit_states_.end()) return token;
+
+    std::string ret(token);
+    for (auto& pair : iter->second){
+      ret += sprockit::sprintf("@%d=%d", pair.first, pair.second);
+    }
+    return ret;
+  }
+
+  void init(){
+    initialized_ = true;
+    SST::Params& params = sw::OperatingSystem::currentThread()->parentApp()->params();
+    file_ = params.find<std::string>("memoize_file", "");
+    if (file_.empty()) return;
+
+    std::ifstream in(file_);
+    std::string name, model_name;
+    int nparams, nsamples;
+    while (in >> name >> model_name >> nparams >> nsamples){
+      Region& reg = regions_[name];
+      reg.model_name = model_name;
+      reg.model = sprockit::create<MemoizationModel>("macro", model_name, nparams);
+      reg.model->read(in, nsamples);
+    }
+  }
+
+  bool initialized_;
+  std::string file_;
+  std::map<std::string, Region> regions_;
+  std::vector<HostTimer> timers_;
+  std::vector<int> free_timers_;
+  std::map<sw::Thread*, std::map<int,int>> implicit_states_;
+};
+
+Memoization::Memoization(const char* name, const char* model)
+{
+  auto& reg = MemoizationRegistry::get();
+  reg.lock();
+  auto& region = reg.region(name);
+  if (region.model_name.empty()) region.model_name = model;
+  reg.unlock();
+}
+
+static void
+computeMemoize(const char* token, int nparams, const double* params)
+{
+  auto& reg = MemoizationRegistry::get();
+  reg.lock();
+  auto& region = reg.region(token);
+  if (!region.model){
+    reg.unlock();
+    spkt_abort_printf("memoized region %s has never been executed and has no model - "
+                      "run it unskeletonized or provide memoize_file", token);
+  }
+  double time = region.model->predict(params);
+  reg.unlock();
+  sstmac_compute(time);
+}
+
+static void
+finishMemoize(int thr_tag, const char* token, int nparams, const double* params)
+{
+  if (thr_tag < 0){
+    //the region was skipped since the model can already predict it
+    computeMemoize(token, nparams, params);
+    return;
+  }
+
+  auto& reg = MemoizationRegistry::get();
+  reg.lock();
+  double time = reg.stopTimer(thr_tag);
+  auto& region = reg.region(token);
+  if (!region.model){
+    region.model = sprockit::create<MemoizationModel>("macro", region.model_name, nparams);
+  } else if (region.model->numParams() != nparams){
+    reg.unlock();
+    spkt_abort_printf("memoized region %s finished with %d parameters, but was recorded with %d",
+                      token, nparams, region.model->numParams());
+  }
+  region.model->addSample(time, params);
+  reg.unlock();
+
+  //the real region ran on the host, now account for it in simulated time
+  sstmac_compute(time);
+}
+
+}
+
+using sstmac::MemoizationRegistry;
+
+extern "C" int sstmac_start_memoize(const char* token, const char* model)
+{
+  auto& reg = MemoizationRegistry::get();
+  reg.lock();
+  auto& region = reg.region(token);
+  if (region.model_name.empty()) region.model_name = model;
+  int tag = region.model && region.model->ready() ? -1 : reg.startTimer();
+  reg.unlock();
+  return tag;
+}
+
+extern "C" void sstmac_finish_memoize0(int thr_tag, const char* token)
+{
+  sstmac::finishMemoize(thr_tag, token, 0, nullptr);
+}
+
+extern "C" void sstmac_finish_memoize1(int thr_tag, const char* token, double p1)
+{
+  double params[] = {p1};
+  sstmac::finishMemoize(thr_tag, token, 1, params);
+}
+
+extern "C" void sstmac_finish_memoize2(int thr_tag, const char* token, double p1, double p2)
+{
+  double params[] = {p1, p2};
+  sstmac::finishMemoize(thr_tag, token, 2, params);
+}
+
+extern "C" void sstmac_finish_memoize3(int thr_tag, const char* token, double p1, double p2,
+                                       double p3)
+{
+  double params[] = {p1, p2, p3};
+  sstmac::finishMemoize(thr_tag, token, 3, params);
+}
+
+extern "C" void sstmac_finish_memoize4(int thr_tag, const char* token, double p1, double p2,
+                                       double p3, double p4)
+{
+  double params[] = {p1, p2, p3, p4};
+  sstmac::finishMemoize(thr_tag, token, 4, params);
+}
+
+extern "C" void sstmac_finish_memoize5(int thr_tag, const char* token, double p1, double p2,
+                                       double p3, double p4, double p5)
+{
+  double params[] = {p1, p2, p3, p4, p5};
+  sstmac::finishMemoize(thr_tag, token, 5, params);
+}
+
+extern "C" void sstmac_compute_memoize0(const char* token)
+{
+  sstmac::computeMemoize(token, 0, nullptr);
+}
+
+extern "C" void sstmac_compute_memoize1(const char* token, double p1)
+{
+  double params[] = {p1};
+  sstmac::computeMemoize(token, 1, params);
+}
+
+extern "C" void sstmac_compute_memoize2(const char* token, double p1, double p2)
+{
+  double params[] = {p1, p2};
+  sstmac::computeMemoize(token, 2, params);
+}
+
+extern "C" void sstmac_compute_memoize3(const char* token, double p1, double p2,
+                                        double p3)
+{
+  double params[] = {p1, p2, p3};
+  sstmac::computeMemoize(token, 3, params);
+}
+
+extern "C" void sstmac_compute_memoize4(const char* token, double p1, double p2,
+                                        double p3, double p4)
+{
+  double params[] = {p1, p2, p3, p4};
+  sstmac::computeMemoize(token, 4, params);
+}
+
+extern "C" void sstmac_compute_memoize5(const char* token, double p1, double p2,
+                                        double p3, double p4, double p5)
+{
+  double params[] = {p1, p2, p3, p4, p5};
+  sstmac::computeMemoize(token, 5, params);
+}
+
+static void setImplicitMemoizeState(int type, int state)
+{
+  auto& reg = MemoizationRegistry::get();
+  reg.lock();
+  reg.setImplicitState(type, state);
+  reg.unlock();
+}
+
+static void unsetImplicitMemoizeState(int type)
+{
+  auto& reg = MemoizationRegistry::get();
+  reg.lock();
+  reg.unsetImplicitState(type);
+  reg.unlock();
+}
+
+extern "C" void sstmac_set_implicit_memoize_state1(int type0, int state0)
+{
+  setImplicitMemoizeState(type0, state0);
+}
+
+extern "C" void sstmac_set_implicit_memoize_state2(int type0, int state0, int type1, int state1)
+{
+  setImplicitMemoizeState(type0, state0);
+  setImplicitMemoizeState(type1, state1);
+}
+
+extern "C" void sstmac_set_implicit_memoize_state3(int type0, int state0, int type1, int state1,
+                                                   int type2, int state2)
+{
+  setImplicitMemoizeState(type0, state0);
+  setImplicitMemoizeState(type1, state1);
+  setImplicitMemoizeState(type2, state2);
+}
+
+extern "C" void sstmac_unset_implicit_memoize_state1(int type0)
+{
+  unsetImplicitMemoizeState(type0);
+}
+
+extern "C" void sstmac_unset_implicit_memoize_state2(int type0, int type1)
+{
+  unsetImplicitMemoizeState(type0);
+  unsetImplicitMemoizeState(type1);
+}
+
+extern "C" void sstmac_unset_implicit_memoize_state3(int type0, int type1, int type2)
+{
+  unsetImplicitMemoizeState(type0);
+  unsetImplicitMemoizeState(type1);
+  unsetImplicitMemoizeState(type2);
+}
@@ -41,15 +41,194 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 Questions? Contact sst-macro-help@sandia.gov
 */
+
 #ifndef sstmac_sw_process_memoize_h
 #define sstmac_sw_process_memoize_h
 
+#include <sstmac/sst_core/integrated_component.h>
+#include <sprockit/factory.h>
+#include <iostream>
+#include <vector>
+#include <string>
+
 namespace sstmac {
 
+/**
+ * Registers a memoized region ahead of its first use. The model named here
+ * is used if the region has not already been loaded from a memoization file.
+ */
 struct Memoization {
   Memoization(const char* name, const char* model);
 };
 
+/**
+ * @brief The MemoizationModel class
+ * Fits the host time of a memoized region as a function of
+ * up to 5 input parameters (p1..p5) recorded on real executions.
+ */
+class MemoizationModel
+{
+ public:
+  SST_ELI_DECLARE_BASE(MemoizationModel)
+  SST_ELI_DECLARE_DEFAULT_INFO()
+  SST_ELI_DECLARE_CTOR(int)
+
+  virtual ~MemoizationModel(){}
+
+  /**
+   * @brief addSample Record one real execution
+   * @param time   The host time in seconds
+   * @param params The nparams input values
+   */
+  void addSample(double time, const double* params);
+
+  /**
+   * @brief predict
+   * @param params The nparams input values
+   * @return The predicted time in seconds
+   */
+  double predict(const double* params);
+
+  /**
+   * @return Whether there are enough samples to stop running the real region
+   */
+  bool ready() const {
+    return samples_.size() >= minSamples();
+  }
+
+  int numParams() const {
+    return nparams_;
+  }
+
+  /**
+   * Write the samples as lines of "time p1 ... pn". Fits are recomputed
+   * from samples on load, which allows later runs to keep refining them.
+   */
+  void write(std::ostream& os) const;
+
+  void read(std::istream& is, int nsamples);
+
+ protected:
+  MemoizationModel(int nparams) :
+    nparams_(nparams), fitted_samples_(0)
+  {
+  }
+
+  struct Sample {
+    double time;
+    double params[5];
+  };
+
+  virtual size_t minSamples() const = 0;
+
+  virtual void fit() = 0;
+
+  virtual double evaluate(const double* params) const = 0;
+
+  /**
+   * @brief leastSquares Solve for the coefficients minimizing the error
+   *  of time ~ sum c_i f_i(params) over all samples
+   * @param features Computes the feature vector for the given params
+   * @param coeffs  [out]
+   */
+  template <class Fxn>
+  void leastSquares(int nfeatures, Fxn&& features, std::vector<double>& coeffs) const;
+
+  int nparams_;
+  std::vector<Sample> samples_;
+
+ private:
+  size_t fitted_samples_;
+};
+
+/**
+ * Prediction from the mean time of the closest previously seen inputs
+ */
+class LookupMemoization : public MemoizationModel
+{
+ public:
+  SST_ELI_REGISTER_DERIVED(
+    MemoizationModel,
+    LookupMemoization,
+    "macro",
+    "lookup",
+    SST_ELI_ELEMENT_VERSION(1,0,0),
+    "nearest-neighbor lookup table of recorded executions")
+
+  LookupMemoization(int nparams) : MemoizationModel(nparams) {}
+
+ private:
+  size_t minSamples() const override {
+    return 1;
+  }
+
+  void fit() override;
+
+  double evaluate(const double* params) const override;
+
+  std::vector<Sample> table_;
+};
+
+/**
+ * Prediction from time = c0 + c1*p1 + ... + cn*pn
+ */
+class LinearMemoization : public MemoizationModel
+{
+ public:
+  SST_ELI_REGISTER_DERIVED(
+    MemoizationModel,
+    LinearMemoization,
+    "macro",
+    "linear",
+    SST_ELI_ELEMENT_VERSION(1,0,0),
+    "linear least-squares fit in the input parameters")
+
+  LinearMemoization(int nparams) : MemoizationModel(nparams) {}
+
+ private:
+  size_t minSamples() const override {
+    return 2*(nparams_ + 1);
+  }
+
+  void fit() override;
+
+  double evaluate(const double* params) const override;
+
+  std::vector<double> coeffs_;
+};
+
+/**
+ * Prediction from a full quadratic in the input parameters
+ */
+class PolynomialMemoization : public MemoizationModel
+{
+ public:
+  SST_ELI_REGISTER_DERIVED(
+    MemoizationModel,
+    PolynomialMemoization,
+    "macro",
+    "polynomial",
+    SST_ELI_ELEMENT_VERSION(1,0,0),
+    "quadratic least-squares fit in the input parameters")
+
+  PolynomialMemoization(int nparams) : MemoizationModel(nparams) {}
+
+ private:
+  size_t minSamples() const override {
+    return 2*numFeatures();
+  }
+
+  int numFeatures() const {
+    return 1 + nparams_ + nparams_*(nparams_+1)/2;
+  }
+
+  void fit() override;
+
+  double evaluate(const double* params) const override;
+
+  std::vector<double> coeffs_;
+};
+
 }
 
 #endif
@@ -100,10 +100,13 @@ RegisterNamespaces("callGraph", "ftq");
 RegisterKeywords(
 { "stack_size", "the size of stack to allocate to each user-space thread" },
 { "stack_chunk_size", "the block size to allocate in the memory pool when more stacks are needed" },
+{ "stack_release", "how free stacks return pages to the system: none, dontneed, or free" },
+{ "stack_watermark", "whether to measure and report the deepest use of each user-space thread stack" },
 { "ftq", "DEPRECATED: sets the fileroot of the FTQ statistic" },
 { "ftq_epoch", "DEPRECATED: sets the time epoch size for the FTQ statistic" },
 { "callGraph", "DEPRECATED: sets the fileroot of the call graph statistic" },
 { "compute_scheduler", "the type of compute scheduler or assigning cores to computation" },
+{ "compute_fast_path", "whether to accumulate consecutive instruction-level compute on a thread and evaluate it analytically" },
 { "context", "the user-space thread context library" },
 );
 
@@ -164,6 +167,7 @@ OperatingSystem::OperatingSystem(uint32_t id, SST::Params& params, hw::Node* par
   des_context_(nullptr),
   params_(params),
   compute_sched_(nullptr),
+  compute_fast_path_(false),
   sync_tunnel_(nullptr),
   next_condition_(0),
   next_mutex_(0)
@@ -189,6 +193,8 @@ OperatingSystem::OperatingSystem(uint32_t id, SST::Params& params, hw::Node* par
     "macro", params.find<std::string>("compute_scheduler", "simple"),
     params, this, node_ ? node_->proc()->ncores() : 1, node_ ? node_->nsocket() : 1);
 
+  compute_fast_path_ = params.find<bool>("compute_fast_path", false);
+
   StackAlloc::init(params);
 
   SST::Params env_params = params.get_scoped_params("env");
@@ -300,6 +306,7 @@ OperatingSystem::deleteStatics()
 void
 OperatingSystem::sleep(TimeDelta t)
 {
+  flushCompute();
   CallGraphAppend(sleep);
   FTQScope scope(active_thread_, FTQTag::sleep);
 
@@ -315,6 +322,7 @@ OperatingSystem::sleep(TimeDelta t)
 void
 OperatingSystem::sleepUntil(Timestamp t)
 {
+  flushCompute();
   Timestamp now_ = now();
   if (t > now_){
     FTQScope scope(active_thread_, FTQTag::sleep);
@@ -331,6 +339,7 @@ OperatingSystem::sleepUntil(Timestamp t)
 void
 OperatingSystem::compute(TimeDelta t)
 {
+  flushCompute();
   // guard the ftq tag in this function
   FTQScope scope(active_thread_, FTQTag::compute);
 
@@ -354,6 +363,7 @@ OperatingSystem::nicCtrlIoctl()
 void
 OperatingSystem::execute(ami::COMP_FUNC func, Event *data, int nthr)
 {
+  flushCompute();
   int owned_ncores = active_thread_->numActiveCcores();
   if (owned_ncores < nthr){
     compute_sched_->reserveCores(nthr-owned_ncores, active_thread_);
@@ -451,9 +461,50 @@ OperatingSystem::reassignCores(Thread *thr)
   compute_sched_->reserveCores(ncores, thr);
 }
 
+bool
+OperatingSystem::deferCompute(Event* data, int nthr)
+{
+  //no cores need to be reserved and no call graph
+  //needs each compute attributed separately
+  if (!compute_fast_path_ || active_thread_->numActiveCcores() < nthr
+      || active_thread_->callGraph()){
+    return false;
+  }
+
+  Timestamp start = now() + active_thread_->pendingCompute();
+  TimeDelta delay;
+  if (node_->proc()->computeTime(data, start, delay)){
+    active_thread_->addPendingCompute(delay);
+    return true;
+  }
+  return false;
+}
+
+void
+OperatingSystem::flushCompute()
+{
+  if (!active_thread_ || active_thread_->pendingCompute().ticks() == 0){
+    return;
+  }
+
+  //the time was accumulated as compute, whatever the thread is doing now
+  Thread* thr = active_thread_;
+  FTQTag prev_tag = thr->tag();
+  thr->setTag(FTQTag::compute);
+  sendDelayedExecutionEvent(thr->takePendingCompute(), new sw::UnblockEvent(this, thr));
+  block();
+  thr->setTag(prev_tag);
+}
+
 void
 OperatingSystem::block()
 {
+#if SSTMAC_SANITY_CHECK
+  if (active_thread_->pendingCompute().ticks()){
+    spkt_abort_printf("thread %d blocking on node %d without flushing fast path compute",
+                      active_thread_->threadId(), my_addr_);
+  }
+#endif
   Timestamp before = now();
   //back to main DES thread
   ThreadContext* old_context = active_thread_->context();
@@ -507,6 +558,7 @@ OperatingSystem::setIpcName(const std::string &name)
 void
 OperatingSystem::blockTimeout(TimeDelta delay)
 {
+  flushCompute();
   sendDelayedExecutionEvent(delay, new TimeoutEvent(this, active_thread_));
   block();
 }
@@ -526,6 +578,7 @@ OperatingSystem::unblock(Thread* thr)
 void
 OperatingSystem::joinThread(Thread* t)
 {
+  flushCompute();
   if (t->getState() != Thread::DONE) {
     //key* k = key::construct();
     os_debug("joining thread %ld - thread not done so blocking on thread %p",
@@ -296,6 +296,21 @@ class OperatingSystem : public SubComponent
    */
   void compute(TimeDelta t);
 
+  /**
+   * @brief deferCompute With the compute fast path, evaluate an instruction-level
+   *        compute analytically and accumulate it on the active thread without blocking.
+   * @param data  Event carrying all the data describing the compute
+   * @param nthr  The number of threads that need to execute
+   * @return Whether the compute was deferred. If not, it must go through #execute.
+   */
+  bool deferCompute(Event* data, int nthr);
+
+  /**
+   * @brief flushCompute Block the active thread for any compute accumulated by #deferCompute.
+   *        This must be called before the thread communicates, synchronizes, or reads the clock.
+   */
+  void flushCompute();
+
   static void initThreads(int nthread);
 
   void killNode();
@@ -405,6 +420,8 @@ class OperatingSystem : public SubComponent
 
   ComputeScheduler* compute_sched_;
 
+  bool compute_fast_path_;
+
   std::map<uint32_t, Thread*> running_threads_;
 
   int next_condition_;
@@ -116,6 +116,7 @@ Thread::cleanup()
     //no matter what, I have to delete myself
     os_->scheduleThreadDeletion(this);
   }
+  os_->flushCompute();
   // We are done, ask the scheduler to remove this task from the
   state_ = DONE;
 
@@ -213,6 +214,7 @@ Thread::Thread(SST::Params& params, SoftwareId sid, OperatingSystem* os) :
 void
 Thread::startAPICall()
 {
+  os_->flushCompute();
   if (host_timer_){
     double duration = host_timer_->stamp();
     debug_printf(sprockit::dbg::host_compute,
@@ -312,7 +314,7 @@ Thread::~Thread()
     context_->destroyContext();
     delete context_;
   }
-  if (tls_storage_) delete[] tls_storage_;
+  if (tls_storage_) GlobalVariable::tlsCtx.freeSegment(tls_storage_);
   if (host_timer_) delete host_timer_;
 }
 
@@ -375,6 +377,7 @@ void
 Thread::startThread(Thread* thr)
 {
   thr->p_txt_ = p_txt_;
+  os_->flushCompute();
   os_->startThread(thr);
 }
 
@@ -452,6 +455,7 @@ stdMutex::stdMutex()
 
 void stdMutex::lock()
 {
+  parent_app_->os()->flushCompute();
   mutex_t* mut = parent_app_->getMutex(id_);
   if (mut == nullptr){
     spkt_abort_printf("error: bad mutex id for std::mutex: %d", id_);
@@ -470,6 +474,7 @@ stdMutex::~stdMutex()
 
 void stdMutex::unlock()
 {
+  parent_app_->os()->flushCompute();
   mutex_t* mut = parent_app_->getMutex(id_);
   if (mut == nullptr || !mut->locked){
     return;
@@ -385,6 +385,24 @@ class Thread
     return callGraph_;
   }
 
+  /**
+   * @brief Compute deferred by the OS compute fast path that the thread
+   *        has not yet advanced past
+   */
+  TimeDelta pendingCompute() const {
+    return pending_compute_;
+  }
+
+  void addPendingCompute(TimeDelta t){
+    pending_compute_ += t;
+  }
+
+  TimeDelta takePendingCompute(){
+    TimeDelta t = pending_compute_;
+    pending_compute_ = TimeDelta();
+    return t;
+  }
+
  protected:
   Thread(SST::Params& params,
          SoftwareId sid, OperatingSystem* os);
@@ -474,6 +492,8 @@ class Thread
 
   FTQCalendar* ftq_trace_;
 
+  TimeDelta pending_compute_;
+
 };
 
 }
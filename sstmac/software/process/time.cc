@@ -54,6 +54,7 @@ using sstmac::Timestamp;
 extern "C" int SSTMAC_gettimeofday(struct timeval* tv, struct timezone*  /*tz*/)
 {
   OperatingSystem* os = OperatingSystem::currentOs();
+  os->flushCompute();
   uint64_t usecs = os->now().usecRounded();
   tv->tv_sec =  usecs / 1000000;
   tv->tv_usec = usecs % 1000000;
@@ -63,6 +64,7 @@ extern "C" int SSTMAC_gettimeofday(struct timeval* tv, struct timezone*  /*tz*/)
 extern "C" int SSTMAC_clock_gettime(clockid_t  /*id*/, struct timespec *ts)
 {
   OperatingSystem* os = OperatingSystem::currentOs();
+  os->flushCompute();
   uint64_t nsecs = os->now().nsecRounded();
   ts->tv_sec =  nsecs / 1000000000;
   ts->tv_nsec = nsecs % 1000000000;
@@ -81,6 +83,7 @@ extern "C" int sstmac_ts_nanosleep(const struct timespec *req, struct timespec *
 extern "C" double sstmac_virtual_time()
 {
   OperatingSystem* os = OperatingSystem::currentOs();
+  os->flushCompute();
   return os->now().sec();
 }
 
@@ -45,10 +45,15 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/software/threading/stack_alloc.h>
 #include <sstmac/software/threading/stack_alloc_chunk.h>
 #include <sstmac/software/process/thread_info.h>
+#include <sstmac/software/process/tls.h>
 #include <sstmac/common/thread_lock.h>
 #include <sprockit/errors.h>
 #include <sprockit/sim_parameters.h>
+#include <sprockit/spkt_printf.h>
+#include <sys/mman.h>
 #include <unistd.h>
+#include <algorithm>
+#include <iostream>
 
 namespace sstmac {
 namespace sw {
@@ -57,6 +62,15 @@ StackAlloc::chunk_set StackAlloc::chunks_;
 size_t StackAlloc::suggested_chunk_ = 0;
 size_t StackAlloc::stacksize_ = 0;
 bool StackAlloc::protect_stacks_ = false;
+StackAlloc::release_t StackAlloc::release_ = StackAlloc::release_none;
+bool StackAlloc::watermark_ = false;
+StackAlloc::watermark_stats StackAlloc::watermarks_ = {0, 0, 0};
+
+#ifdef __APPLE__
+typedef char mincore_vec_t;
+#else
+typedef unsigned char mincore_vec_t;
+#endif
 
 void
 StackAlloc::init(SST::Params& params)
@@ -76,16 +90,26 @@ StackAlloc::init(SST::Params& params)
   stacksize_ = sstmac_global_stacksize;
 
   protect_stacks_ = params.find<bool>("protect_stacks", false);
+
+  std::string release = params.find<std::string>("stack_release", "none");
+  if (release == "none"){
+    release_ = release_none;
+  } else if (release == "dontneed"){
+    release_ = release_dontneed;
+  } else if (release == "free"){
+    release_ = release_free;
+  } else {
+    spkt_abort_printf("invalid stack_release %s: must be none, dontneed, or free",
+                      release.c_str());
+  }
+  watermark_ = params.find<bool>("stack_watermark", false);
 }
 
 void
 StackAlloc::chunk_set::clear()
 {
-  for (chunk* ch : allocations){
-    //this leads to an munmap during cxa_finalize
-    //which segfaults for no apparent reason
-    //delete ch;
-  }
+  //deleting the chunks leads to an munmap during cxa_finalize
+  //which segfaults for no apparent reason, so they are left to the OS
   allocations.clear();
   available.clear();
 }
@@ -104,7 +128,8 @@ StackAlloc::alloc()
 
   if(chunks_.available.empty()){
     // grab a new chunk.
-    chunk* new_chunk = new chunk(stacksize_, suggested_chunk_, protect_stacks_);
+    chunk* new_chunk = new chunk(stacksize_, suggested_chunk_, protect_stacks_,
+                                 release_ != release_none);
     chunks_.allocations.push_back(new_chunk);
     void* buf = new_chunk->getNextStack();
     while (buf != nullptr){
@@ -125,10 +150,64 @@ void StackAlloc::free(void* buf)
 {
   static thread_lock lock; 
   lock.lock();
+  if (watermark_){
+    size_t depth = watermark(buf);
+    watermarks_.nstacks++;
+    watermarks_.total += depth;
+    watermarks_.max = std::max<uint64_t>(watermarks_.max, depth);
+  }
+  if (release_ != release_none){
+    int advice = MADV_DONTNEED;
+#ifdef MADV_FREE
+    if (release_ == release_free) advice = MADV_FREE;
+#endif
+    //the stack is not running, so every page including the tls block can go
+    ::madvise(buf, stacksize_, advice);
+  }
   chunks_.available.push_back(buf);
   lock.unlock();
 }
 
+size_t
+StackAlloc::watermark(void* buf)
+{
+  static std::vector<mincore_vec_t> resident;
+  static const size_t page = ::sysconf(_SC_PAGESIZE);
+  char* base = (char*) buf;
+  size_t npages = (stacksize_ + page - 1) / page;
+  resident.resize(npages);
+  if (::mincore(buf, stacksize_, resident.data()) != 0){
+    //can't tell which pages were touched - scan them all
+    std::fill(resident.begin(), resident.end(), 1);
+  }
+  //stacks grow down toward the tls block at the base of the region,
+  //so the lowest written word past the tls block marks the deepest use
+  size_t start = (SSTMAC_TLS_END + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t);
+  for (size_t p=0; p < npages; ++p){
+    if (!(resident[p] & 1)) continue;
+    const uint64_t* word = (const uint64_t*) (base + std::max(p*page, start));
+    const uint64_t* end = (const uint64_t*) (base + std::min((p+1)*page, stacksize_));
+    for ( ; word < end; ++word){
+      if (*word) return stacksize_ - ((const char*) word - base);
+    }
+  }
+  return 0;
+}
+
+void
+StackAlloc::printStats(std::ostream& os)
+{
+  if (!watermark_ || watermarks_.nstacks == 0) return;
+
+  //the depths depend on the host compiler, so they go on their own line
+  os << sprockit::sprintf("Stack watermarks: %llu stacks of %llu bytes\n",
+                          (unsigned long long) watermarks_.nstacks,
+                          (unsigned long long) stacksize_);
+  os << sprockit::sprintf("Stack watermark depth: mean %llu bytes, max %llu bytes\n",
+                          (unsigned long long) (watermarks_.total / watermarks_.nstacks),
+                          (unsigned long long) watermarks_.max);
+}
+
 
 } // end pf namespace sw
 } // end of namespace sstmac
@@ -45,7 +45,9 @@ Questions? Contact sst-macro-help@sandia.gov
 #ifndef SSTMAC_SOFTWARE_THREADING_STACKALLOC_H_INCLUDED
 #define SSTMAC_SOFTWARE_THREADING_STACKALLOC_H_INCLUDED
 
+#include <cstdint>
 #include <cstring>
+#include <iosfwd>
 #include <vector>
 #include <sprockit/sim_parameters_fwd.h>
 
@@ -58,13 +60,27 @@ namespace sw {
  * which allocates uniform-size chunks (with the NX bit unset)
  * and sets guard pages on each side of the allocated stacks.
  *
- * This allocator does not return memory to the system until it is
- * deleted, but regions can be allocated and free-d repeatedly.
+ * By default this allocator does not return memory to the system until it
+ * is deleted, but regions can be allocated and free-d repeatedly.
+ * With stack_release set, chunks only reserve address space and the pages
+ * of a free-d stack are handed back with madvise, so stacks of finished
+ * threads stop holding resident memory. With stack_watermark set, the
+ * deepest use of each stack is measured when it is free-d.
  */
 class StackAlloc
 {
  public:
   class chunk;
+  enum release_t {
+    release_none,
+    release_dontneed,
+    release_free
+  };
+  struct watermark_stats {
+    uint64_t nstacks;
+    uint64_t total;
+    uint64_t max;
+  };
   struct chunk_set {
     std::vector<chunk*> allocations;
     std::vector<void*> available;
@@ -81,6 +97,17 @@ class StackAlloc
   static size_t stacksize_;
   /// Optionally added a protected stack between each stack we return
   static bool protect_stacks_;
+  /// How the pages of a free-d stack are returned to the system
+  static release_t release_;
+  /// Whether to measure the high-water mark of each free-d stack
+  static bool watermark_;
+  static watermark_stats watermarks_;
+
+  /**
+   * @param buf A stack that is no longer running
+   * @return The deepest extent in bytes of the stack that has been written
+   */
+  static size_t watermark(void* buf);
 
  public:
   static size_t stacksize() {
@@ -103,6 +130,12 @@ class StackAlloc
 
   static void clear();
 
+  /**
+   * Print the stack high-water marks, if they were measured
+   * @param os
+   */
+  static void printStats(std::ostream& os);
+
 };
 
 }
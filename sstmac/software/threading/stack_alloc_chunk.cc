@@ -58,7 +58,8 @@ namespace sw {
 //
 // Make a new chunk.
 //
-StackAlloc::chunk::chunk(size_t stacksize, size_t suggested_chunk_size, bool protect) :
+StackAlloc::chunk::chunk(size_t stacksize, size_t suggested_chunk_size, bool protect,
+                         bool reserve_only) :
   addr_(nullptr),
   protect_(protect),
   size_((protect_) ? 2 * suggested_chunk_size : suggested_chunk_size),
@@ -67,6 +68,9 @@ StackAlloc::chunk::chunk(size_t stacksize, size_t suggested_chunk_size, bool pro
 {
   // Now allocate our chunk.
   int mmap_flags = MAP_PRIVATE | MAP_ANON;
+#ifdef MAP_NORESERVE
+  if (reserve_only) mmap_flags |= MAP_NORESERVE;
+#endif
   addr_ = (char*)mmap(0, size_, PROT_READ | PROT_WRITE,
                       mmap_flags, -1, 0);
   if(addr_ == MAP_FAILED) {
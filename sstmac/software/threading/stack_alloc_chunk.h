@@ -73,8 +73,13 @@ class StackAlloc::chunk
   size_t next_stack_offset_ = 0;
 
  public:
-  /// Make a new chunk.
-  chunk(size_t stacksize, size_t suggested_chunk_size, bool protect);
+  /**
+   * Make a new chunk.
+   * @param reserve_only Only reserve address space, without committing
+   *                     swap for it, since stacks are released on free
+   */
+  chunk(size_t stacksize, size_t suggested_chunk_size, bool protect,
+        bool reserve_only);
 
   ~chunk();
 
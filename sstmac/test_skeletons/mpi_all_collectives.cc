@@ -51,9 +51,39 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sstmac/compute.h>
 #include <sprockit/keyword_registration.h>
 #include <mpi.h>
+#include <vector>
 
 #define sstmac_app_name mpi_all_collectives
 
+RegisterKeywords(
+{ "large_collective_size", "number of ints in an additional validated allreduce and bcast" },
+);
+
+static void
+testLargeCollectives(int me, int nproc, int nelems)
+{
+  std::vector<int> src(nelems), dst(nelems);
+  for (int i=0; i < nelems; ++i) src[i] = me + i;
+  MPI_Allreduce(src.data(), dst.data(), nelems, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+  for (int i=0; i < nelems; ++i){
+    int correct = nproc*(nproc-1)/2 + nproc*i;
+    if (dst[i] != correct){
+      spkt_abort_printf("rank %d: allreduce element %d is %d, should be %d",
+                        me, i, dst[i], correct);
+    }
+  }
+
+  int root = nproc / 2;
+  for (int i=0; i < nelems; ++i) dst[i] = me == root ? i : -1;
+  MPI_Bcast(dst.data(), nelems, MPI_INT, root, MPI_COMM_WORLD);
+  for (int i=0; i < nelems; ++i){
+    if (dst[i] != i){
+      spkt_abort_printf("rank %d: bcast element %d is %d, should be %d",
+                        me, i, dst[i], i);
+    }
+  }
+}
+
 int USER_MAIN(int argc, char** argv)
 {
   MPI_Init(&argc, &argv);
@@ -66,6 +96,11 @@ int USER_MAIN(int argc, char** argv)
   MPI_Allgather(nullptr, 1000, MPI_DOUBLE, nullptr, 1000, MPI_DOUBLE, MPI_COMM_WORLD);
   //MPI_Allreduce(nullptr, nullptr, 400, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
 
+  int large_size = sstmac::getParam<int>("large_collective_size", 0);
+  if (large_size > 0){
+    testLargeCollectives(me, nproc, large_size);
+  }
+
   MPI_Finalize();
   return 0;
 }
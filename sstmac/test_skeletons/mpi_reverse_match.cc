@@ -0,0 +1,130 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#include <sstmac/replacements/mpi/mpi.h>
+#include <sstmac/skeleton.h>
+#include <sprockit/keyword_registration.h>
+#include <mpi.h>
+#include <chrono>
+#include <vector>
+
+#define sstmac_app_name mpi_reverse_match
+
+/**
+ * Stresses MPI message matching with many outstanding receives.
+ * Rank 0 posts num_recvs receives with tags in reverse order of how
+ * rank 1 sends them, so every arrival matches the most recently posted receive.
+ * The second phase sends everything first and receives in reverse order,
+ * so every receive matches the most recently queued unexpected message.
+ * The host wall time for each phase is reported so the matching cost can be compared.
+ */
+int USER_MAIN(int argc, char** argv)
+{
+  MPI_Init(&argc, &argv);
+
+  int me, nproc;
+  MPI_Comm_rank(MPI_COMM_WORLD, &me);
+  MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+  int num_recvs = sstmac::getParam<int>("num_recvs", 10000);
+  int send_size = sstmac::getParam<int>("send_size", 8);
+
+  if (nproc < 2){
+    if (me == 0) printf("mpi_reverse_match needs at least 2 ranks\n");
+    MPI_Finalize();
+    return 0;
+  }
+
+  std::vector<MPI_Request> reqs(num_recvs);
+
+  //phase 1: posted receives searched by incoming messages
+  auto start = std::chrono::steady_clock::now();
+  if (me == 0){
+    for (int i=num_recvs-1; i >= 0; --i){
+      MPI_Irecv(NULL, send_size, MPI_BYTE, 1, i, MPI_COMM_WORLD, &reqs[i]);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+    MPI_Waitall(num_recvs, reqs.data(), MPI_STATUSES_IGNORE);
+  } else if (me == 1){
+    MPI_Barrier(MPI_COMM_WORLD);
+    for (int i=0; i < num_recvs; ++i){
+      MPI_Isend(NULL, send_size, MPI_BYTE, 0, i, MPI_COMM_WORLD, &reqs[i]);
+    }
+    MPI_Waitall(num_recvs, reqs.data(), MPI_STATUSES_IGNORE);
+  } else {
+    MPI_Barrier(MPI_COMM_WORLD);
+  }
+  auto posted = std::chrono::steady_clock::now();
+
+  //phase 2: unexpected messages searched by newly posted receives
+  if (me == 0){
+    MPI_Barrier(MPI_COMM_WORLD);
+    MPI_Barrier(MPI_COMM_WORLD);
+    for (int i=num_recvs-1; i >= 0; --i){
+      MPI_Irecv(NULL, send_size, MPI_BYTE, 1, i, MPI_COMM_WORLD, &reqs[i]);
+    }
+    MPI_Waitall(num_recvs, reqs.data(), MPI_STATUSES_IGNORE);
+  } else if (me == 1){
+    MPI_Barrier(MPI_COMM_WORLD);
+    for (int i=0; i < num_recvs; ++i){
+      MPI_Isend(NULL, send_size, MPI_BYTE, 0, i, MPI_COMM_WORLD, &reqs[i]);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+    MPI_Waitall(num_recvs, reqs.data(), MPI_STATUSES_IGNORE);
+  } else {
+    MPI_Barrier(MPI_COMM_WORLD);
+    MPI_Barrier(MPI_COMM_WORLD);
+  }
+  auto unexpected = std::chrono::steady_clock::now();
+
+  if (me == 0){
+    std::chrono::duration<double> posted_time = posted - start;
+    std::chrono::duration<double> unexpected_time = unexpected - posted;
+    printf("Matched %d reversed receives: posted %8.4fs unexpected %8.4fs host time\n",
+           num_recvs, posted_time.count(), unexpected_time.count());
+  }
+
+  MPI_Finalize();
+  return 0;
+}
@@ -54,6 +54,10 @@ Questions? Contact sst-macro-help@sandia.gov
 
 #define sstmac_app_name mpi_smp_collectives
 
+RegisterKeywords(
+{ "test_bcast", "whether to also run broadcasts from a root that does not own its node" },
+);
+
 int USER_MAIN(int argc, char** argv)
 {
   MPI_Init(&argc, &argv);
@@ -69,6 +73,11 @@ int USER_MAIN(int argc, char** argv)
   MPI_Alltoall(nullptr, 1000, MPI_INT, nullptr, 1000, MPI_INT, MPI_COMM_WORLD);
   MPI_Allgather(nullptr, 1000, MPI_INT, nullptr, 1000, MPI_INT, MPI_COMM_WORLD);
 
+  if (sstmac::getParam<bool>("test_bcast", false)){
+    MPI_Bcast(nullptr, 1000, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Bcast(nullptr, 1000, MPI_INT, nproc - 1, MPI_COMM_WORLD);
+  }
+
   MPI_Comm subComm;
   MPI_Comm_split(MPI_COMM_WORLD, me % 2, me, &subComm);
   MPI_Alltoall(nullptr, 1000, MPI_INT, nullptr, 1000, MPI_INT, subComm);
@@ -356,7 +356,7 @@ MpiApi::gatherv(int sendcount, MPI_Datatype sendtype,
                  const int *recvcounts, MPI_Datatype recvtype,
                  int root, MPI_Comm comm)
 {
-  return gatherv(NULL, sendtype, sendcount, NULL, recvcounts, NULL, recvtype, root, comm);
+  return gatherv(NULL, sendcount, sendtype, NULL, recvcounts, NULL, recvtype, root, comm);
 }
 
 int
@@ -0,0 +1,175 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#include <sumi-mpi/mpi_queue/mpi_match_queue.h>
+#include <sumi-mpi/mpi_queue/mpi_queue_recv_request.h>
+
+namespace sumi {
+
+static inline bool
+wildcardMatches(MpiMessage* msg, MPI_Comm comm, int source, int tag)
+{
+  return comm == msg->comm()
+      && (source == MPI_ANY_SOURCE || source == msg->srcRank())
+      && (tag == MPI_ANY_TAG || tag == msg->tag());
+}
+
+void
+MpiUnexpectedQueue::push(MpiMessage* msg)
+{
+  auto it = arrivals_.insert(arrivals_.end(), msg);
+  bins_[key(msg)].push_back(it);
+}
+
+void
+MpiUnexpectedQueue::remove(const MpiMatchKey& k)
+{
+  //the oldest message in a bin is always the one being matched:
+  //anything that matches a later message in the bin also matches the front
+  auto iter = bins_.find(k);
+  auto& bin = iter->second;
+  arrivals_.erase(bin.front());
+  bin.pop_front();
+  if (bin.empty()){
+    bins_.erase(iter);
+  }
+}
+
+MpiMessage*
+MpiUnexpectedQueue::match(MPI_Comm comm, int source, int tag)
+{
+  if (source != MPI_ANY_SOURCE && tag != MPI_ANY_TAG){
+    MpiMatchKey k{comm, source, tag};
+    auto iter = bins_.find(k);
+    if (iter == bins_.end()) return nullptr;
+    MpiMessage* msg = *iter->second.front();
+    remove(k);
+    return msg;
+  }
+
+  for (MpiMessage* msg : arrivals_){
+    if (wildcardMatches(msg, comm, source, tag)){
+      remove(key(msg));
+      return msg;
+    }
+  }
+  return nullptr;
+}
+
+MpiMessage*
+MpiUnexpectedQueue::find(MPI_Comm comm, int source, int tag) const
+{
+  if (source != MPI_ANY_SOURCE && tag != MPI_ANY_TAG){
+    auto iter = bins_.find(MpiMatchKey{comm, source, tag});
+    return iter == bins_.end() ? nullptr : *iter->second.front();
+  }
+
+  for (MpiMessage* msg : arrivals_){
+    if (wildcardMatches(msg, comm, source, tag)){
+      return msg;
+    }
+  }
+  return nullptr;
+}
+
+void
+MpiPostedQueue::push(MpiQueueRecvRequest* req)
+{
+  entry e{next_seqnum_++, req};
+  if (req->source_ == MPI_ANY_SOURCE || req->tag_ == MPI_ANY_TAG){
+    wildcards_.push_back(e);
+  } else {
+    bins_[MpiMatchKey{req->comm_, req->source_, req->tag_}].push_back(e);
+  }
+}
+
+MpiQueueRecvRequest*
+MpiPostedQueue::match(MpiMessage* msg)
+{
+  MpiMatchKey k{msg->comm(), msg->srcRank(), msg->tag()};
+  auto bin_iter = bins_.find(k);
+  entry* exact = nullptr;
+  if (bin_iter != bins_.end()){
+    auto& bin = bin_iter->second;
+    while (!bin.empty() && bin.front().req->isCancelled()){
+      bin.pop_front();
+    }
+    if (bin.empty()){
+      bins_.erase(bin_iter);
+      bin_iter = bins_.end();
+    } else {
+      exact = &bin.front();
+    }
+  }
+
+  //wildcards are in posting order - once we pass the exact candidate
+  //nothing further down the list can have been posted before it
+  for (auto it = wildcards_.begin(); it != wildcards_.end();){
+    if (exact && it->seqnum > exact->seqnum) break;
+    MpiQueueRecvRequest* req = it->req;
+    if (req->isCancelled()){
+      it = wildcards_.erase(it);
+    } else if (req->matches(msg)){
+      wildcards_.erase(it);
+      return req;
+    } else {
+      ++it;
+    }
+  }
+
+  if (exact){
+    MpiQueueRecvRequest* req = exact->req;
+    //run the full check so truncation errors are still reported
+    req->matches(msg);
+    auto& bin = bin_iter->second;
+    bin.pop_front();
+    if (bin.empty()){
+      bins_.erase(bin_iter);
+    }
+    return req;
+  }
+  return nullptr;
+}
+
+}
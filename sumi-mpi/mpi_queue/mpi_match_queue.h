@@ -0,0 +1,161 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#ifndef SSTMAC_SOFTWARE_LIBRARIES_MPI_MPI_QUEUE_MPIMATCHQUEUE_H_INCLUDED
+#define SSTMAC_SOFTWARE_LIBRARIES_MPI_MPI_QUEUE_MPIMATCHQUEUE_H_INCLUDED
+
+#include <sumi-mpi/mpi_message.h>
+#include <sumi-mpi/mpi_types.h>
+#include <sumi-mpi/mpi_queue/mpi_queue_recv_request_fwd.h>
+
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <unordered_map>
+
+namespace sumi {
+
+/**
+ * The exact (comm, source, tag) triple that point-to-point messages
+ * and non-wildcard receives are binned by.
+ */
+struct MpiMatchKey {
+  MPI_Comm comm;
+  int source;
+  int tag;
+
+  bool operator==(const MpiMatchKey& other) const {
+    return comm == other.comm && source == other.source && tag == other.tag;
+  }
+};
+
+struct MpiMatchKeyHash {
+  std::size_t operator()(const MpiMatchKey& k) const {
+    uint64_t h = uint32_t(k.comm);
+    h = h * 0x9e3779b97f4a7c15ULL + uint32_t(k.source);
+    h = h * 0x9e3779b97f4a7c15ULL + uint32_t(k.tag);
+    return std::size_t(h ^ (h >> 29));
+  }
+};
+
+/**
+ * Unexpected messages waiting for a receive to be posted.
+ * Messages are kept in arrival order and additionally binned by
+ * (comm, source, tag) so that fully specified receives find the
+ * oldest matching message without scanning everything that is queued.
+ * Wildcard receives and probes fall back to a scan in arrival order,
+ * which preserves the MPI non-overtaking rule.
+ */
+class MpiUnexpectedQueue {
+ public:
+  void push(MpiMessage* msg);
+
+  /**
+   * @brief match Remove and return the oldest message that matches
+   * @return The message or nullptr if nothing matches
+   */
+  MpiMessage* match(MPI_Comm comm, int source, int tag);
+
+  /**
+   * @brief find Return the oldest message that matches without removing it
+   * @return The message or nullptr if nothing matches
+   */
+  MpiMessage* find(MPI_Comm comm, int source, int tag) const;
+
+  std::size_t size() const {
+    return arrivals_.size();
+  }
+
+ private:
+  typedef std::list<MpiMessage*>::iterator arrival_iterator;
+
+  static MpiMatchKey key(MpiMessage* msg){
+    return MpiMatchKey{msg->comm(), msg->srcRank(), msg->tag()};
+  }
+
+  void remove(const MpiMatchKey& key);
+
+  std::list<MpiMessage*> arrivals_;
+
+  /// Within a bin, messages are ordered by arrival so the oldest is at the front
+  std::unordered_map<MpiMatchKey, std::deque<arrival_iterator>, MpiMatchKeyHash> bins_;
+};
+
+/**
+ * Posted receives waiting for a message to arrive.
+ * Fully specified receives are binned by (comm, source, tag).
+ * Receives using MPI_ANY_SOURCE or MPI_ANY_TAG go on a separate wildcard list.
+ * Every receive is stamped with a posting sequence number so that an
+ * incoming message matches whichever candidate was posted first,
+ * regardless of which list it lives in.
+ */
+class MpiPostedQueue {
+ public:
+  MpiPostedQueue() : next_seqnum_(0) {}
+
+  void push(MpiQueueRecvRequest* req);
+
+  /**
+   * @brief match Remove and return the earliest posted receive matching msg.
+   *        Cancelled receives encountered along the way are dropped.
+   * @return The receive or nullptr if nothing matches
+   */
+  MpiQueueRecvRequest* match(MpiMessage* msg);
+
+ private:
+  struct entry {
+    uint64_t seqnum;
+    MpiQueueRecvRequest* req;
+  };
+
+  uint64_t next_seqnum_;
+
+  std::unordered_map<MpiMatchKey, std::deque<entry>, MpiMatchKeyHash> bins_;
+
+  std::list<entry> wildcards_;
+};
+
+}
+
+#endif
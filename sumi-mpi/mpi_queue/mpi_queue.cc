@@ -202,18 +202,16 @@ MpiQueue::send(MpiRequest *key, int count, MPI_Datatype type,
 MpiMessage*
 MpiQueue::findMatchingRecv(MpiQueueRecvRequest* req)
 {
-  for (auto it = need_recv_match_.begin(); it != need_recv_match_.end(); ++it) {
-    MpiMessage* mess = *it;
-    if (req->matches(mess)) {
-      mpi_queue_debug("matched recv tag=%s,src=%s on comm=%s to send %s",
-        api_->tagStr(req->tag_).c_str(), 
-        api_->srcStr(req->source_).c_str(),
-        api_->commStr(req->comm_).c_str(),
-        mess->toString().c_str());
-
-      need_recv_match_.erase(it);
-      return mess;
-    }
+  MpiMessage* mess = need_recv_match_.match(req->comm_, req->source_, req->tag_);
+  if (mess) {
+    //run the full check so truncation errors are still reported
+    req->matches(mess);
+    mpi_queue_debug("matched recv tag=%s,src=%s on comm=%s to send %s",
+      api_->tagStr(req->tag_).c_str(), 
+      api_->srcStr(req->source_).c_str(),
+      api_->commStr(req->comm_).c_str(),
+      mess->toString().c_str());
+    return mess;
   }
   mpi_queue_debug("could not match recv tag=%s, src=%s to any of %d sends on comm=%s",
     api_->tagStr(req->tag_).c_str(), 
@@ -221,7 +219,7 @@ MpiQueue::findMatchingRecv(MpiQueueRecvRequest* req)
     need_recv_match_.size(),
     api_->commStr(req->comm_).c_str());
 
-  need_send_match_.push_back(req);
+  need_send_match_.push(req);
   return nullptr;
 }
 
@@ -272,13 +270,11 @@ MpiQueue::probe(MpiRequest* key, MpiComm* comm,
 
   mpi_queue_probe_request* req = new mpi_queue_probe_request(key, comm->id(), source, tag);
   // Figure out whether we already have a matching message.
-  for (auto it = need_recv_match_.begin(); it != need_recv_match_.end(); ++it) {
-    MpiMessage* mess = *it;
-    if (req->matches(mess)){
-      // We're good to go.
-      req->complete(mess);
-      return;
-    }
+  MpiMessage* mess = need_recv_match_.find(comm->id(), source, tag);
+  if (mess){
+    // We're good to go.
+    req->complete(mess);
+    return;
   }
   // If we get here, we still need to wait for the message.
   probelist_.push_back(req);
@@ -297,14 +293,11 @@ MpiQueue::iprobe(MpiComm* comm,
     api_->srcStr(source).c_str(), api_->tagStr(tag).c_str(),
     api_->commStr(comm).c_str());
 
-  mpi_queue_probe_request req(NULL, comm->id(), source, tag);
-  for (auto it = need_recv_match_.begin(); it != need_recv_match_.end(); ++it) {
-    MpiMessage* mess = *it;
-    if (req.matches(mess)) {
-      // This is it
-      if (stat != MPI_STATUS_IGNORE) mess->buildStatus(stat);
-      return true;
-    }
+  MpiMessage* mess = need_recv_match_.find(comm->id(), source, tag);
+  if (mess) {
+    // This is it
+    if (stat != MPI_STATUS_IGNORE) mess->buildStatus(stat);
+    return true;
   }
   return false;
 }
@@ -312,19 +305,11 @@ MpiQueue::iprobe(MpiComm* comm,
 MpiQueueRecvRequest*
 MpiQueue::findMatchingRecv(MpiMessage* message)
 {
-  auto end = need_send_match_.end();
-  for (auto it = need_send_match_.begin(); it != end;) {
-    auto* req = *it;
-    auto tmp = it++;
-    if (req->isCancelled()) {
-      need_send_match_.erase(tmp);
-    } else if (req->matches(message)) {
-      need_send_match_.erase(tmp);
-      return req;
-    }
+  MpiQueueRecvRequest* req = need_send_match_.match(message);
+  if (!req){
+    need_recv_match_.push(message);
   }
-  need_recv_match_.push_back(message);
-  return nullptr;
+  return req;
 }
 
 void
@@ -58,6 +58,7 @@ namespace sumi {
  */
 class MpiQueueRecvRequest  {
   friend class MpiQueue;
+  friend class MpiPostedQueue;
   friend class RendezvousGet;
   friend class Eager1;
   friend class Eager0;
@@ -208,6 +208,12 @@ BruckActor::finalize()
 void
 RingAllgatherActor::initBuffers()
 {
+  //every block is sent in place from the result buffer - start it with my own block
+  if (send_buffer_ != result_buffer_){
+    int block_size = nelems_ * type_size_;
+    my_api_->memcopy(Message::offset_ptr(result_buffer_, dom_me_*block_size),
+                     send_buffer_, block_size);
+  }
   recv_buffer_ = result_buffer_;
 }
 
@@ -48,6 +48,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sprockit/output.h>
 #include <sprockit/stl_string.h>
 #include <cstring>
+#include <algorithm>
 
 #define divide_by_2_round_up(x) ((x/2) + (x%2))
 
@@ -246,4 +247,91 @@ WilkeAllreduceActor::bufferAction(void *dst_buffer, void *msg_buffer, Action* ac
   }
 }
 
+void
+RingAllreduceActor::finalizeBuffers()
+{
+  long buffer_size = nelems_ * type_size_;
+  my_api_->freeWorkspace(recv_buffer_, buffer_size);
+}
+
+void
+RingAllreduceActor::initBuffers()
+{
+  int size = nelems_ * type_size_;
+  //all reductions accumulate in the dst buffer
+  if (send_buffer_ != result_buffer_)
+    my_api_->memcopy(result_buffer_, send_buffer_, size);
+  //chunks being reduced land here first
+  recv_buffer_ = my_api_->allocateWorkspace(size, send_buffer_);
+  send_buffer_ = result_buffer_;
+}
+
+void
+RingAllreduceActor::chunk(int idx, int& offset, int& nelems) const
+{
+  int base = nelems_ / dom_nproc_;
+  int extra = nelems_ % dom_nproc_;
+  nelems = base + (idx < extra ? 1 : 0);
+  offset = idx*base + std::min(idx, extra);
+}
+
+void
+RingAllreduceActor::initDag()
+{
+  slicer_->fxn = fxn_;
+
+  int send_partner = (dom_me_ + 1) % dom_nproc_;
+  int recv_partner = (dom_me_ + dom_nproc_ - 1) % dom_nproc_;
+  int num_steps = dom_nproc_ - 1;
+
+  debug_printf(sumi_collective,
+    "Rank %s configured ring allreduce for tag=%d for nproc=%d over %d rounds",
+    rankStr().c_str(), tag_, dom_nproc_, 2*num_steps);
+
+  RecvAction::buf_type_t fan_in_recv_type = slicer_->contiguous() ?
+        RecvAction::in_place : RecvAction::packed_temp_buf;
+  SendAction::buf_type_t fan_in_send_type = slicer_->contiguous() ?
+        SendAction::in_place : SendAction::prev_recv;
+
+  Action *prev_send = nullptr, *prev_recv = nullptr;
+  /**
+   * Reduce-scatter: on step i, send chunk me-i and reduce chunk me-i-1.
+   * After nproc-1 steps, chunk me+1 is fully reduced here.
+   * Allgather: on step i, forward chunk me+1-i and receive chunk me-i.
+   */
+  for (int rnd=0; rnd < 2*num_steps; ++rnd){
+    bool reducing = rnd < num_steps;
+    int step = reducing ? rnd : rnd - num_steps;
+    int send_chunk = reducing ? dom_me_ - step : dom_me_ + 1 - step;
+    int recv_chunk = send_chunk - 1;
+    send_chunk = (send_chunk + 2*dom_nproc_) % dom_nproc_;
+    recv_chunk = (recv_chunk + 2*dom_nproc_) % dom_nproc_;
+
+    Action* send_ac = new SendAction(rnd, send_partner,
+              (reducing || step == 0) ? SendAction::in_place : fan_in_send_type);
+    chunk(send_chunk, send_ac->offset, send_ac->nelems);
+    Action* recv_ac = new RecvAction(rnd, recv_partner,
+              reducing ? RecvAction::reduce : fan_in_recv_type);
+    chunk(recv_chunk, recv_ac->offset, recv_ac->nelems);
+
+    addDependency(prev_send, send_ac);
+    addDependency(prev_send, recv_ac);
+    addDependency(prev_recv, send_ac);
+    addDependency(prev_recv, recv_ac);
+
+    prev_send = send_ac;
+    prev_recv = recv_ac;
+  }
+}
+
+void
+RingAllreduceActor::bufferAction(void *dst_buffer, void *msg_buffer, Action* ac)
+{
+  if (ac->round < dom_nproc_ - 1){
+    (fxn_)(dst_buffer, msg_buffer, ac->nelems);
+  } else {
+    my_api_->memcopy(dst_buffer, msg_buffer, ac->nelems * type_size_);
+  }
+}
+
 }
@@ -115,6 +115,81 @@ class WilkeHalvingAllreduce :
 
 };
 
+/**
+ * Bandwidth-optimal allreduce for large messages. The buffer is cut into
+ * one chunk per rank and the chunks are reduce-scattered around a ring,
+ * then allgathered around the same ring. Every round moves nelems/nproc
+ * elements, so rounds pipeline instead of each sending the full buffer.
+ */
+class RingAllreduceActor :
+  public DagCollectiveActor
+{
+ public:
+  RingAllreduceActor(CollectiveEngine* engine, void* dst, void* src,
+                     int nelems, int type_size, int tag, reduce_fxn fxn,
+                     int cq_id, Communicator* comm) :
+    DagCollectiveActor(Collective::allreduce, engine, dst, src, type_size, tag, cq_id, comm, fxn),
+    fxn_(fxn), nelems_(nelems)
+  {
+  }
+
+  std::string toString() const override {
+    return "ring all reduce actor";
+  }
+
+  void bufferAction(void *dst_buffer, void *msg_buffer, Action* ac) override;
+
+  /**
+   * @brief Whether the ring algorithm can run on this communicator
+   * @param nproc The number of ranks in the communicator
+   * @param nelems The number of elements being reduced
+   * @return False if there are fewer elements than ranks or
+   *         more ring rounds than actions can encode (over 500K ranks)
+   */
+  static bool valid(int nproc, int nelems){
+    return nelems >= nproc && uint64_t(2*(nproc-1)) < Action::max_round;
+  }
+
+ private:
+  void chunk(int idx, int& offset, int& nelems) const;
+  void finalizeBuffers() override;
+  void initBuffers() override;
+  void initDag() override;
+
+ private:
+  reduce_fxn fxn_;
+
+  int nelems_;
+
+};
+
+class RingAllreduce :
+  public DagCollective
+{
+ public:
+  RingAllreduce(CollectiveEngine* engine, void* dst, void* src,
+                int nelems, int type_size, int tag, reduce_fxn fxn,
+                int cq_id, Communicator* comm)
+    : DagCollective(allreduce, engine, dst, src, type_size, tag, cq_id, comm),
+      fxn_(fxn), nelems_(nelems)
+  {
+  }
+
+  std::string toString() const override {
+    return "sumi ring allreduce";
+  }
+
+  DagCollectiveActor* newActor() const override {
+    return new RingAllreduceActor(engine_, dst_buffer_, src_buffer_,
+                                  nelems_, type_size_, tag_, fxn_, cq_id_, comm_);
+  }
+
+ private:
+  reduce_fxn fxn_;
+  int nelems_;
+
+};
+
 }
 
 #endif // ALLREDUCE_H
@@ -170,4 +170,59 @@ BinaryTreeBcastActor::initBuffers()
 }
 
 
+void
+PipelinedBcastActor::bufferAction(void *dst_buffer, void *msg_buffer, Action *ac)
+{
+  ::memcpy(dst_buffer, msg_buffer, ac->nelems*type_size_);
+}
+
+void
+PipelinedBcastActor::finalizeBuffers()
+{
+}
+
+void
+PipelinedBcastActor::initBuffers()
+{
+  recv_buffer_ = send_buffer_;
+  result_buffer_ = send_buffer_;
+}
+
+void
+PipelinedBcastActor::initDag()
+{
+  int offset_me = (dom_me_ - root_ + dom_nproc_) % dom_nproc_;
+  int parent = (dom_me_ + dom_nproc_ - 1) % dom_nproc_;
+  int child = (dom_me_ + 1) % dom_nproc_;
+  bool has_child = offset_me != dom_nproc_ - 1;
+  int num_segments = std::max(1, (nelems_ + segment_nelems_ - 1) / segment_nelems_);
+
+  debug_printf(sprockit::dbg::sumi_collective_init,
+    "Rank %s is at position %d in pipelined bcast of %d segments",
+    rankStr().c_str(), offset_me, num_segments);
+
+  RecvAction::buf_type_t recv_ty = slicer_->contiguous() ?
+        RecvAction::in_place : RecvAction::unpack_temp_buf;
+
+  for (int seg=0; seg < num_segments; ++seg){
+    int offset = seg * segment_nelems_;
+    int nelems = std::min(segment_nelems_, nelems_ - offset);
+    Action* recv = nullptr;
+    if (offset_me != 0){
+      recv = new RecvAction(seg, parent, recv_ty);
+      recv->nelems = nelems;
+      recv->offset = offset;
+      addAction(recv);
+    }
+    if (has_child){
+      //forward each segment as soon as it lands
+      Action* send = new SendAction(seg, child, SendAction::in_place);
+      send->nelems = nelems;
+      send->offset = offset;
+      if (recv) addDependency(recv, send);
+      else addAction(send);
+    }
+  }
+}
+
 }
@@ -49,6 +49,7 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sumi/collective_actor.h>
 #include <sumi/collective_message.h>
 #include <sumi/comm_functions.h>
+#include <algorithm>
 
 namespace sumi {
 
@@ -106,6 +107,73 @@ class BinaryTreeBcastCollective :
 
 };
 
+/**
+ * Broadcast for large messages. Ranks form a chain starting at the root
+ * and the buffer is cut into fixed-size segments. Each rank forwards a
+ * segment to the next rank as soon as it arrives, so the chain streams
+ * segments instead of moving the whole buffer one hop at a time.
+ */
+class PipelinedBcastActor :
+  public DagCollectiveActor
+{
+ public:
+  PipelinedBcastActor(CollectiveEngine* engine, int root, void *buf, int nelems,
+                      int type_size, int segment_nelems, int tag, int cq_id, Communicator* comm)
+    : DagCollectiveActor(Collective::bcast, engine, buf, buf, type_size, tag, cq_id, comm),
+      root_(root), nelems_(nelems), segment_nelems_(segment_nelems)
+  {}
+
+  std::string toString() const override {
+    return "pipelined bcast actor";
+  }
+
+ private:
+  void finalizeBuffers() override;
+  void initBuffers() override;
+  void initDag() override;
+  void bufferAction(void *dst_buffer, void *msg_buffer, Action *ac) override;
+
+  int root_;
+  int nelems_;
+  int segment_nelems_;
+};
+
+class PipelinedBcastCollective :
+  public DagCollective
+{
+ public:
+  /**
+   * @param segment_size The size in bytes of each pipelined segment
+   */
+  PipelinedBcastCollective(CollectiveEngine* engine, int root, void* buf,
+                           int nelems, int type_size, uint64_t segment_size,
+                           int tag, int cq_id, Communicator* comm)
+    : DagCollective(Collective::bcast, engine, buf, buf, type_size, tag, cq_id, comm),
+      root_(root), nelems_(nelems)
+  {
+    segment_nelems_ = std::max(uint64_t(1), segment_size / std::max(type_size, 1));
+    //bound the size of the DAG, so very long pipelines use bigger segments
+    const uint64_t max_segments = 500;
+    uint64_t min_segment_nelems = (nelems + max_segments - 1) / max_segments;
+    segment_nelems_ = std::max(uint64_t(segment_nelems_), min_segment_nelems);
+  }
+
+  std::string toString() const override {
+    return "pipelined bcast";
+  }
+
+  DagCollectiveActor* newActor() const override {
+    return new PipelinedBcastActor(engine_, root_, dst_buffer_, nelems_,
+                                   type_size_, segment_nelems_, tag_, cq_id_, comm_);
+  }
+
+ private:
+  int root_;
+  int nelems_;
+  int segment_nelems_;
+
+};
+
 }
 
 #endif // BCAST_H
@@ -163,10 +163,10 @@ DagCollectiveActor::startAction(Action* ac)
 {
   ac->start = my_api_->now();
   debug_printf(sumi_collective,
-   "Rank %s starting action %s to partner %s on round %d offset %d tag %d -> id = %u: %d pending send headers, %d pending recv headers",
+   "Rank %s starting action %s to partner %s on round %d offset %d tag %d -> id = %llu: %d pending send headers, %d pending recv headers",
     rankStr().c_str(), Action::tostr(ac->type),
     rankStr(ac->partner).c_str(),
-    ac->round, ac->offset, tag_, ac->id,
+    ac->round, ac->offset, tag_, (unsigned long long) ac->id,
     pending_send_headers_.size(),
     pending_recv_headers_.size());
   switch (ac->type){
@@ -222,7 +222,7 @@ DagCollectiveActor::startShuffle(Action * /*ac*/)
 void
 DagCollectiveActor::clearDependencies(Action* ac)
 {
-  std::multimap<uint32_t, Action*>::iterator it = pending_comms_.find(ac->id);
+  std::multimap<uint64_t, Action*>::iterator it = pending_comms_.find(ac->id);
   std::list<Action*> pending_actions;
   while (it != pending_comms_.end()){
     Action* pending = it->second;
@@ -232,11 +232,11 @@ DagCollectiveActor::clearDependencies(Action* ac)
     pending->join_counter--;
     debug_printf(sumi_collective,
       "Rank %s satisfying dependency to join counter %d for action %s to partner %s on round %d"
-      " with action %u tag=%d",
+      " with action %llu tag=%d",
       rankStr().c_str(), pending->join_counter,
       Action::tostr(pending->type),
       rankStr(pending->partner).c_str(),
-      pending->round,ac->id,tag_);
+      pending->round, (unsigned long long) ac->id, tag_);
 
     if (ac->type == Action::resolve){
       pending->phys_partner = ac->phys_partner;
@@ -263,10 +263,10 @@ void
 DagCollectiveActor::commActionDone(Action* ac)
 {
   debug_printf(sumi_collective,
-    "Rank %s finishing comm action %s to partner %s on round %d -> id %u tag=%d",
+    "Rank %s finishing comm action %s to partner %s on round %d -> id %llu tag=%d",
     rankStr().c_str(), Action::tostr(ac->type),
     rankStr(ac->partner).c_str(),
-    ac->round, ac->id,
+    ac->round, (unsigned long long) ac->id,
     tag_);
 
   clearAction(ac);
@@ -333,7 +333,7 @@ DagCollectiveActor::addAction(Action* ac)
   addDependency(0, ac);
 }
 void
-DagCollectiveActor::addDependencyToMap(uint32_t id, Action* ac)
+DagCollectiveActor::addDependencyToMap(uint64_t id, Action* ac)
 {
   //in case this accidentally got added to initial set
   //make sure it gets removed
@@ -353,7 +353,7 @@ DagCollectiveActor::addCommDependency(Action* precursor, Action *ac)
 
   if (physical_rank == Communicator::unresolved_rank){
     //uh oh - need to wait on this
-    uint32_t resolve_id = Action::messageId(Action::resolve, 0, ac->partner);
+    uint64_t resolve_id = Action::messageId(Action::resolve, 0, ac->partner);
      comm_->registerRankCallback(this);
     addDependencyToMap(resolve_id, ac);
     if (precursor) addDependencyToMap(precursor->id, ac);
@@ -499,7 +499,7 @@ DagCollectiveActor::deadlockCheck() const
   }
 
   for (auto& pair  : pending_comms_){
-    uint32_t id = pair.first;
+    uint64_t id = pair.first;
     Action::type_t ty;
     int r, p;
     Action::details(id, ty, r, p);
@@ -519,7 +519,7 @@ DagCollectiveActor::deadlockCheck() const
 }
 
 void
-DagCollectiveActor::reputPending(uint32_t id, pending_msg_map& pending)
+DagCollectiveActor::reputPending(uint64_t id, pending_msg_map& pending)
 {
   std::list<CollectiveWorkMessage*> tmp;
 
@@ -539,7 +539,7 @@ DagCollectiveActor::reputPending(uint32_t id, pending_msg_map& pending)
 }
 
 void
-DagCollectiveActor::erasePending(uint32_t id, pending_msg_map& pending)
+DagCollectiveActor::erasePending(uint64_t id, pending_msg_map& pending)
 {
   pending_msg_map::iterator it = pending.find(id);
   while (it != pending.end()){
@@ -551,7 +551,7 @@ DagCollectiveActor::erasePending(uint32_t id, pending_msg_map& pending)
 Action*
 DagCollectiveActor::commActionDone(Action::type_t ty, int round, int partner)
 {
-  uint32_t id = Action::messageId(ty, round, partner);
+  uint64_t id = Action::messageId(ty, round, partner);
 
   active_map::iterator it = active_comms_.find(id);
   if (it == active_comms_.end()){
@@ -646,7 +646,7 @@ DagCollectiveActor::dataRecved(
     this, msg->round(), tag_,
     (void*) recv_buffer_, msg);
 
-  uint32_t id = Action::messageId(Action::recv, msg->round(), msg->domSender());
+  uint64_t id = Action::messageId(Action::recv, msg->round(), msg->domSender());
   Action* ac = active_comms_[id];
   if (ac == nullptr){
     spkt_throw_printf(sprockit::ValueError,
@@ -758,7 +758,7 @@ DagCollectiveActor::incomingHeader(CollectiveWorkMessage* msg)
 {
   switch(msg->protocol()){
     case CollectiveWorkMessage::eager: {
-      uint32_t mid = Action::messageId(Action::recv, msg->round(), msg->domSender());
+      uint64_t mid = Action::messageId(Action::recv, msg->round(), msg->domSender());
       active_map::iterator it = active_comms_.find(mid);
       if (it == active_comms_.end()){
         debug_printf(sumi_collective,
@@ -778,7 +778,7 @@ DagCollectiveActor::incomingHeader(CollectiveWorkMessage* msg)
       break;
     }
     case CollectiveWorkMessage::get: {
-      uint32_t mid = Action::messageId(Action::recv, msg->round(), msg->domSender());
+      uint64_t mid = Action::messageId(Action::recv, msg->round(), msg->domSender());
       auto it = active_comms_.find(mid);
       if (it == active_comms_.end()){
         debug_printf(sumi_collective,
@@ -792,7 +792,7 @@ DagCollectiveActor::incomingHeader(CollectiveWorkMessage* msg)
       break;
     }
     case CollectiveWorkMessage::put: {
-      uint32_t mid = Action::messageId(Action::send, msg->round(), msg->domSender());
+      uint64_t mid = Action::messageId(Action::send, msg->round(), msg->domSender());
       auto it = active_comms_.find(mid);
       if (it == active_comms_.end()){
         pending_send_headers_.insert(std::make_pair(mid, msg));
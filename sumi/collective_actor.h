@@ -81,7 +81,7 @@ struct Action
   int round;
   int offset;
   int nelems;
-  uint32_t id;
+  uint64_t id;
   sstmac::Timestamp start;
 
   static const char*
@@ -101,17 +101,18 @@ struct Action
 
   std::string toString() const;
 
-  static const uint32_t max_round = 500;
+  /** 64-bit ids leave room for ring algorithms with a round per rank */
+  static const uint64_t max_round = 1 << 20;
 
-  static uint32_t messageId(type_t ty, int r, int p){
+  static uint64_t messageId(type_t ty, int r, int p){
     //factor of two is for send or receive
     const int num_enums = 6;
     return p*max_round*num_enums + r*num_enums + ty;
   }
 
-  static void details(uint32_t round, type_t& ty, int& r, int& p){
+  static void details(uint64_t round, type_t& ty, int& r, int& p){
     const int num_enums = 6;
-    uint32_t remainder = round;
+    uint64_t remainder = round;
     p = remainder / max_round / num_enums;
     remainder -= p*max_round*num_enums;
 
@@ -370,12 +371,12 @@ class DagCollectiveActor :
 
  private:
   template <class T, class U> using alloc = sprockit::threadSafeAllocator<std::pair<const T,U>>;
-  typedef std::map<uint32_t, Action*, std::less<uint32_t>,
-                   alloc<uint32_t,Action*>> active_map;
-  typedef std::multimap<uint32_t, Action*, std::less<uint32_t>,
-                   alloc<uint32_t,Action*>> pending_map;
-  typedef std::multimap<uint32_t, CollectiveWorkMessage*, std::less<uint32_t>,
-                   alloc<uint32_t,CollectiveWorkMessage*>> pending_msg_map;
+  typedef std::map<uint64_t, Action*, std::less<uint64_t>,
+                   alloc<uint64_t,Action*>> active_map;
+  typedef std::multimap<uint64_t, Action*, std::less<uint64_t>,
+                   alloc<uint64_t,Action*>> pending_map;
+  typedef std::multimap<uint64_t, CollectiveWorkMessage*, std::less<uint64_t>,
+                   alloc<uint64_t,CollectiveWorkMessage*>> pending_msg_map;
 
  protected:
   DagCollectiveActor(Collective::type_t ty, CollectiveEngine* engine, void* dst, void * src,
@@ -411,7 +412,7 @@ class DagCollectiveActor :
 
 
   void addCommDependency(Action* precursor, Action* ac);
-  void addDependencyToMap(uint32_t id, Action* ac);
+  void addDependencyToMap(uint64_t id, Action* ac);
   void rankResolved(int globalRank, int comm_rank) override;
 
   void checkCollectiveDone();
@@ -459,9 +460,9 @@ class DagCollectiveActor :
 
   virtual void startShuffle(Action* ac);
 
-  void erasePending(uint32_t id, pending_msg_map& m);
+  void erasePending(uint64_t id, pending_msg_map& m);
 
-  void reputPending(uint32_t id, pending_msg_map& m);
+  void reputPending(uint64_t id, pending_msg_map& m);
 
   /**
    * @brief Satisfy dependencies for any pending comms,
@@ -120,7 +120,8 @@ class CollectiveDoneMessage :
  * Main message type used by collectives
  */
 class CollectiveWorkMessage final :
-  public ProtocolMessage
+  public ProtocolMessage,
+  public sprockit::thread_safe_new<CollectiveWorkMessage>
 {
   ImplementSerializable(CollectiveWorkMessage)
  public:
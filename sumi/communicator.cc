@@ -46,6 +46,9 @@ Questions? Contact sst-macro-help@sandia.gov
 #include <sumi/transport.h>
 #include <sprockit/errors.h>
 
+#include <algorithm>
+#include <limits>
+
 namespace sumi {
 
 void
@@ -56,6 +59,14 @@ Communicator::rankResolved(int global_rank, int comm_rank)
   }
 }
 
+int
+Communicator::ownerRankOf(int comm_rank) const
+{
+  auto iter = std::upper_bound(owner_ranges_.begin(), owner_ranges_.end(),
+                               std::make_pair(comm_rank, std::numeric_limits<int>::max()));
+  return (--iter)->second;
+}
+
 void
 Communicator::createSmpCommunicator(const std::set<int>& neighbors, CollectiveEngine *engine,
                                     int cq_id)
@@ -90,27 +101,42 @@ Communicator::createSmpCommunicator(const std::set<int>& neighbors, CollectiveEn
                         int(neighbors.size()), int(neighbors_subset.size()));
     }
 
-    std::vector<int> smp_ranks(this->nproc());
+    //exchange the local smp rank and the node leader of every rank
+    int my_info[2] = {my_smp_rank, smp_comm_->commToGlobalRank(0)};
+    std::vector<int> smp_info(2*this->nproc());
     int tag = -2;
-    engine->allgather(smp_ranks.data(), &my_smp_rank, 1, sizeof(int), tag, cq_id, this);
+    engine->allgather(smp_info.data(), my_info, 2, sizeof(int), tag, cq_id, this);
     engine->blockUntilNext(cq_id);
 
+    //every rank needs the counts to agree on whether the comm is balanced
     std::map<int,int> rank_counts;
+    for (int rank=0; rank < this->nproc(); ++rank){
+      rank_counts[smp_info[2*rank]]++;
+    }
+
     int my_owner_rank = -1;
     if (my_smp_rank == 0){
       std::vector<int> owner_to_global;
+      std::map<int,int> global_to_owner;
       idx = 0;
       for (int rank=0; rank < this->nproc(); ++rank){
-        int local_smp_rank = smp_ranks[rank];
-        rank_counts[local_smp_rank]++;
+        int local_smp_rank = smp_info[2*rank];
         if (local_smp_rank == 0){
           owner_to_global.push_back(commToGlobalRank(rank));
+          global_to_owner[commToGlobalRank(rank)] = idx;
           if (rank == this->myCommRank()){
             my_owner_rank = idx;
           }
           ++idx;
         }
       }
+      //record owners as runs of consecutive ranks, usually one run per node
+      for (int rank=0; rank < this->nproc(); ++rank){
+        int owner = global_to_owner[smp_info[2*rank+1]];
+        if (owner_ranges_.empty() || owner_ranges_.back().second != owner){
+          owner_ranges_.emplace_back(rank, owner);
+        }
+      }
       int nranks = idx;
       owner_comm_ = new IndexCommunicator(my_owner_rank, nranks, std::move(owner_to_global));
       if (owner_comm_->nproc() == 0){
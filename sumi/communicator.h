@@ -102,6 +102,13 @@ class Communicator {
     return owner_comm_;
   }
 
+  /**
+   * Only valid on ranks that have an owner communicator
+   * @param comm_rank A rank in this communicator
+   * @return The rank in the owner communicator of the node owning comm_rank
+   */
+  int ownerRankOf(int comm_rank) const;
+
   void registerRankCallback(RankCallback* cback){
     rank_callbacks_.insert(cback);
   }
@@ -131,6 +138,8 @@ class Communicator {
 
   Communicator* smp_comm_;
   Communicator* owner_comm_;
+  /** (first comm rank, owner comm rank) for each run of ranks with the same owner */
+  std::vector<std::pair<int,int>> owner_ranges_;
   bool smp_balanced_;
 
 };
@@ -43,6 +43,7 @@ Questions? Contact sst-macro-help@sandia.gov
 */
 
 #include <cstring>
+#include <limits>
 #include <sumi/transport.h>
 #include <sumi/allreduce.h>
 #include <sumi/reduce_scatter.h>
@@ -79,6 +80,14 @@ RegisterKeywords(
 { "poll_delay", "the time it takes to poll for an incoming message" },
 { "rdma_pin_latency", "the latency for each RDMA pin information" },
 { "rdma_page_delay", "the per-page delay for RDMA pinning" },
+{ "allreduce", "the allreduce algorithm: wilke (recursive halving) or ring (pipelined reduce-scatter/allgather)" },
+{ "bcast", "the bcast algorithm: binary_tree or pipeline (segmented chain)" },
+{ "bcast_segment_size", "the segment size in bytes for the pipelined bcast" },
+{ "smp_min_nproc", "the minimum communicator size for using hierarchical SMP collectives" },
+{ "smp_allreduce_max_size", "the largest allreduce in bytes that uses the hierarchical SMP algorithm" },
+{ "smp_bcast_max_size", "the largest bcast in bytes that uses the hierarchical SMP algorithm" },
+{ "smp_allgather_max_size", "the largest per-rank allgather contribution in bytes that uses the hierarchical SMP algorithm" },
+{ "smp_alltoall_max_size", "the largest per-destination alltoall block in bytes that uses the hierarchical SMP algorithm" },
 );
 
 #include <sstmac/common/sstmac_config.h>
@@ -542,6 +551,16 @@ SimTransport::freeWorkspace(void *buf, uint64_t /*size*/)
   }
 }
 
+static uint64_t
+findSizeLimit(SST::Params& params, const std::string& name)
+{
+  if (params.contains(name)){
+    return params.find<SST::UnitAlgebra>(name).getRoundedValue();
+  } else {
+    return std::numeric_limits<uint64_t>::max();
+  }
+}
+
 CollectiveEngine::CollectiveEngine(SST::Params& params, Transport *tport) :
   tport_(tport),
   global_domain_(nullptr),
@@ -554,6 +573,22 @@ CollectiveEngine::CollectiveEngine(SST::Params& params, Transport *tport) :
   use_put_protocol_ = params.find<bool>("use_put_protocol", false);
   alltoall_type_ = params.find<std::string>("alltoall", "bruck");
   allgather_type_ = params.find<std::string>("allgather", "bruck");
+  allreduce_type_ = params.find<std::string>("allreduce", "wilke");
+  if (allreduce_type_ != "wilke" && allreduce_type_ != "ring"){
+    spkt_abort_printf("invalid allreduce type requested: %s", allreduce_type_.c_str());
+  }
+  bcast_type_ = params.find<std::string>("bcast", "binary_tree");
+  if (bcast_type_ != "binary_tree" && bcast_type_ != "pipeline"){
+    spkt_abort_printf("invalid bcast type requested: %s", bcast_type_.c_str());
+  }
+  bcast_segment_size_ = params.find<SST::UnitAlgebra>("bcast_segment_size", "64KB").getRoundedValue();
+
+  //hierarchical collectives only apply if the comm was built with smp_optimize
+  smp_min_nproc_ = params.find<int>("smp_min_nproc", 0);
+  smp_allreduce_max_size_ = findSizeLimit(params, "smp_allreduce_max_size");
+  smp_bcast_max_size_ = findSizeLimit(params, "smp_bcast_max_size");
+  smp_allgather_max_size_ = findSizeLimit(params, "smp_allgather_max_size");
+  smp_alltoall_max_size_ = findSizeLimit(params, "smp_alltoall_max_size");
 
   int default_qos = params.find<int>("default_qos", 0);
   rdma_get_qos_ = params.find<int>("collective_rdma_get_qos", default_qos);
@@ -579,6 +614,14 @@ CollectiveEngine::notifyCollectiveDone(int rank, Collective::type_t ty, int tag)
   finishCollective(coll, rank, ty, tag);
 }
 
+bool
+CollectiveEngine::useSmp(Communicator* comm, uint64_t bytes, uint64_t max_bytes, bool need_balanced) const
+{
+  if (!comm->smpComm()) return false;
+  if (need_balanced && !comm->smpBalanced()) return false;
+  return comm->nproc() >= smp_min_nproc_ && bytes <= max_bytes;
+}
+
 void
 CollectiveEngine::initSmp(const std::set<int>& /*neighbors*/)
 {
@@ -625,41 +668,55 @@ CollectiveEngine::allreduce(void* dst, void *src, int nelems, int type_size, int
 
   if (!comm) comm = global_domain_;
 
-  Collective* coll = nullptr;
-  if (comm->smpComm()){
+  if (useSmp(comm, uint64_t(nelems)*type_size, smp_allreduce_max_size_, false)){
+    //reduce onto the node owner, allreduce among owners, then bcast within the node
     //tags are restricted to 28 bits - the front 4 bits are mine for various internal operations
     int intra_reduce_tag = 1<<28 | tag;
-    auto* intra_reduce = new WilkeHalvingAllreduce(this, dst, src, nelems,
-                                   type_size, intra_reduce_tag, fxn, cq_id, comm->smpComm());
-
-    int root = comm->smpComm()->commToGlobalRank(0);
-    Collective* prev;
-    if (comm->myCommRank() == root){
+    auto* intra_reduce = new WilkeHalvingReduce(this, 0, dst, src, nelems, type_size,
+                                                intra_reduce_tag, fxn, cq_id, comm->smpComm());
+    Collective* prev = intra_reduce;
+    if (comm->smpComm()->myCommRank() == 0){
       if (!comm->ownerComm()){
         spkt_abort_printf("Bad owner comm configuration - rank 0 in SMP comm should 'own' node");
       }
-      //I am the owner!
       int inter_reduce_tag = 2<<28 | tag;
-      auto* inter_reduce = new WilkeHalvingAllreduce(this, dst, dst, nelems,
-                                     type_size, inter_reduce_tag, fxn, cq_id, comm->ownerComm());
-
-
-      intra_reduce->setSubsequent(inter_reduce);
+      auto* inter_reduce = newAllreduce(dst, dst, nelems, type_size, inter_reduce_tag,
+                                        fxn, cq_id, comm->ownerComm());
+      prev->setSubsequent(inter_reduce);
       prev = inter_reduce;
-    } else {
-      prev = intra_reduce;
     }
-    auto* intra_bcast = new BinaryTreeBcastCollective(this, root, dst, nelems, type_size, tag,
-                                                      cq_id, comm->smpComm());
+    auto* intra_bcast = newBcast(0, dst, nelems, type_size, tag, cq_id, comm->smpComm());
     prev->setSubsequent(intra_bcast);
     //this should report back as done on the original communicator!
-    coll = new DoNothingCollective(this, tag, cq_id, comm);
-    intra_bcast->setSubsequent(coll);
+    intra_bcast->setSubsequent(new DoNothingCollective(this, tag, cq_id, comm));
+    return startCollective(intra_reduce);
   } else {
-    coll = new WilkeHalvingAllreduce(this, dst, src, nelems, type_size, tag, fxn, cq_id, comm);
+    return startCollective(newAllreduce(dst, src, nelems, type_size, tag, fxn, cq_id, comm));
   }
+}
 
-  return startCollective(coll);
+Collective*
+CollectiveEngine::newAllreduce(void* dst, void* src, int nelems, int type_size, int tag,
+                               reduce_fxn fxn, int cq_id, Communicator* comm)
+{
+  //the ring needs a chunk per rank, otherwise fall back to recursive halving
+  if (allreduce_type_ == "ring" && RingAllreduceActor::valid(comm->nproc(), nelems)){
+    return new RingAllreduce(this, dst, src, nelems, type_size, tag, fxn, cq_id, comm);
+  } else {
+    return new WilkeHalvingAllreduce(this, dst, src, nelems, type_size, tag, fxn, cq_id, comm);
+  }
+}
+
+Collective*
+CollectiveEngine::newBcast(int root, void* buf, int nelems, int type_size, int tag,
+                           int cq_id, Communicator* comm)
+{
+  if (bcast_type_ == "pipeline"){
+    return new PipelinedBcastCollective(this, root, buf, nelems, type_size,
+                                        bcast_segment_size_, tag, cq_id, comm);
+  } else {
+    return new BinaryTreeBcastCollective(this, root, buf, nelems, type_size, tag, cq_id, comm);
+  }
 }
 
 sumi::CollectiveDoneMessage*
@@ -707,8 +764,42 @@ CollectiveEngine::bcast(int root, void *buf, int nelems, int type_size, int tag,
   if (msg) return msg;
 
   if (!comm) comm = global_domain_;
-  DagCollective* coll = new BinaryTreeBcastCollective(this, root, buf, nelems, type_size, tag, cq_id, comm);
-  return startCollective(coll);
+  if (useSmp(comm, uint64_t(nelems)*type_size, smp_bcast_max_size_, false)){
+    Communicator* smp = comm->smpComm();
+    int root_global = comm->commToGlobalRank(root);
+    bool root_is_local = !smp->globalRankSetIntersection({root_global}).empty();
+    bool is_owner = smp->myCommRank() == 0;
+    int inter_tag = 2<<28 | tag;
+    Collective* first = nullptr;
+    Collective* prev = nullptr;
+    auto append = [&](Collective* coll){
+      if (prev) prev->setSubsequent(coll);
+      else first = coll;
+      prev = coll;
+    };
+    if (root_is_local && smp->globalToCommRank(root_global) != 0){
+      //the root first hands the data to the rest of its node, including the owner
+      int intra_tag = 1<<28 | tag;
+      append(newBcast(smp->globalToCommRank(root_global), buf, nelems,
+                      type_size, intra_tag, cq_id, smp));
+      if (is_owner){
+        append(newBcast(comm->ownerRankOf(root), buf, nelems,
+                        type_size, inter_tag, cq_id, comm->ownerComm()));
+      }
+    } else {
+      //owners receive the data first, then forward it within their node
+      if (is_owner){
+        append(newBcast(comm->ownerRankOf(root), buf, nelems,
+                        type_size, inter_tag, cq_id, comm->ownerComm()));
+      }
+      int intra_tag = 3<<28 | tag;
+      append(newBcast(0, buf, nelems, type_size, intra_tag, cq_id, smp));
+    }
+    append(new DoNothingCollective(this, tag, cq_id, comm));
+    return startCollective(first);
+  } else {
+    return startCollective(newBcast(root, buf, nelems, type_size, tag, cq_id, comm));
+  }
 }
 
 CollectiveDoneMessage*
@@ -777,7 +868,7 @@ CollectiveEngine::alltoall(void *dst, void *src, int nelems, int type_size, int
     spkt_abort_printf("invalid alltoall type requested: %s", allgather_type_.c_str());
   }
 
-  if (comm->smpComm() && comm->smpBalanced()){
+  if (useSmp(comm, uint64_t(nelems)*type_size, smp_alltoall_max_size_, true)){
     int smpSize = comm->smpComm()->nproc();
     void* intraDst = dst ? new char[nelems*type_size*smpSize] : nullptr;
     int intra_tag = 1<<28 | tag;
@@ -795,8 +886,8 @@ CollectiveEngine::alltoall(void *dst, void *src, int nelems, int type_size, int
       prev = intra;
     }
     int bcast_tag = 3<<28 | tag;
-    auto* bcast = new BinaryTreeBcastCollective(this, 0, dst, comm->nproc()*nelems,
-                                                type_size, bcast_tag, cq_id, comm->smpComm());
+    auto* bcast = newBcast(0, dst, comm->nproc()*nelems, type_size, bcast_tag,
+                           cq_id, comm->smpComm());
     prev->setSubsequent(bcast);
     auto* final = new DoNothingCollective(this, tag, cq_id, comm);
     bcast->setSubsequent(final);
@@ -838,7 +929,7 @@ CollectiveEngine::allgather(void *dst, void *src, int nelems, int type_size, int
     spkt_abort_printf("invalid allgather type requested: %s", allgather_type_.c_str());
   }
 
-  if (comm->smpComm() && comm->smpBalanced()){
+  if (useSmp(comm, uint64_t(nelems)*type_size, smp_allgather_max_size_, true)){
     int smpSize = comm->smpComm()->nproc();
     void* intraDst = dst ? new char[nelems*type_size*smpSize] : nullptr;
 
@@ -861,8 +952,8 @@ CollectiveEngine::allgather(void *dst, void *src, int nelems, int type_size, int
       prev = intra;
     }
     int bcast_tag = 3<<28 | tag;
-    auto* bcast = new BinaryTreeBcastCollective(this, 0, dst, comm->nproc()*nelems,
-                                                type_size, bcast_tag, cq_id, comm->smpComm());
+    auto* bcast = newBcast(0, dst, comm->nproc()*nelems, type_size, bcast_tag,
+                           cq_id, comm->smpComm());
     prev->setSubsequent(bcast);
     auto* final = new DoNothingCollective(this, tag, cq_id, comm);
     bcast->setSubsequent(final);
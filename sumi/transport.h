@@ -532,6 +532,27 @@ class CollectiveEngine
 
   CollectiveDoneMessage* deliverPending(Collective* coll, int tag, Collective::type_t ty);
 
+  /**
+   * @param comm
+   * @param bytes The number of bytes each rank contributes
+   * @param max_bytes The largest contribution for which the hierarchical algorithm is used
+   * @param need_balanced Whether the algorithm requires the same number of ranks on each node
+   * @return Whether to run the two-level (intra-node, inter-node leader) algorithm
+   */
+  bool useSmp(Communicator* comm, uint64_t bytes, uint64_t max_bytes, bool need_balanced) const;
+
+  /**
+   * @return A flat allreduce over comm using the configured algorithm
+   */
+  Collective* newAllreduce(void* dst, void* src, int nelems, int type_size, int tag,
+                           reduce_fxn fxn, int cq_id, Communicator* comm);
+
+  /**
+   * @return A flat bcast over comm using the configured algorithm
+   */
+  Collective* newBcast(int root, void* buf, int nelems, int type_size, int tag,
+                       int cq_id, Communicator* comm);
+
  private:
   Transport* tport_;
 
@@ -558,6 +579,15 @@ class CollectiveEngine
 
   std::string alltoall_type_;
   std::string allgather_type_;
+  std::string allreduce_type_;
+  std::string bcast_type_;
+  uint64_t bcast_segment_size_;
+
+  int smp_min_nproc_;
+  uint64_t smp_allreduce_max_size_;
+  uint64_t smp_bcast_max_size_;
+  uint64_t smp_allgather_max_size_;
+  uint64_t smp_alltoall_max_size_;
 
   int rdma_header_qos_;
   int rdma_get_qos_;
@@ -0,0 +1,175 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#include <sstmac/skeletons/compact_replay/compact_trace.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace sumi;
+
+static const int nranks = 8;
+
+/**
+ * Post a halo exchange with both ring neighbors and wait on it
+ */
+static void
+haloExchange(CompactTraceWriter& w, int rank, int32_t type, int left_tag, int right_tag)
+{
+  int right = (rank + 1) % nranks;
+  int left = (rank + nranks - 1) % nranks;
+  w.call(CompactOp::Irecv, {1000, type, left, left_tag, compact_comm_world, 0});
+  w.call(CompactOp::Irecv, {1000, type, right, right_tag, compact_comm_world, 1});
+  w.call(CompactOp::Isend, {1000, type, right, left_tag, compact_comm_world, 2});
+  w.call(CompactOp::Isend, {1000, type, left, right_tag, compact_comm_world, 3});
+  int32_t reqs[] = {0, 1, 2, 3};
+  w.call(CompactOp::Waitall, {w.array(reqs, 4), 4});
+}
+
+/**
+ * The workload of testcompact.ctr: three halo exchanges with a different tag
+ * each, then collectives on a split communicator. Rank 3 computes for 5s
+ * before the final barrier.
+ */
+static void
+writeHalo(CompactTraceWriter& w)
+{
+  int32_t dbl = w.typeId(8);
+  int32_t integer = w.typeId(4);
+  int32_t triple = w.typeId(24);
+  for (int r=0; r < nranks; ++r){
+    w.beginRank(r);
+    w.call(CompactOp::Init);
+    for (int iter=0; iter < 3; ++iter){
+      w.gap(20000 + 1000*r);
+      haloExchange(w, r, dbl, iter, iter);
+      w.gap(5000);
+      w.call(CompactOp::Allreduce, {16, dbl, compact_comm_world});
+    }
+    int32_t split = 2;
+    w.call(CompactOp::CommSplit, {compact_comm_world, r % 2, r, split});
+    w.gap(10000);
+    w.call(CompactOp::Bcast, {4096, integer, 0, split});
+    w.call(CompactOp::Sendrecv, {100, triple, (r+2) % nranks, 7,
+                                 100, triple, (r+nranks-2) % nranks, 7, compact_comm_world});
+    int32_t counts[nranks];
+    int32_t my_counts[nranks];
+    for (int i=0; i < nranks; ++i){
+      counts[i] = 10*(i+1);
+      my_counts[i] = 10*(r+1);
+    }
+    w.call(CompactOp::Alltoallv, {w.array(counts, nranks), w.array(my_counts, nranks),
+                                  nranks, dbl, dbl, compact_comm_world});
+    int nroot = r == 0 ? nranks : 0;
+    w.call(CompactOp::Gatherv, {10*(r+1), dbl, w.array(counts, nroot), nroot,
+                                dbl, 0, compact_comm_world});
+    w.call(CompactOp::Reduce, {128, dbl, 1, split});
+    w.call(CompactOp::CommFree, {split});
+    if (r == 3) w.gap(5000000000ULL);
+    w.call(CompactOp::Barrier, {compact_comm_world});
+    w.call(CompactOp::Finalize);
+    w.endRank();
+  }
+}
+
+/**
+ * Forty identical iterations of a halo exchange and three allreduces,
+ * so that loop compression replays exactly the same compute gaps
+ */
+static void
+writeLoops(CompactTraceWriter& w)
+{
+  int32_t dbl = w.typeId(8);
+  for (int r=0; r < nranks; ++r){
+    w.beginRank(r);
+    w.call(CompactOp::Init);
+    for (int iter=0; iter < 40; ++iter){
+      w.gap(20000 + 1000*r);
+      haloExchange(w, r, dbl, 5, 6);
+      //loops replay the mean gap at each position, so every allreduce gets the same gap
+      for (int k=0; k < 3; ++k){
+        w.gap(2000);
+        w.call(CompactOp::Allreduce, {16, dbl, compact_comm_world});
+      }
+    }
+    w.call(CompactOp::Barrier, {compact_comm_world});
+    w.call(CompactOp::Finalize);
+    CompactRankStats stats = w.endRank();
+    printf("rank %d: %llu calls in %llu records, %llu loops\n", r,
+           (unsigned long long) stats.ncalls, (unsigned long long) stats.nrecords,
+           (unsigned long long) stats.nloops);
+  }
+}
+
+static void
+usage(const char* exe)
+{
+  fprintf(stderr, "usage: %s halo <compact trace>\n"
+                  "       %s loops <compact trace> <max loop body>\n"
+                  "Write the compact traces replayed by the tests\n", exe, exe);
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 3){
+    usage(argv[0]);
+    return 1;
+  }
+
+  CompactTraceOptions opts;
+  if (::strcmp(argv[1], "halo") == 0 && argc == 3){
+    CompactTraceWriter w(argv[2], nranks, opts);
+    writeHalo(w);
+    w.finish();
+  } else if (::strcmp(argv[1], "loops") == 0 && argc == 4){
+    opts.max_loop_body = ::atoi(argv[3]);
+    CompactTraceWriter w(argv[2], nranks, opts);
+    writeLoops(w);
+    w.finish();
+  } else {
+    usage(argv[0]);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,120 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#include <sstmac/software/process/memoize.h>
+#include <cstdio>
+#include <sstream>
+
+using sstmac::MemoizationModel;
+
+static MemoizationModel*
+makeModel(const char* name, int nparams)
+{
+  return sprockit::create<MemoizationModel>("macro", name, nparams);
+}
+
+void test_linear()
+{
+  MemoizationModel* model = makeModel("linear", 2);
+  int nsamples = 0;
+  for (int a=1; a <= 3; ++a){
+    for (int b=1; b <= 3; ++b){
+      double params[] = {double(a), double(b)};
+      model->addSample(1. + 2.*a + 3.*b, params);
+      ++nsamples;
+      printf("linear: %d samples ready=%d\n", nsamples, model->ready());
+    }
+  }
+  double params[] = {5., 7.};
+  printf("linear: t(5,7) = %.6f\n", model->predict(params));
+
+  //a model loaded from its written samples predicts the same
+  std::stringstream sstr;
+  model->write(sstr);
+  MemoizationModel* loaded = makeModel("linear", 2);
+  loaded->read(sstr, nsamples);
+  printf("linear: reloaded t(5,7) = %.6f\n", loaded->predict(params));
+  delete model;
+  delete loaded;
+}
+
+void test_polynomial()
+{
+  MemoizationModel* model = makeModel("polynomial", 1);
+  for (int a=0; a < 6; ++a){
+    double params[] = {double(a)};
+    model->addSample(2. + a + 0.5*a*a, params);
+  }
+  printf("polynomial: ready=%d\n", model->ready());
+  double params[] = {10.};
+  printf("polynomial: t(10) = %.6f\n", model->predict(params));
+  delete model;
+}
+
+void test_lookup()
+{
+  MemoizationModel* model = makeModel("lookup", 1);
+  double small[] = {1.};
+  double large[] = {10.};
+  model->addSample(1., small);
+  model->addSample(3., small);
+  model->addSample(5., large);
+  double near_small[] = {2.};
+  double near_large[] = {8.};
+  printf("lookup: t(2) = %.6f\n", model->predict(near_small));
+  printf("lookup: t(8) = %.6f\n", model->predict(near_large));
+
+  //predictions refit when new samples arrive
+  model->addSample(9., large);
+  printf("lookup: t(8) = %.6f\n", model->predict(near_large));
+  delete model;
+}
+
+int main(int argc, char** argv)
+{
+  test_linear();
+  test_polynomial();
+  test_lookup();
+  return 0;
+}
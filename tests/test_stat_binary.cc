@@ -0,0 +1,129 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#include <sstmac/common/stats/stat_binary.h>
+#include <sprockit/sim_parameters.h>
+#include <iostream>
+
+using sstmac::StatisticBase;
+using sstmac::StatisticFieldsOutput;
+using sstmac::StatisticGroup;
+
+/**
+ * A statistic with a count column, and optionally a mean column
+ */
+class TestStat : public StatisticBase
+{
+ public:
+  TestStat(const std::string& sub_id, SST::Params& params, bool with_mean, int count) :
+    StatisticBase(nullptr, "test", sub_id, params),
+    with_mean_(with_mean), count_(count)
+  {
+  }
+
+  void registerOutputFields(StatisticFieldsOutput* output) override {
+    count_field_ = output->registerField<int64_t>("count");
+    if (with_mean_) mean_field_ = output->registerField<double>("mean");
+  }
+
+  void outputStatisticFields(StatisticFieldsOutput* output, bool /*endOfSimFlag*/) override {
+    output->outputField(count_field_, int64_t(count_));
+    if (with_mean_) output->outputField(mean_field_, count_ / 4.0);
+  }
+
+ private:
+  bool with_mean_;
+  int count_;
+  StatisticFieldsOutput::fieldHandle_t count_field_;
+  StatisticFieldsOutput::fieldHandle_t mean_field_;
+};
+
+static void
+dumpGroup(StatisticFieldsOutput* output, StatisticGroup& grp)
+{
+  output->startOutputGroup(&grp);
+  for (StatisticBase* stat : grp.stats){
+    output->output(stat, true);
+  }
+  output->stopOutputGroup();
+}
+
+int main()
+{
+  SST::Params params;
+  //small blocks and few of them, so the simulation thread must wait on the writer
+  params.insert("block_rows", "2");
+  params.insert("max_blocks", "2");
+  auto* output = new sstmac::StatOutputBinary(params);
+
+  //two groups with different columns written through the same file
+  StatisticGroup counts("test_stat_binary");
+  StatisticGroup means("test_stat_binary_means");
+  std::vector<TestStat*> stats;
+  for (int i=0; i < 5; ++i){
+    stats.push_back(new TestStat(std::to_string(i), params, false, i));
+    stats.back()->setGroup(&counts);
+    counts.stats.push_back(stats.back());
+    output->registerStatistic(stats.back());
+  }
+  for (int i=0; i < 3; ++i){
+    stats.push_back(new TestStat(std::to_string(i), params, true, 10*i));
+    stats.back()->setGroup(&means);
+    means.stats.push_back(stats.back());
+    output->registerStatistic(stats.back());
+  }
+
+  dumpGroup(output, counts);
+  dumpGroup(output, means);
+  //dumping again with the same columns needs no new header
+  dumpGroup(output, means);
+  delete output;
+
+  sstmac::StatBinaryReader reader("test_stat_binary.bin");
+  reader.toCsv(std::cout);
+  std::cout << std::endl;
+
+  for (TestStat* stat : stats) delete stat;
+  return 0;
+}
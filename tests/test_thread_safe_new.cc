@@ -0,0 +1,91 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#include <sprockit/thread_safe_new.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+class PooledObject : public sprockit::thread_safe_new<PooledObject>
+{
+  double data_[4];
+};
+
+static void
+printPoolStats()
+{
+  //other pools in the library may have been used, so only show ours
+  std::stringstream sstr;
+  sprockit::ThreadAllocatorSet::printStats(sstr);
+  std::string line;
+  while (std::getline(sstr, line)){
+    if (line.find("PooledObject") != std::string::npos){
+      std::cout << line << std::endl;
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  std::vector<PooledObject*> objects;
+  for (int i=0; i < 1000; ++i){
+    objects.push_back(new PooledObject);
+  }
+  for (int i=0; i < 600; ++i){
+    delete objects.back();
+    objects.pop_back();
+  }
+  //reuses freed slots without growing the pool or the high-water mark
+  for (int i=0; i < 100; ++i){
+    objects.push_back(new PooledObject);
+  }
+  printPoolStats();
+
+  for (PooledObject* obj : objects){
+    delete obj;
+  }
+  printPoolStats();
+  return 0;
+}
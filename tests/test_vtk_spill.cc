@@ -0,0 +1,112 @@
+/**
+Copyright 2009-2023 National Technology and Engineering Solutions of Sandia,
+LLC (NTESS).  Under the terms of Contract DE-NA-0003525, the U.S. Government
+retains certain rights in this software.
+
+Sandia National Laboratories is a multimission laboratory managed and operated
+by National Technology and Engineering Solutions of Sandia, LLC., a wholly
+owned subsidiary of Honeywell International, Inc., for the U.S. Department of
+Energy's National Nuclear Security Administration under contract DE-NA0003525.
+
+Copyright (c) 2009-2023, NTESS
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, 
+are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of the copyright holder nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Questions? Contact sst-macro-help@sandia.gov
+*/
+
+#include <sstmac/hardware/vtk/vtk_spill.h>
+#include <cstdio>
+#include <unistd.h>
+
+using sstmac::hw::VTKEventSpill;
+using sstmac::hw::VTKEventMerger;
+
+typedef std::vector<VTKEventSpill::run> RunList;
+
+/**
+ * Spill one window of a switch, with ports in increasing order
+ */
+static void
+spillWindow(VTKEventSpill& spill, RunList& runs, uint64_t time, int id,
+            const std::vector<int>& ports)
+{
+  std::vector<VTKEventSpill::record> events;
+  for (int port : ports){
+    events.push_back({time, id, port, time / 100.0 + port / 10.0});
+  }
+  spill.append(events, runs);
+}
+
+int main()
+{
+  std::shared_ptr<VTKEventSpill> spill = VTKEventSpill::open("test_vtk_spill");
+  std::shared_ptr<VTKEventSpill> other = VTKEventSpill::open("test_vtk_spill_other");
+  printf("same output shares a spill: %d\n", int(VTKEventSpill::open("test_vtk_spill") == spill));
+  printf("outputs have separate spills: %d\n", int(other != spill));
+
+  std::vector<RunList> streams(3);
+  spillWindow(*spill, streams[0], 0, 1, {0, 2});
+  spillWindow(*spill, streams[1], 0, 0, {3});
+  spillWindow(*spill, streams[0], 100, 1, {1});
+  spillWindow(*spill, streams[1], 100, 0, {0, 1});
+  spillWindow(*spill, streams[1], 200, 0, {2});
+  spillWindow(*spill, streams[0], 300, 1, {0});
+  //streams[2] is a switch that saw no traffic
+
+  RunList other_runs;
+  spillWindow(*other, other_runs, 50, 5, {4});
+
+  spill->flush();
+  printf("%llu events in steps:", (unsigned long long) spill->numEvents());
+  for (double t : spill->steps()){
+    printf(" %.0f", t);
+  }
+  printf("\nports:");
+  for (uint32_t p : spill->usedPorts()){
+    printf(" %u:%u", p >> 16, p & 0xFFFF);
+  }
+  printf("\nother output: %llu events\n", (unsigned long long) other->numEvents());
+
+  std::string fname = spill->fname();
+  {
+    VTKEventMerger merger(spill, std::move(streams));
+    while (!merger.empty()){
+      const VTKEventSpill::record& rec = merger.top();
+      printf("t=%llu switch=%d port=%d color=%.2f\n",
+             (unsigned long long) rec.time, rec.id, rec.port, rec.color);
+      merger.pop();
+    }
+  }
+
+  spill.reset();
+  printf("spill file removed with the last reference: %d\n", int(::access(fname.c_str(), F_OK) != 0));
+  return 0;
+}